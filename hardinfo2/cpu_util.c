@@ -22,8 +22,6 @@
 #include "cpu_util.h"
 #include "cpubits.h"
 
-#define CPU_TOPO_NULL -9877
-
 const gchar *byte_order_str() {
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
     return _("Little Endian");
@@ -167,6 +165,29 @@ void cpufreq_free(cpufreq_data *cpufd)
     g_free(cpufd);
 }
 
+/* the cpu%d directory has a node%d link for the NUMA node it belongs to */
+static gint get_cpu_node(gint cpuid)
+{
+    gchar *path;
+    const gchar *fn;
+    GDir *dir;
+    gint node = CPU_TOPO_NULL;
+
+    path = g_strdup_printf("/sys/devices/system/cpu/cpu%d", cpuid);
+    dir = g_dir_open(path, 0, NULL);
+    if (dir) {
+        while ((fn = g_dir_read_name(dir)) != NULL) {
+            if (g_str_has_prefix(fn, "node") && isdigit(fn[4])) {
+                node = atoi(fn + 4);
+                break;
+            }
+        }
+        g_dir_close(dir);
+    }
+    g_free(path);
+    return node;
+}
+
 cpu_topology_data *cputopo_new(gint id)
 {
     cpu_topology_data *cputd;
@@ -178,6 +199,7 @@ cpu_topology_data *cputopo_new(gint id)
         cputd->core_id = get_cpu_int("topology/core_id", id, CPU_TOPO_NULL);
         cputd->book_id = get_cpu_int("topology/book_id", id, CPU_TOPO_NULL);
         cputd->drawer_id = get_cpu_int("topology/drawer_id", id, CPU_TOPO_NULL);
+        cputd->node_id = get_cpu_node(id);
     }
     return cputd;
 
@@ -188,6 +210,93 @@ void cputopo_free(cpu_topology_data *cputd)
     g_free(cputd);
 }
 
+GSList *cpucache_list_new(gint id)
+{
+    cpu_cache_data *cache;
+    gchar *endpoint, *entry, *index;
+    gchar *uref = NULL, *type;
+    GSList *caches = NULL;
+    gint i;
+
+    endpoint = g_strdup_printf("/sys/devices/system/cpu/cpu%d/cache", id);
+
+    for (i = 0; ; i++) {
+      index = g_strdup_printf("index%d/", i);
+
+      entry = g_strconcat(index, "type", NULL);
+      type = h_sysfs_read_string(endpoint, entry);
+      g_free(entry);
+
+      if (!type) {
+        g_free(index);
+        break;
+      }
+
+      cache = g_new0(cpu_cache_data, 1);
+      cache->type = type;
+
+      entry = g_strconcat(index, "level", NULL);
+      cache->level = h_sysfs_read_int(endpoint, entry);
+      g_free(entry);
+
+      entry = g_strconcat(index, "number_of_sets", NULL);
+      cache->number_of_sets = h_sysfs_read_int(endpoint, entry);
+      g_free(entry);
+
+      entry = g_strconcat(index, "physical_line_partition", NULL);
+      cache->physical_line_partition = h_sysfs_read_int(endpoint, entry);
+      g_free(entry);
+
+      entry = g_strconcat(index, "size", NULL);
+      cache->size = h_sysfs_read_int(endpoint, entry);
+      g_free(entry);
+
+      entry = g_strconcat(index, "ways_of_associativity", NULL);
+      cache->ways_of_associativity = h_sysfs_read_int(endpoint, entry);
+      g_free(entry);
+
+      /* unique cache references: id is nice, but share_cpu_list can be
+       * used if it is not available. */
+      entry = g_strconcat(index, "id", NULL);
+      uref = h_sysfs_read_string(endpoint, entry);
+      g_free(entry);
+      if (uref != NULL && *uref != 0 )
+        cache->uid = atoi(uref);
+      else
+        cache->uid = -1;
+      g_free(uref);
+      entry = g_strconcat(index, "shared_cpu_list", NULL);
+      cache->shared_cpu_list = h_sysfs_read_string(endpoint, entry);
+      g_free(entry);
+
+      /* reacharound */
+      entry = g_strconcat(index, "../../topology/physical_package_id", NULL);
+      cache->phy_sock = h_sysfs_read_int(endpoint, entry);
+      g_free(entry);
+
+      g_free(index);
+
+      caches = g_slist_append(caches, cache);
+    }
+
+    g_free(endpoint);
+    return caches;
+}
+
+void cpucache_free(cpu_cache_data *cache)
+{
+    if (cache) {
+        g_free(cache->type);
+        g_free(cache->shared_cpu_list);
+    }
+    g_free(cache);
+}
+
+void cpucache_list_free(GSList *caches)
+{
+    g_slist_free_full(caches, (GDestroyNotify)cpucache_free);
+}
+
 gchar *cpufreq_section_str(cpufreq_data *cpufd)
 {
     if (cpufd == NULL)
@@ -123,6 +123,8 @@ int main(int argc, char **argv)
           fprintf(stderr, "\n");
           g_print("%s\n", result);
           g_free(result);
+          if (params.bench_regressed)
+            exit_code = 2;
         }
     } else if (params.gui_running) {
 	/* initialize gui and start gtk+ main loop */
@@ -397,6 +397,16 @@ void parameters_init(int *argc, char ***argv, ProgramParameters * param)
     static gchar *run_benchmark = NULL;
     static gchar *result_format = NULL;
     static gchar *bench_user_note = NULL;
+    static gchar *bench_pin = NULL;
+    static gint bench_repeat = 1;
+    static gint bench_warmup = 0;
+    static gint bench_sweep = FALSE;
+    static gint bench_batch = FALSE;
+    static gint bench_threads = 0;
+    static gchar *bench_baseline = NULL;
+    static gchar *bench_save_baseline = NULL;
+    static gdouble bench_threshold = 5.0;
+    static gchar *bench_dir = NULL;
     static gint max_bench_results = 50;
 
     static GOptionEntry options[] = {
@@ -423,7 +433,7 @@ void parameters_init(int *argc, char ***argv, ProgramParameters * param)
 	 .short_name = 'b',
 	 .arg = G_OPTION_ARG_STRING,
 	 .arg_data = &run_benchmark,
-	 .description = N_("run single benchmark eg. -b 'FPU FFT' (Default all Benchmarks runs)")},
+	 .description = N_("run benchmarks eg. -b 'FPU FFT', a comma separated list or a pattern like 'CPU*' (Default all Benchmarks runs)")},
 	{
 	 .long_name = "user-note",
 	 .short_name = 'u',
@@ -435,7 +445,57 @@ void parameters_init(int *argc, char ***argv, ProgramParameters * param)
 	 .short_name = 'g',
 	 .arg = G_OPTION_ARG_STRING,
 	 .arg_data = &result_format,
-	 .description = N_("benchmark result format ([short], conf, shell)")},
+	 .description = N_("benchmark result format ([short], conf, shell, json, csv)")},
+	{
+	 .long_name = "bench-pin",
+	 .arg = G_OPTION_ARG_STRING,
+	 .arg_data = &bench_pin,
+	 .description = N_("benchmark thread placement ([none], cores, smt, numa or a cpu list eg. 0-3,8)")},
+	{
+	 .long_name = "bench-repeat",
+	 .arg = G_OPTION_ARG_INT,
+	 .arg_data = &bench_repeat,
+	 .description = N_("timed repetitions of each benchmark, result is the median (default is 1)")},
+	{
+	 .long_name = "bench-warmup",
+	 .arg = G_OPTION_ARG_INT,
+	 .arg_data = &bench_warmup,
+	 .description = N_("seconds of untimed warmup before each benchmark (default is 0)")},
+	{
+	 .long_name = "bench-sweep",
+	 .arg = G_OPTION_ARG_NONE,
+	 .arg_data = &bench_sweep,
+	 .description = N_("also run benchmarks at 1, 2, 4 ... threads and report the scaling")},
+	{
+	 .long_name = "bench-batch",
+	 .arg = G_OPTION_ARG_NONE,
+	 .arg_data = &bench_batch,
+	 .description = N_("with -b, run a comma separated list of benchmarks and print each result as it finishes")},
+	{
+	 .long_name = "bench-threads",
+	 .arg = G_OPTION_ARG_INT,
+	 .arg_data = &bench_threads,
+	 .description = N_("threads for benchmarks that use all logical CPUs (default is all)")},
+	{
+	 .long_name = "bench-save-baseline",
+	 .arg = G_OPTION_ARG_FILENAME,
+	 .arg_data = &bench_save_baseline,
+	 .description = N_("with -b, save the results to a baseline file")},
+	{
+	 .long_name = "bench-baseline",
+	 .arg = G_OPTION_ARG_FILENAME,
+	 .arg_data = &bench_baseline,
+	 .description = N_("with -b, compare the results with a baseline file and exit with 2 on a regression")},
+	{
+	 .long_name = "bench-threshold",
+	 .arg = G_OPTION_ARG_DOUBLE,
+	 .arg_data = &bench_threshold,
+	 .description = N_("smallest change in percent that --bench-baseline reports (default is 5)")},
+	{
+	 .long_name = "bench-dir",
+	 .arg = G_OPTION_ARG_FILENAME,
+	 .arg_data = &bench_dir,
+	 .description = N_("directory the storage benchmark writes its temporary file in (default is the temp directory)")},
 	{
 	 .long_name = "max-results",
 	 .short_name = 'n',
@@ -484,6 +544,16 @@ void parameters_init(int *argc, char ***argv, ProgramParameters * param)
     param->show_version = show_version;
     param->run_benchmark = run_benchmark;
     param->result_format = result_format;
+    param->bench_pin = bench_pin;
+    param->bench_repeat = MAX(bench_repeat, 1);
+    param->bench_warmup = MAX(bench_warmup, 0);
+    param->bench_sweep = bench_sweep;
+    param->bench_batch = bench_batch;
+    param->bench_threads = MAX(bench_threads, 0);
+    param->bench_baseline = bench_baseline;
+    param->bench_save_baseline = bench_save_baseline;
+    param->bench_threshold = MAX(bench_threshold, 0);
+    param->bench_dir = bench_dir;
     param->max_bench_results = max_bench_results;
     param->skip_benchmarks = skip_benchmarks;
     param->force_all_details = force_all_details;
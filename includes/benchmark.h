@@ -26,6 +26,39 @@ enum BenchmarkEntries {
     BENCHMARK_MEMORY_DUAL,
     BENCHMARK_MEMORY_QUAD,
     BENCHMARK_MEMORY_ALL,
+    BENCHMARK_STREAM_SINGLE,
+    BENCHMARK_STREAM_DUAL,
+    BENCHMARK_STREAM_QUAD,
+    BENCHMARK_STREAM_ALL,
+    BENCHMARK_MEMORY_LATENCY,
+    BENCHMARK_NUMA,
+    BENCHMARK_STORAGE,
+    BENCHMARK_LOOPBACK_TCP_SINGLE,
+    BENCHMARK_LOOPBACK_TCP_ALL,
+    BENCHMARK_LOOPBACK_UNIX_SINGLE,
+    BENCHMARK_LOOPBACK_UNIX_ALL,
+    BENCHMARK_LOOPBACK_ZEROCOPY,
+    BENCHMARK_LOOPBACK_SENDFILE,
+    BENCHMARK_LOOPBACK_LATENCY,
+    BENCHMARK_FLOPS_SINGLE,
+    BENCHMARK_FLOPS_ALL,
+    BENCHMARK_ZLIB_LEVELS,
+    BENCHMARK_ZLIB_STREAMING,
+    BENCHMARK_SHA256,
+    BENCHMARK_CRC32C,
+    BENCHMARK_AES_SINGLE,
+    BENCHMARK_AES_ALL,
+    BENCHMARK_DGEMM,
+    BENCHMARK_SGEMM,
+    BENCHMARK_NQUEENS_STEAL,
+    BENCHMARK_FIB_TASKS,
+    BENCHMARK_BVH_RAYTRACE_SINGLE,
+    BENCHMARK_BVH_RAYTRACE_ALL,
+    BENCHMARK_KPATH_SYSCALL,
+    BENCHMARK_KPATH_SWITCH,
+    BENCHMARK_KPATH_FUTEX,
+    BENCHMARK_KPATH_CLOCK,
+    BENCHMARK_C2C,
     BENCHMARK_GUI,
     BENCHMARK_N_ENTRIES
 };
@@ -49,6 +82,110 @@ void benchmark_nqueens(void);
 void benchmark_raytrace(void);
 void benchmark_zlib(void);
 void benchmark_iperf3_single(void);
+void benchmark_stream_single(void);
+void benchmark_stream_dual(void);
+void benchmark_stream_quad(void);
+void benchmark_stream_all(void);
+void benchmark_memory_latency(void);
+void benchmark_numa(void);
+void benchmark_storage(void);
+void benchmark_loopback_tcp_single(void);
+void benchmark_loopback_tcp_all(void);
+void benchmark_loopback_unix_single(void);
+void benchmark_loopback_unix_all(void);
+void benchmark_loopback_zerocopy(void);
+void benchmark_loopback_sendfile(void);
+void benchmark_loopback_latency(void);
+void benchmark_flops_single(void);
+void benchmark_flops_all(void);
+void benchmark_zlib_levels(void);
+void benchmark_zlib_streaming(void);
+void benchmark_sha256(void);
+void benchmark_crc32c(void);
+void benchmark_aes_single(void);
+void benchmark_aes_all(void);
+void benchmark_dgemm(void);
+void benchmark_sgemm(void);
+void benchmark_nqueens_steal(void);
+void benchmark_fib_tasks(void);
+void benchmark_bvh_raytrace_single(void);
+void benchmark_bvh_raytrace_all(void);
+void benchmark_kpath_syscall(void);
+void benchmark_kpath_switch(void);
+void benchmark_kpath_futex(void);
+void benchmark_kpath_clock(void);
+void benchmark_c2c(void);
+
+/* spread of repeated runs, in the units of bench_value.result */
+typedef struct {
+    int n; /* repetitions; 0 when the benchmark ran once */
+    double median, mean, stddev;
+    double min, max;
+    double ci95; /* half-width of the 95% confidence interval of the mean */
+} bench_stats;
+
+/* result at 1, 2, 4 ... threads, from --bench-sweep */
+#define BENCH_SCALING_MAX 24
+typedef struct {
+    int n;
+    struct {
+        int threads;
+        double result;
+    } step[BENCH_SCALING_MAX];
+} bench_scaling;
+
+/* result at each working set size, from benchmarks that sweep one */
+#define BENCH_CURVE_MAX 48
+typedef struct {
+    int n;
+    struct {
+        guint64 bytes;
+        double result;
+    } point[BENCH_CURVE_MAX];
+} bench_curve;
+
+/* between every pair of NUMA nodes or cpus, from the row to the column */
+#define BENCH_MATRIX_MAX 32
+typedef struct {
+    int n; /* rows and columns; 0 when not measured */
+    int cpus; /* ids are cpus instead of NUMA nodes */
+    int id[BENCH_MATRIX_MAX];
+    double gbs[BENCH_MATRIX_MAX][BENCH_MATRIX_MAX]; /* < 0 when not measured */
+    double ns[BENCH_MATRIX_MAX][BENCH_MATRIX_MAX];
+} bench_matrix;
+
+/* duration of single callback calls in crunch benchmarks, nanoseconds */
+typedef struct {
+    guint64 n; /* calls measured; 0 when not measured */
+    guint64 p50, p90, p99, p999;
+    guint64 max;
+} bench_latency;
+
+typedef enum {
+    BENCH_PERF_CYCLES,
+    BENCH_PERF_INSTRUCTIONS,
+    BENCH_PERF_CACHE_REFS,
+    BENCH_PERF_CACHE_MISSES,
+    BENCH_PERF_BRANCH_MISSES,
+    BENCH_PERF_LLC_MISSES,
+    BENCH_PERF_N_EVENTS
+} bench_perf_event;
+
+/* hardware counters summed over the workers, user space only */
+typedef struct {
+    guint mask; /* 1 << bench_perf_event for each event counted */
+    guint64 value[BENCH_PERF_N_EVENTS];
+} bench_counters;
+
+/* clocks and temperature sampled while a crunch benchmark ran */
+typedef struct {
+    int samples; /* 0 when not sampled */
+    double mhz_min, mhz_avg, mhz_max; /* 0 without cpufreq */
+    int has_temp;
+    double temp_max; /* °C */
+    int throttled;
+    gint64 throttle_events; /* -1 without thermal_throttle counters */
+} bench_thermal;
 
 typedef struct {
     double result;
@@ -56,6 +193,13 @@ typedef struct {
     int threads_used;
     int revision;
     char extra[256]; /* no \n, ; or | */
+    bench_stats stats;
+    bench_scaling scaling;
+    bench_latency latency;
+    bench_counters counters;
+    bench_thermal thermal;
+    bench_curve *curve; /* NULL when none, freed by bench_value_free() */
+    bench_matrix *matrix;
 } bench_value;
 
 #define EMPTY_BENCH_VALUE {-1.0f,0,0,-1,""}
@@ -75,14 +219,184 @@ bench_value benchmark_parallel(gint n_threads, gpointer callback, gpointer callb
 bench_value benchmark_crunch_for(float seconds, gint n_threads,
                                gpointer callback, gpointer callback_data);
 
+/* the result of one timed run from its crunch count */
+typedef double (*BenchConvertFunc)(double count, double seconds, gpointer data);
+/* for results that aren't a multiple of the crunch count, like a time
+ * per call: the stats are taken after converting each run */
+bench_value benchmark_crunch_for_convert(float seconds, gint n_threads,
+                                         gpointer callback, gpointer callback_data,
+                                         BenchConvertFunc convert,
+                                         gpointer convert_data);
+
+/* the thread count the functions above use for n_threads */
+gint benchmark_threads(gint n_threads);
+
 extern bench_value bench_results[BENCHMARK_N_ENTRIES];
 
+/* in bench_pool.c */
+
+/* worker N always runs on the same thread, task is tasks[N] */
+typedef void (*BenchPoolFunc)(gpointer task, gint worker);
+/* returns when all workers have passed the start barrier */
+void bench_pool_start(gint n_workers, BenchPoolFunc func, gpointer *tasks);
+void bench_pool_wait(void);
+void bench_pool_run(gint n_workers, BenchPoolFunc func, gpointer *tasks);
+/* worker N is pinned to cpus[N % n_cpus]; NULL, 0 to unpin */
+void bench_pool_set_affinity(const gint *cpus, gint n_cpus);
+gint bench_pool_size(void);
+guint bench_pool_runs(void);
+/* counters of the last run, after bench_pool_wait() */
+void bench_pool_counters(bench_counters *c);
+void bench_pool_shutdown(void);
+
+/* in bench_steal.c */
+
+typedef struct _BenchSteal BenchSteal;
+/* a task; arg stays valid until the spawner's bench_steal_sync() */
+typedef void (*BenchStealFunc)(BenchSteal *s, gint worker, gpointer arg);
+typedef struct {
+    guint64 tasks;  /* run by the worker */
+    guint64 steals; /* of those, taken from another worker */
+} BenchStealWorker;
+void bench_steal_spawn(BenchSteal *s, gint worker, BenchStealFunc func,
+                       gpointer arg, gint *join);
+/* returns when every task spawned with join is done */
+void bench_steal_sync(BenchSteal *s, gint worker, gint *join);
+/* result is the number of times func(arg) ran on worker 0 in seconds;
+ * every task must be synced before func returns. counts[n_workers] may
+ * be NULL */
+bench_value bench_steal_for(float seconds, gint n_workers, BenchStealFunc func,
+                            gpointer arg, BenchStealWorker *counts);
+
+/* in bench_pin.c */
+
+typedef enum {
+    BENCH_PIN_NONE,
+    BENCH_PIN_CORES, /* one worker per physical core */
+    BENCH_PIN_SMT,   /* SMT siblings packed */
+    BENCH_PIN_NUMA,  /* spread across NUMA nodes */
+    BENCH_PIN_LIST,  /* explicit cpu list */
+} bench_pin_policy;
+
+typedef struct {
+    bench_pin_policy policy;
+    gint *cpus; /* worker N runs on cpus[N % n_cpus] */
+    gint n_cpus;
+} bench_placement;
+
+/* "none", "cores", "smt", "numa" or a cpu list like "0-3,8" */
+gboolean bench_placement_set(const gchar *policy);
+const bench_placement *bench_placement_get(void);
+const gchar *bench_pin_policy_name(bench_pin_policy policy);
+/* NULL when not pinned */
+gchar *bench_placement_describe(gint n_threads);
+
+/* in bench_stats.c */
+
+void bench_stats_compute(bench_stats *s, const double *samples, int n);
+void bench_stats_scale(bench_stats *s, double factor);
+double bench_stats_t95(int df);
+gchar *bench_stats_to_str(const bench_stats *s);
+gboolean bench_stats_from_str(bench_stats *s, const gchar *str);
+gboolean bench_stats_welch(const bench_stats *base, const bench_stats *run,
+                           double *t, double *df);
+typedef enum {
+    BENCH_VERDICT_NOISE,
+    BENCH_VERDICT_FASTER,
+    BENCH_VERDICT_SLOWER,
+} bench_verdict;
+bench_verdict bench_stats_compare(const bench_stats *base, const bench_stats *run,
+                                  gboolean lower_is_better, double threshold_pct,
+                                  double *change_pct, gboolean *tested);
+/* result per thread relative to the single-thread step, 1.0 is linear */
+double bench_scaling_efficiency(const bench_scaling *s, int step);
+gchar *bench_scaling_to_str(const bench_scaling *s);
+gboolean bench_scaling_from_str(bench_scaling *s, const gchar *str);
+gchar *bench_curve_to_str(const bench_curve *c);
+gboolean bench_curve_from_str(bench_curve *c, const gchar *str);
+void bench_matrix_init(bench_matrix *m, int n, gboolean cpus);
+bench_matrix *bench_matrix_new(int n, gboolean cpus);
+gboolean bench_matrix_has_gbs(const bench_matrix *m);
+gboolean bench_matrix_has_ns(const bench_matrix *m);
+gchar *bench_matrix_to_str(const bench_matrix *m);
+gboolean bench_matrix_from_str(bench_matrix *m, const gchar *str);
+/* a value owns its curve and matrix: a copy has its own, and the value
+ * in bench_results[] is freed before it is replaced */
+bench_value bench_value_copy(const bench_value *r);
+void bench_value_free(bench_value *r);
+
+/* in bench_hist.c */
+
+#define BENCH_HIST_BUCKETS 976 /* covers all of guint64 */
+typedef struct {
+    guint64 count[BENCH_HIST_BUCKETS];
+    guint64 n, max;
+} bench_hist;
+
+guint64 bench_hist_now_ns(void);
+void bench_hist_add(bench_hist *h, guint64 ns);
+void bench_hist_merge(bench_hist *dst, const bench_hist *src);
+guint64 bench_hist_percentile(const bench_hist *h, double p);
+void bench_latency_from_hist(bench_latency *l, const bench_hist *h);
+gchar *bench_latency_to_str(const bench_latency *l);
+gboolean bench_latency_from_str(bench_latency *l, const gchar *str);
+gchar *bench_latency_format(guint64 ns);
+
+/* in bench_perf.c */
+
+typedef struct _BenchPerfThread BenchPerfThread;
+/* NULL when there are no counters; the calling thread is counted */
+BenchPerfThread *bench_perf_thread_open(void);
+void bench_perf_thread_close(BenchPerfThread *pt);
+void bench_perf_thread_start(BenchPerfThread *pt);
+void bench_perf_thread_stop(BenchPerfThread *pt, bench_counters *c);
+const gchar *bench_perf_event_name(bench_perf_event e);
+void bench_counters_reset(bench_counters *c);
+void bench_counters_add(bench_counters *dst, const bench_counters *src);
+gboolean bench_counters_has(const bench_counters *c, bench_perf_event e);
+double bench_counters_ratio(const bench_counters *c, bench_perf_event num,
+                            bench_perf_event den, double per);
+gchar *bench_counters_to_str(const bench_counters *c);
+gboolean bench_counters_from_str(bench_counters *c, const gchar *str);
+
+/* in bench_telemetry.c */
+
+#define BENCH_TELEMETRY_INTERVAL_MS 250
+typedef struct _BenchTelemetry BenchTelemetry;
+/* watches the cpus n_threads workers run on */
+BenchTelemetry *bench_telemetry_new(gint n_threads);
+void bench_telemetry_sample(BenchTelemetry *t);
+void bench_telemetry_sleep(BenchTelemetry *t, double seconds);
+/* frees t */
+void bench_telemetry_finish(BenchTelemetry *t, bench_thermal *th);
+void bench_thermal_merge(bench_thermal *dst, const bench_thermal *src);
+gchar *bench_thermal_to_str(const bench_thermal *th);
+gboolean bench_thermal_from_str(bench_thermal *th, const gchar *str);
+
+/* in memlat.c */
+
+#define BENCH_CHASE_LINE 64
+void **bench_chase_chain(gchar *buf, gsize bytes, guint32 *order, guint64 *seed);
+/* latency of the loads in the chain from p, in ns */
+double bench_chase_ns(void **p, gsize lines);
+
 /* in bench_util.c */
 
 /* guarantee a minimum size of data
  * or return null */
 gchar *get_test_data(gsize min_size);
+/* last level cache of the whole machine, 0 if unknown */
+gsize bench_llc_bytes(void);
+gchar *bench_huge_alloc(gsize bytes);
+/* lowercase hex; free() it */
+char *digest_to_str(const char *digest, int len);
 char *md5_digest_str(const char *data, unsigned int len);
+gchar **bench_cpu_flags(void);
+/* every flag in the space separated needed is in flags */
+gboolean bench_cpu_has(gchar **flags, const gchar *needed);
+/* appends to r->extra with ", " and drops any \n ; | */
+void bench_value_append_extra(bench_value *r, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
 #define bench_msg(msg, ...)  fprintf (stderr, "[%s] " msg "\n", __FUNCTION__, ##__VA_ARGS__)
 
 #endif /* __BENCHMARK_H__ */
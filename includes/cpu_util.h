@@ -28,20 +28,42 @@ typedef struct {
     gchar *shared_list;
 } cpufreq_data;
 
+/* topology id not available */
+#define CPU_TOPO_NULL -9877
+
 typedef struct {
     gint id; /* thread */
     gint socket_id;
     gint core_id;
     gint book_id;
     gint drawer_id;
+    gint node_id; /* NUMA node */
 } cpu_topology_data;
 
+/* one /sys/devices/system/cpu/cpu%d/cache/index%d */
+typedef struct {
+    gint level;
+    gint number_of_sets;
+    gint physical_line_partition;
+    gint size; /* KiB */
+    gchar *type;
+    gint ways_of_associativity;
+    gint uid; /* uid is unique among caches with the same (type, level) */
+    gchar *shared_cpu_list; /* some kernel's don't give a uid, so try shared_cpu_list */
+    gint phy_sock;
+} cpu_cache_data;
+
 cpufreq_data *cpufreq_new(gint id);
 void cpufreq_update(cpufreq_data *cpufd, int cur_only);
 void cpufreq_free(cpufreq_data *cpufd);
 
 gchar *cpufreq_section_str(cpufreq_data *cpufd);
 
+/* list of cpu_cache_data, in index order; NULL when not available */
+GSList *cpucache_list_new(gint id);
+void cpucache_free(cpu_cache_data *cache);
+void cpucache_list_free(GSList *caches);
+
 cpu_topology_data *cputopo_new(gint id);
 void cputopo_free(cpu_topology_data *cputd);
 
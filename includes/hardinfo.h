@@ -38,6 +38,7 @@ typedef enum {
   MODULE_FLAG_NO_REMOTE = 1<<0,
   MODULE_FLAG_HAS_HELP = 1<<1,
   MODULE_FLAG_HIDE = 1<<2,
+  MODULE_FLAG_NO_REPORT = 1<<3, /* in the tree, but not in reports */
 } ModuleEntryFlags;
 
 typedef struct _ModuleEntry		ModuleEntry;
@@ -55,6 +56,7 @@ struct _ProgramParameters {
   gint theme;
   gint darkmode;
   gint aborting_benchmarks;
+  gint bench_regressed; /* set by --bench-baseline */
   /*
    * OK to use the common parts of HTML(4.0) and Pango Markup
    * in the value part of a key/value.
@@ -69,6 +71,16 @@ struct _ProgramParameters {
   gchar   *run_benchmark;
   gchar   *bench_user_note;
   gchar   *result_format;
+  gchar   *bench_pin;
+  gint     bench_repeat;
+  gint     bench_warmup;
+  gint     bench_sweep;
+  gint     bench_batch;
+  gint     bench_threads;
+  gchar   *bench_baseline;
+  gchar   *bench_save_baseline;
+  gdouble  bench_threshold;
+  gchar   *bench_dir;
   gchar   *path_lib;
   gchar   *path_data;
   gchar   *path_locale;
@@ -21,19 +21,7 @@
 
 #include "cpu_util.h"
 
-typedef struct _ProcessorCache ProcessorCache;
-
-struct _ProcessorCache {
-    gint level;
-    gint number_of_sets;
-    gint physical_line_partition;
-    gint size;
-    gchar *type;
-    gint ways_of_associativity;
-    gint uid; /* uid is unique among caches with the same (type, level) */
-    gchar *shared_cpu_list; /* some kernel's don't give a uid, so try shared_cpu_list */
-    gint phy_sock;
-};
+typedef cpu_cache_data ProcessorCache;
 
 struct _Processor {
     gchar *model_name;
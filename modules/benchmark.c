@@ -37,6 +37,10 @@
 
 bench_value bench_results[BENCHMARK_N_ENTRIES];
 
+/* when > 0, the thread count used by benchmark_crunch_for() and
+ * benchmark_parallel_for() whatever the benchmark asks for */
+static gint bench_threads_override = 0;
+
 static void do_benchmark(void (*benchmark_function)(void), int entry);
 static gchar *benchmark_include_results_reverse(bench_value result,
                                                 const gchar *benchmark);
@@ -46,19 +50,94 @@ static gchar *benchmark_include_results(bench_value result,
 /* ModuleEntry entries, scan_*(), callback_*(), etc. */
 #include "benchmark/benches.c"
 
+/* "result; elapsed; threads; revision; extra" followed by optional
+ * "|name=value" sections, which older readers stop at */
 char *bench_value_to_str(bench_value r)
 {
+  gboolean has_stats = (r.stats.n > 1);
+  gboolean has_scaling = (r.scaling.n > 0);
+  gboolean has_latency = (r.latency.n > 0);
+  gboolean has_counters = (r.counters.mask != 0);
+  gboolean has_thermal = (r.thermal.samples > 0);
+  gboolean has_curve = (r.curve && r.curve->n > 0);
+  gboolean has_matrix = (r.matrix && r.matrix->n > 0);
+  gboolean has_sections = (has_stats || has_scaling || has_latency ||
+                           has_counters || has_thermal || has_curve ||
+                           has_matrix);
   gboolean has_rev = (r.revision >= 0);
   gboolean has_extra = (*r.extra != 0);
     char *ret = g_strdup_printf("%lf; %lf; %d", r.result, r.elapsed_time,
                                 r.threads_used);
-    if (has_rev || has_extra)
+    gchar *section;
+    if (has_rev || has_extra || has_sections)
         ret = appf(ret, "; ", "%d", r.revision);
-    if (has_extra)
+    if (has_extra || has_sections)
         ret = appf(ret, "; ", "%s", r.extra);
+    if (has_stats) {
+        section = bench_stats_to_str(&r.stats);
+        ret = appf(ret, "|", "stats=%s", section);
+        g_free(section);
+    }
+    if (has_scaling) {
+        section = bench_scaling_to_str(&r.scaling);
+        ret = appf(ret, "|", "scaling=%s", section);
+        g_free(section);
+    }
+    if (has_latency) {
+        section = bench_latency_to_str(&r.latency);
+        ret = appf(ret, "|", "latency=%s", section);
+        g_free(section);
+    }
+    if (has_counters) {
+        section = bench_counters_to_str(&r.counters);
+        ret = appf(ret, "|", "counters=%s", section);
+        g_free(section);
+    }
+    if (has_thermal) {
+        section = bench_thermal_to_str(&r.thermal);
+        ret = appf(ret, "|", "thermal=%s", section);
+        g_free(section);
+    }
+    if (has_curve) {
+        section = bench_curve_to_str(r.curve);
+        ret = appf(ret, "|", "curve=%s", section);
+        g_free(section);
+    }
+    if (has_matrix) {
+        section = bench_matrix_to_str(r.matrix);
+        ret = appf(ret, "|", "matrix=%s", section);
+        g_free(section);
+    }
     return ret;
 }
 
+static void bench_value_section_from_str(bench_value *r, const char *section)
+{
+    if (g_str_has_prefix(section, "stats="))
+        bench_stats_from_str(&r->stats, section + strlen("stats="));
+    else if (g_str_has_prefix(section, "scaling="))
+        bench_scaling_from_str(&r->scaling, section + strlen("scaling="));
+    else if (g_str_has_prefix(section, "latency="))
+        bench_latency_from_str(&r->latency, section + strlen("latency="));
+    else if (g_str_has_prefix(section, "counters="))
+        bench_counters_from_str(&r->counters, section + strlen("counters="));
+    else if (g_str_has_prefix(section, "thermal="))
+        bench_thermal_from_str(&r->thermal, section + strlen("thermal="));
+    else if (g_str_has_prefix(section, "curve=") && !r->curve) {
+        r->curve = g_new(bench_curve, 1);
+        if (!bench_curve_from_str(r->curve, section + strlen("curve="))) {
+            g_free(r->curve);
+            r->curve = NULL;
+        }
+    } else if (g_str_has_prefix(section, "matrix=") && !r->matrix) {
+        r->matrix = g_new(bench_matrix, 1);
+        if (!bench_matrix_from_str(r->matrix, section + strlen("matrix="))) {
+            g_free(r->matrix);
+            r->matrix = NULL;
+        }
+    }
+}
+
 bench_value bench_value_from_str(const char *str)
 {
     bench_value ret = EMPTY_BENCH_VALUE;
@@ -88,6 +167,12 @@ bench_value bench_value_from_str(const char *str)
         if (c >= 5) {
             strcpy(ret.extra, extra);
         }
+        if (c >= 3 && (p = strchr(str, '|'))) {
+            gchar **sections = g_strsplit_set(p + 1, "|\r\n", -1);
+            for (t = 0; sections[t]; t++)
+                bench_value_section_from_str(&ret, sections[t]);
+            g_strfreev(sections);
+        }
     }
     return ret;
 }
@@ -98,137 +183,242 @@ struct _ParallelBenchTask {
     gint thread_number;
     guint start, end;
     gpointer data, callback;
-    int *stop;
+    gint *stop;
+    bench_hist *hist; /* crunch: per-call durations, owned by this worker */
+    gpointer return_value;
 };
 
-static gpointer benchmark_crunch_for_dispatcher(gpointer data)
+static void benchmark_crunch_for_dispatcher(gpointer data, gint worker)
 {
     ParallelBenchTask *pbt = (ParallelBenchTask *)data;
     gpointer (*callback)(void *data, gint thread_number);
     gpointer return_value = g_malloc(sizeof(double));
     int count = 0;
+    guint64 t0, t1;
 
     if ((callback = pbt->callback)) {
-        while (!*pbt->stop) {
+        while (!g_atomic_int_get(pbt->stop)) {
+            t0 = bench_hist_now_ns();
             callback(pbt->data, pbt->thread_number);
             /* don't count if didn't finish in time */
-            if (!*pbt->stop)
+            if (!g_atomic_int_get(pbt->stop)) {
+                t1 = bench_hist_now_ns();
                 count++;
+                if (pbt->hist)
+                    bench_hist_add(pbt->hist, t1 - t0);
+            }
         }
     } else {
-        DEBUG("this is thread %p; callback is NULL and it should't be!",
-              g_thread_self());
+        DEBUG("this is worker %d; callback is NULL and it should't be!",
+              worker);
     }
 
-    g_free(pbt);
-
     *(double *)return_value = (double)count;
-    return return_value;
+    pbt->return_value = return_value;
 }
 
-bench_value benchmark_crunch_for(float seconds,
-                                 gint n_threads,
-                                 gpointer callback,
-                                 gpointer callback_data)
+/* one task per worker; tasks[] is what the pool hands out */
+static ParallelBenchTask *benchmark_tasks_new(gint n_threads, gpointer **tasks)
 {
-    int cpu_procs, cpu_cores, cpu_threads, cpu_nodes;
-    int thread_number, stop = 0;
-    GSList *threads = NULL, *t;
-    GTimer *timer = NULL;
-    bench_value ret = EMPTY_BENCH_VALUE;
+    ParallelBenchTask *pbt = g_new0(ParallelBenchTask, n_threads);
+    gint i;
 
-    timer = g_timer_new();
+    *tasks = g_new0(gpointer, n_threads);
+    for (i = 0; i < n_threads; i++)
+        (*tasks)[i] = &pbt[i];
+    return pbt;
+}
+
+/* threads benchmark_crunch_for() and benchmark_parallel_for() use for
+ * n_threads: itself when > 0, all cores when < 0 and all threads when 0 */
+gint benchmark_threads(gint n_threads)
+{
+    int cpu_procs, cpu_cores, cpu_threads, cpu_nodes;
 
     cpu_procs_cores_threads_nodes(&cpu_procs, &cpu_cores, &cpu_threads, &cpu_nodes);
+    if (bench_threads_override > 0)
+        return bench_threads_override;
     if (n_threads > 0)
-        ret.threads_used = n_threads;
-    else if (n_threads < 0)
-        ret.threads_used = cpu_cores;
-    else
-        ret.threads_used = cpu_threads;
+        return n_threads;
+    if (n_threads < 0)
+        return cpu_cores;
+    if (params.bench_threads > 0)
+        return params.bench_threads;
+    return cpu_threads;
+}
 
-    g_timer_start(timer);
-    for (thread_number = 0; thread_number < ret.threads_used; thread_number++) {
-        ParallelBenchTask *pbt = g_new0(ParallelBenchTask, 1);
-        GThread *thread;
+/* one timed run; returns the number of callbacks finished in time and,
+ * if not NULL, adds their durations to hist and the hardware counters
+ * to counters, and samples clocks and temperatures into thermal */
+static double benchmark_crunch_once(float seconds,
+                                    gint n_threads,
+                                    gpointer callback,
+                                    gpointer callback_data,
+                                    double *elapsed,
+                                    bench_hist *hist,
+                                    bench_counters *counters,
+                                    bench_thermal *thermal)
+{
+    int thread_number;
+    gint stop = 0;
+    ParallelBenchTask *pbt;
+    gpointer *tasks;
+    bench_hist *thread_hist = NULL;
+    BenchTelemetry *telemetry = NULL;
+    GTimer *timer;
+    double count = 0;
 
-        DEBUG("launching thread %d", thread_number);
+    timer = g_timer_new();
 
-        pbt->thread_number = thread_number;
-        pbt->data = callback_data;
-        pbt->callback = callback;
-        pbt->stop = &stop;
+    if (hist)
+        thread_hist = g_new0(bench_hist, n_threads);
+
+    pbt = benchmark_tasks_new(n_threads, &tasks);
+    for (thread_number = 0; thread_number < n_threads; thread_number++) {
+        pbt[thread_number].thread_number = thread_number;
+        pbt[thread_number].data = callback_data;
+        pbt[thread_number].callback = callback;
+        pbt[thread_number].stop = &stop;
+        if (thread_hist)
+            pbt[thread_number].hist = &thread_hist[thread_number];
+    }
 
-#if GLIB_CHECK_VERSION(2,32,0)
-        thread = g_thread_new("dispatcher", (GThreadFunc)benchmark_crunch_for_dispatcher, pbt);
-#else
-        thread = g_thread_create((GThreadFunc)benchmark_crunch_for_dispatcher, pbt,TRUE,NULL);
-#endif
-        threads = g_slist_prepend(threads, thread);
+    if (thermal)
+        telemetry = bench_telemetry_new(n_threads);
 
-        DEBUG("thread %d launched as context %p", thread_number, thread);
-    }
+    DEBUG("starting %d workers", n_threads);
+    bench_pool_start(n_threads, benchmark_crunch_for_dispatcher, tasks);
+    g_timer_start(timer);
 
     /* wait for time */
     // while ( g_timer_elapsed(timer, NULL) < seconds ) { }
-    g_usleep(seconds * 1000000);
+    if (telemetry)
+        bench_telemetry_sleep(telemetry, seconds);
+    else
+        g_usleep(seconds * 1000000);
 
     /* signal all threads to stop */
-    stop = 1;
+    g_atomic_int_set(&stop, 1);
     g_timer_stop(timer);
 
-    ret.result = 0;
-    DEBUG("waiting for all threads to finish");
-    for (t = threads; t; t = t->next) {
-        DEBUG("waiting for thread with context %p", t->data);
-        gpointer *rv = g_thread_join((GThread *)t->data);
-        ret.result += *(double *)rv;
-        g_free(rv);
+    if (telemetry)
+        bench_telemetry_finish(telemetry, thermal);
+
+    DEBUG("waiting for all workers to finish");
+    bench_pool_wait();
+    if (counters) {
+        bench_counters run;
+        bench_pool_counters(&run);
+        bench_counters_add(counters, &run);
+    }
+    for (thread_number = 0; thread_number < n_threads; thread_number++) {
+        count += *(double *)pbt[thread_number].return_value;
+        g_free(pbt[thread_number].return_value);
+        if (thread_hist)
+            bench_hist_merge(hist, &thread_hist[thread_number]);
     }
 
-    ret.elapsed_time = g_timer_elapsed(timer, NULL);
+    *elapsed = g_timer_elapsed(timer, NULL);
 
-    g_slist_free(threads);
+    g_free(thread_hist);
+    g_free(tasks);
+    g_free(pbt);
     g_timer_destroy(timer);
 
+    return count;
+}
+
+/* With --bench-warmup, an untimed run comes first so caches, page tables
+ * and clocks settle. With --bench-repeat, the timed run is repeated: the
+ * result is the median and the spread goes in ret.stats. The duration of
+ * every callback in the timed runs goes in ret.latency, the hardware
+ * counters, when available, in ret.counters, and the clocks and
+ * temperatures sampled meanwhile in ret.thermal.
+ *
+ * With convert, the crunch count of each timed run goes through it
+ * before the median and the stats are taken, so they are in the
+ * benchmark's units; without it they are crunch counts. */
+bench_value benchmark_crunch_for_convert(float seconds,
+                                         gint n_threads,
+                                         gpointer callback,
+                                         gpointer callback_data,
+                                         BenchConvertFunc convert,
+                                         gpointer convert_data)
+{
+    int reps = MAX(params.bench_repeat, 1), i;
+    double *samples, elapsed, total_elapsed = 0;
+    bench_hist *hist;
+    bench_value ret = EMPTY_BENCH_VALUE;
+
+    ret.threads_used = benchmark_threads(n_threads);
+
+    if (params.bench_warmup > 0) {
+        DEBUG("warming up for %d seconds", params.bench_warmup);
+        benchmark_crunch_once(params.bench_warmup, ret.threads_used,
+                              callback, callback_data, &elapsed, NULL, NULL, NULL);
+    }
+
+    hist = g_new0(bench_hist, 1);
+    samples = g_new0(double, reps);
+    bench_counters_reset(&ret.counters);
+    for (i = 0; i < reps; i++) {
+        bench_thermal thermal;
+        samples[i] = benchmark_crunch_once(seconds, ret.threads_used,
+                                           callback, callback_data, &elapsed,
+                                           hist, &ret.counters, &thermal);
+        if (convert)
+            samples[i] = convert(samples[i], elapsed, convert_data);
+        bench_thermal_merge(&ret.thermal, &thermal);
+        total_elapsed += elapsed;
+    }
+    bench_latency_from_hist(&ret.latency, hist);
+    g_free(hist);
+
+    if (reps > 1) {
+        bench_stats_compute(&ret.stats, samples, reps);
+        ret.result = ret.stats.median;
+    } else {
+        ret.result = samples[0];
+    }
+    ret.elapsed_time = total_elapsed / reps;
+    g_free(samples);
+
     return ret;
 }
 
-static gpointer benchmark_parallel_for_dispatcher(gpointer data)
+bench_value benchmark_crunch_for(float seconds,
+                                 gint n_threads,
+                                 gpointer callback,
+                                 gpointer callback_data)
+{
+    return benchmark_crunch_for_convert(seconds, n_threads, callback,
+                                        callback_data, NULL, NULL);
+}
+
+static void benchmark_parallel_for_dispatcher(gpointer data, gint worker)
 {
     ParallelBenchTask *pbt = (ParallelBenchTask *)data;
     gpointer (*callback)(unsigned int start, unsigned int end, void *data,
                          gint thread_number);
-    gpointer return_value = NULL;
 
     if ((callback = pbt->callback)) {
-        DEBUG("this is thread %p; items %d -> %d, data %p", g_thread_self(),
+        DEBUG("this is worker %d; items %d -> %d, data %p", worker,
               pbt->start, pbt->end, pbt->data);
-        return_value =
+        pbt->return_value =
             callback(pbt->start, pbt->end, pbt->data, pbt->thread_number);
-        DEBUG("this is thread %p; return value is %p", g_thread_self(),
-              return_value);
+        DEBUG("this is worker %d; return value is %p", worker,
+              pbt->return_value);
     } else {
-        DEBUG("this is thread %p; callback is NULL and it should't be!",
-              g_thread_self());
+        DEBUG("this is worker %d; callback is NULL and it should't be!",
+              worker);
     }
-
-    g_free(pbt);
-
-    return return_value;
 }
 
 /* one call for each thread to be used */
 bench_value
 benchmark_parallel(gint n_threads, gpointer callback, gpointer callback_data)
 {
-    int cpu_procs, cpu_cores, cpu_threads, cpu_nodes;
-    cpu_procs_cores_threads_nodes(&cpu_procs, &cpu_cores, &cpu_threads, &cpu_nodes);
-
-    if (n_threads == 0)
-        n_threads = cpu_threads;
-    else if (n_threads == -1)
-        n_threads = cpu_cores;
+    n_threads = benchmark_threads(n_threads);
 
     return benchmark_parallel_for(n_threads, 0, n_threads, callback,
                                   callback_data);
@@ -245,23 +435,17 @@ bench_value benchmark_parallel_for(gint n_threads,
                                    gpointer callback,
                                    gpointer callback_data)
 {
-    int cpu_procs, cpu_cores, cpu_threads, cpu_nodes;
     guint iter_per_thread=1, iter, thread_number = 0;
-    GSList *threads = NULL, *t;
+    ParallelBenchTask *pbt;
+    gpointer *tasks;
     GTimer *timer;
+    guint i;
 
     bench_value ret = EMPTY_BENCH_VALUE;
 
     timer = g_timer_new();
 
-    cpu_procs_cores_threads_nodes(&cpu_procs, &cpu_cores, &cpu_threads, &cpu_nodes);
-
-    if (n_threads > 0)
-        ret.threads_used = n_threads;
-    else if (n_threads < 0)
-        ret.threads_used = cpu_cores;
-    else
-        ret.threads_used = cpu_threads;
+    ret.threads_used = benchmark_threads(n_threads);
 
     while (ret.threads_used > 0) {
         iter_per_thread = (end - start) / ret.threads_used;
@@ -274,44 +458,41 @@ bench_value benchmark_parallel_for(gint n_threads,
         }
     }
 
-    DEBUG("Using %d threads across %d logical processors; processing %d "
-          "elements (%d per thread)",
-          ret.threads_used, cpu_threads, (end - start), iter_per_thread);
+    DEBUG("Using %d threads; processing %d elements (%d per thread)",
+          ret.threads_used, (end - start), iter_per_thread);
 
-    g_timer_start(timer);
-    for (iter = start; iter < end;) {
-        ParallelBenchTask *pbt = g_new0(ParallelBenchTask, 1);
-        GThread *thread;
+    if (ret.threads_used <= 0) {
+        g_timer_destroy(timer);
+        return ret;
+    }
 
+    pbt = benchmark_tasks_new(ret.threads_used, &tasks);
+    for (iter = start; iter < end;) {
         guint ts = iter, te = iter + iter_per_thread;
         /* add the remainder of items/iter_per_thread to the last thread */
         if (end - te < iter_per_thread)
             te = end;
         iter = te;
 
-        DEBUG("launching thread %d", 1 + thread_number);
-
-        pbt->thread_number = thread_number++;
-        pbt->start = ts;
-        pbt->end = te - 1;
-        pbt->data = callback_data;
-        pbt->callback = callback;
-
-#if GLIB_CHECK_VERSION(2,32,0)
-        thread = g_thread_new("dispatcher", (GThreadFunc)benchmark_parallel_for_dispatcher, pbt);
-#else
-        thread = g_thread_create((GThreadFunc)benchmark_parallel_for_dispatcher, pbt,TRUE,NULL);
-#endif
+        pbt[thread_number].thread_number = thread_number;
+        pbt[thread_number].start = ts;
+        pbt[thread_number].end = te - 1;
+        pbt[thread_number].data = callback_data;
+        pbt[thread_number].callback = callback;
+        thread_number++;
+    }
 
-        threads = g_slist_prepend(threads, thread);
+    DEBUG("starting %d workers", thread_number);
+    bench_pool_start(thread_number, benchmark_parallel_for_dispatcher, tasks);
+    g_timer_start(timer);
 
-        DEBUG("thread %d launched as context %p", thread_number, thread);
-    }
+    DEBUG("waiting for all workers to finish");
+    bench_pool_wait();
+    g_timer_stop(timer);
+    bench_pool_counters(&ret.counters);
 
-    DEBUG("waiting for all threads to finish");
-    for (t = threads; t; t = t->next) {
-        DEBUG("waiting for thread with context %p", t->data);
-        gpointer *rv = g_thread_join((GThread *)t->data);
+    for (i = 0; i < thread_number; i++) {
+        gpointer *rv = pbt[i].return_value;
         if (rv) {
             if (ret.result == -1.0)
                 ret.result = 0;
@@ -320,10 +501,10 @@ bench_value benchmark_parallel_for(gint n_threads,
         g_free(rv);
     }
 
-    g_timer_stop(timer);
     ret.elapsed_time = g_timer_elapsed(timer, NULL);
 
-    g_slist_free(threads);
+    g_free(tasks);
+    g_free(pbt);
     g_timer_destroy(timer);
 
     DEBUG("finishing; all threads took %f seconds to finish", ret.elapsed_time);
@@ -585,6 +766,10 @@ struct _BenchmarkDialog {
     bench_value r;
 };
 
+/* entries filled by benchmark_run_batch(), not to be run again by the
+ * do_benchmark() that follows from the scan callback */
+static gboolean bench_batch_done[BENCHMARK_N_ENTRIES];
+
 static gboolean
 do_benchmark_handler(GIOChannel *source, GIOCondition condition, gpointer data)
 {
@@ -610,32 +795,59 @@ do_benchmark_handler(GIOChannel *source, GIOCondition condition, gpointer data)
     return FALSE;
 }
 
-static void do_benchmark(void (*benchmark_function)(void), int entry)
+/* argv for "hardinfo2 -b <name>", passing on the benchmark options;
+ * name is a comma separated list when batch is set.
+ * free with g_strfreev() */
+static gchar **benchmark_child_argv(const gchar *name, gboolean batch)
 {
-    int old_priority = 0;
+    GPtrArray *argv = g_ptr_array_new();
+
+    g_ptr_array_add(argv, g_strdup(params.argv0));
+    g_ptr_array_add(argv, g_strdup("-b"));
+    g_ptr_array_add(argv, g_strdup(name));
+    if (batch)
+        g_ptr_array_add(argv, g_strdup("--bench-batch"));
+    if (params.bench_pin) {
+        g_ptr_array_add(argv, g_strdup("--bench-pin"));
+        g_ptr_array_add(argv, g_strdup(params.bench_pin));
+    }
+    if (params.bench_repeat > 1) {
+        g_ptr_array_add(argv, g_strdup("--bench-repeat"));
+        g_ptr_array_add(argv, g_strdup_printf("%d", params.bench_repeat));
+    }
+    if (params.bench_warmup > 0) {
+        g_ptr_array_add(argv, g_strdup("--bench-warmup"));
+        g_ptr_array_add(argv, g_strdup_printf("%d", params.bench_warmup));
+    }
+    if (params.bench_sweep)
+        g_ptr_array_add(argv, g_strdup("--bench-sweep"));
+    if (params.bench_threads > 0) {
+        g_ptr_array_add(argv, g_strdup("--bench-threads"));
+        g_ptr_array_add(argv, g_strdup_printf("%d", params.bench_threads));
+    }
+    if (params.bench_dir) {
+        g_ptr_array_add(argv, g_strdup("--bench-dir"));
+        g_ptr_array_add(argv, g_strdup(params.bench_dir));
+    }
+    g_ptr_array_add(argv, NULL);
 
-    if (params.skip_benchmarks)
-        return;
+    return (gchar **)g_ptr_array_free(argv, FALSE);
+}
 
-    if (params.gui_running && !params.run_benchmark) {
-        gchar *argv[] = {params.argv0, "-b",entries[entry].name,NULL};
-        GPid bench_pid;
-        gint bench_stdout;
-        GtkWidget *bench_dialog = NULL;
-        GtkWidget *bench_image;
-        BenchmarkDialog *benchmark_dialog = NULL;
-        GSpawnFlags spawn_flags = G_SPAWN_STDERR_TO_DEV_NULL;
-	gchar *bench_status;
-        GtkWidget *content_area, *box, *label;
-        bench_value r = EMPTY_BENCH_VALUE;
-        GIOChannel *channel=NULL;
-        guint watch_id;
-        gboolean done=FALSE;
-        bench_results[entry] = r;
+static void benchmark_status_update(const gchar *name)
+{
+    gchar *bench_status;
+
+    bench_status = g_strdup_printf(_("Benchmarking: <b>%s</b>."), name);
+    shell_status_update(bench_status);
+    g_free(bench_status);
+}
 
-	bench_status = g_strdup_printf(_("Benchmarking: <b>%s</b>."), entries[entry].name);
-        shell_status_update(bench_status);
-	g_free(bench_status);
+/* modal "Benchmarking..." dialog with a Stop button */
+static GtkWidget *benchmark_dialog_new(void)
+{
+    GtkWidget *bench_dialog, *bench_image;
+    GtkWidget *content_area, *box, *label;
 
 	bench_dialog = gtk_dialog_new_with_buttons ("Benchmarking...",
                                       GTK_WINDOW(shell_get_main_shell()->transient_dialog),
@@ -667,6 +879,220 @@ static void do_benchmark(void (*benchmark_function)(void), int entry)
 	gtk_window_set_deletable(GTK_WINDOW(bench_dialog), FALSE);
 	gtk_widget_show_all (bench_dialog);
 
+    return bench_dialog;
+}
+
+typedef struct _BenchmarkBatch BenchmarkBatch;
+struct _BenchmarkBatch {
+    GtkWidget *dialog;
+    gint *queue; /* entry indexes, in the order the child runs them */
+    gint n_queued, n_done;
+    guint watch_id;
+};
+
+static gint benchmark_entry_by_name(const gchar *name)
+{
+    gint i;
+
+    for (i = 0; entries[i].name; i++) {
+        if (g_str_equal(entries[i].name, name))
+            return i;
+    }
+    return -1;
+}
+
+/* one "name<TAB>result" line per finished benchmark */
+static gboolean
+do_benchmark_batch_handler(GIOChannel *source, GIOCondition condition, gpointer data)
+{
+    BenchmarkBatch *batch = (BenchmarkBatch *)data;
+    GIOStatus status;
+    gchar *line = NULL, *tab, *title;
+    gint entry;
+
+    status = g_io_channel_read_line(source, &line, NULL, NULL, NULL);
+    if (status == G_IO_STATUS_AGAIN)
+        return TRUE;
+    if (status != G_IO_STATUS_NORMAL) {
+        /* child is gone */
+        batch->watch_id = 0;
+        gtk_dialog_response(GTK_DIALOG(batch->dialog), GTK_RESPONSE_NONE);
+        return FALSE;
+    }
+
+    if (line && (tab = strchr(line, '\t'))) {
+        *tab = 0;
+        entry = benchmark_entry_by_name(line);
+        if (entry >= 0) {
+            bench_value_free(&bench_results[entry]);
+            bench_results[entry] = bench_value_from_str(tab + 1);
+            bench_batch_done[entry] = TRUE;
+            batch->n_done++;
+            DEBUG("batch: %s done (%d/%d)", line, batch->n_done, batch->n_queued);
+        }
+        if (batch->n_done < batch->n_queued) {
+            benchmark_status_update(entries[batch->queue[batch->n_done]].name);
+            title = g_strdup_printf("Benchmarking (%d/%d)...",
+                                    batch->n_done + 1, batch->n_queued);
+            gtk_window_set_title(GTK_WINDOW(batch->dialog), title);
+            g_free(title);
+        }
+    }
+    g_free(line);
+
+    return TRUE;
+}
+
+/* Runs all the entries in queue in a single child process, instead of
+ * spawning one per benchmark. Results are stored as they arrive, so
+ * after Stop the benchmarks that already finished keep their result. */
+static void benchmark_run_batch(gint *queue, gint n_queued)
+{
+    BenchmarkBatch batch = { .queue = queue, .n_queued = n_queued };
+    GSpawnFlags spawn_flags = G_SPAWN_STDERR_TO_DEV_NULL;
+    GString *names = g_string_new(NULL);
+    GIOChannel *channel;
+    GPid bench_pid;
+    gint bench_stdout, i;
+    gchar **argv;
+    gboolean done = FALSE;
+
+    if (n_queued < 1) {
+        g_string_free(names, TRUE);
+        return;
+    }
+
+    for (i = 0; i < n_queued; i++) {
+        if (i)
+            g_string_append_c(names, ',');
+        g_string_append(names, entries[queue[i]].name);
+        bench_value_free(&bench_results[queue[i]]);
+        bench_results[queue[i]] = (bench_value)EMPTY_BENCH_VALUE;
+    }
+    argv = benchmark_child_argv(names->str, TRUE);
+    g_string_free(names, TRUE);
+
+    if (!g_path_is_absolute(params.argv0)) {
+        spawn_flags |= G_SPAWN_SEARCH_PATH;
+    }
+
+    if (!g_spawn_async_with_pipes(NULL, argv, NULL, spawn_flags, NULL, NULL,
+                                  &bench_pid, NULL, &bench_stdout, NULL,
+                                  NULL)) {
+        g_strfreev(argv);
+        return;
+    }
+
+    benchmark_status_update(entries[queue[0]].name);
+    batch.dialog = benchmark_dialog_new();
+
+    channel = g_io_channel_unix_new(bench_stdout);
+    g_io_channel_set_close_on_unref(channel, TRUE);
+    batch.watch_id = g_io_add_watch(channel, G_IO_IN | G_IO_HUP,
+                                    do_benchmark_batch_handler, &batch);
+
+    switch (gtk_dialog_run(GTK_DIALOG(batch.dialog))) {
+    case GTK_RESPONSE_NONE:
+        done = TRUE;
+        break;
+    case GTK_RESPONSE_ACCEPT:
+        /* stop: keep what finished, drop the rest */
+        break;
+    }
+
+    if (batch.watch_id)
+        g_source_remove(batch.watch_id);
+    if (!done) {
+        kill(bench_pid, SIGINT);
+        params.aborting_benchmarks = 1;
+    }
+    /* a benchmark that failed in the child is not retried on its own */
+    for (i = 0; i < n_queued; i++)
+        bench_batch_done[queue[i]] = TRUE;
+
+    g_io_channel_unref(channel);
+    gtk_widget_destroy(batch.dialog);
+    g_strfreev(argv);
+}
+
+/* Runs the benchmark again at 1, 2, 4 ... threads, up to the number of
+ * logical cpus, and keeps the result of each step in scaling. The step
+ * with the benchmark's own thread count reuses its result. */
+static void benchmark_sweep(void (*benchmark_function)(void), int entry)
+{
+    int cpu_procs, cpu_cores, cpu_threads, cpu_nodes;
+    bench_value native = bench_results[entry];
+    bench_scaling *sc = &native.scaling;
+    gint threads, next;
+
+    cpu_procs_cores_threads_nodes(&cpu_procs, &cpu_cores, &cpu_threads, &cpu_nodes);
+    /* a latency does not add up over threads */
+    if (native.result <= 0 || cpu_threads < 2 || entries_lower_is_better[entry])
+        return;
+
+    memset(sc, 0, sizeof(bench_scaling));
+    for (threads = 1; threads <= cpu_threads && sc->n < BENCH_SCALING_MAX; threads = next) {
+        next = threads * 2;
+        if (threads < cpu_threads && next > cpu_threads)
+            next = cpu_threads;
+
+        sc->step[sc->n].threads = threads;
+        if (threads == native.threads_used) {
+            sc->step[sc->n].result = native.result;
+        } else {
+            DEBUG("sweep %s: %d threads", entries[entry].name, threads);
+            /* native keeps its curve and matrix */
+            bench_results[entry] = (bench_value)EMPTY_BENCH_VALUE;
+            bench_threads_override = threads;
+            benchmark_function();
+            bench_threads_override = 0;
+            sc->step[sc->n].result = bench_results[entry].result;
+            bench_value_free(&bench_results[entry]);
+        }
+        sc->n++;
+
+        if (params.aborting_benchmarks)
+            break;
+    }
+
+    bench_results[entry] = native;
+}
+
+static void do_benchmark(void (*benchmark_function)(void), int entry)
+{
+    static gboolean placement_set = FALSE;
+    int old_priority = 0;
+    guint pool_runs;
+    bench_value *result;
+
+    if (params.skip_benchmarks)
+        return;
+
+    if (params.gui_running && !params.run_benchmark) {
+        gchar **argv;
+        GPid bench_pid;
+        gint bench_stdout;
+        GtkWidget *bench_dialog = NULL;
+        BenchmarkDialog *benchmark_dialog = NULL;
+        GSpawnFlags spawn_flags = G_SPAWN_STDERR_TO_DEV_NULL;
+        bench_value r = EMPTY_BENCH_VALUE;
+        GIOChannel *channel=NULL;
+        guint watch_id;
+        gboolean done=FALSE;
+
+        if (bench_batch_done[entry]) {
+            /* already ran in a batch */
+            bench_batch_done[entry] = FALSE;
+            return;
+        }
+
+        argv = benchmark_child_argv(entries[entry].name, FALSE);
+        bench_value_free(&bench_results[entry]);
+        bench_results[entry] = r;
+
+        benchmark_status_update(entries[entry].name);
+        bench_dialog = benchmark_dialog_new();
+
         //while (gtk_events_pending()) {gtk_main_iteration();}
 
         benchmark_dialog = g_new0(BenchmarkDialog, 1);
@@ -697,6 +1123,7 @@ static void do_benchmark(void (*benchmark_function)(void), int entry)
 	    }
 
 	    //if(!done) DEBUG("benchmark NOT done");
+            if(!done) bench_value_free(&benchmark_dialog->r);
             if(!done) if(watch_id) g_source_remove(watch_id);
             if(!done) kill(bench_pid, SIGINT);
 	    if(!done) params.aborting_benchmarks=1;
@@ -706,6 +1133,7 @@ static void do_benchmark(void (*benchmark_function)(void), int entry)
 	    //shell_view_set_enabled(TRUE);
             if(benchmark_dialog && benchmark_dialog->dialog) gtk_widget_destroy(benchmark_dialog->dialog);
             g_free(benchmark_dialog);
+            g_strfreev(argv);
 
             return;
         }
@@ -714,12 +1142,46 @@ static void do_benchmark(void (*benchmark_function)(void), int entry)
 	//gtk_widget_activate(GTK_WINDOW(shell_get_main_shell()->window));
         if(benchmark_dialog && benchmark_dialog->dialog) gtk_widget_destroy(benchmark_dialog->dialog);
         g_free(benchmark_dialog);
+        g_strfreev(argv);
         return;
     }
 
+    if (!placement_set) {
+        bench_placement_set(params.bench_pin);
+        placement_set = TRUE;
+    }
+    pool_runs = bench_pool_runs();
+
+    bench_value_free(&bench_results[entry]);
+    bench_results[entry] = (bench_value)EMPTY_BENCH_VALUE;
+
     setpriority(PRIO_PROCESS, 0, -20);
     benchmark_function();
     setpriority(PRIO_PROCESS, 0, old_priority);
+
+    /* the stats are in crunch counts, but benchmarks scale the result
+     * into their own units; this is only right for a multiple of the
+     * count, the others convert each run with
+     * benchmark_crunch_for_convert() and their result is the median */
+    result = &bench_results[entry];
+    if (result->stats.n > 1 && result->stats.median != 0 &&
+        result->result != result->stats.median)
+        bench_stats_scale(&result->stats, result->result / result->stats.median);
+
+    /* only results that ran on the pool were placed, and only those
+     * honour bench_threads_override */
+    if (bench_pool_runs() != pool_runs && !entries_pinned[entry]) {
+        gchar *pin = bench_placement_describe(bench_results[entry].threads_used);
+        if (pin)
+            bench_value_append_extra(&bench_results[entry], "%s", pin);
+        g_free(pin);
+
+        if (params.bench_sweep) {
+            setpriority(PRIO_PROCESS, 0, -20);
+            benchmark_sweep(benchmark_function, entry);
+            setpriority(PRIO_PROCESS, 0, old_priority);
+        }
+    }
 }
 
 gchar *hi_module_get_name(void) { return g_strdup(_("Benchmarks")); }
@@ -740,131 +1202,683 @@ const ModuleAbout *hi_module_get_about(void)
     return &ma;
 }
 
-static gchar *get_benchmark_results(gsize *len)
+#define ADD_JSON_VALUE(type, name, value)                                      \
+    do {                                                                       \
+        json_builder_set_member_name(builder, (name));                         \
+        json_builder_add_##type##_value(builder, (value));                     \
+    } while (0)
+
+/* machine members of every uploaded result */
+static void bench_json_add_machine(JsonBuilder *builder, const bench_machine *m)
+{
+    ADD_JSON_VALUE(string, "Board", m->board);
+    ADD_JSON_VALUE(int, "MemoryInKiB", m->memory_kiB);
+    ADD_JSON_VALUE(string, "CpuName", m->cpu_name);
+    ADD_JSON_VALUE(string, "CpuDesc", m->cpu_desc);
+    ADD_JSON_VALUE(string, "CpuConfig", m->cpu_config);
+    ADD_JSON_VALUE(string, "CpuConfig", m->cpu_config);
+    ADD_JSON_VALUE(string, "OpenGlRenderer", m->ogl_renderer);
+    ADD_JSON_VALUE(string, "GpuDesc", m->gpu_desc);
+    ADD_JSON_VALUE(int, "NumCpus", m->processors);
+    ADD_JSON_VALUE(int, "NumCores", m->cores);
+    ADD_JSON_VALUE(int, "NumNodes", m->nodes);
+    ADD_JSON_VALUE(int, "NumThreads", m->threads);
+    ADD_JSON_VALUE(string, "MachineId", m->mid);
+    ADD_JSON_VALUE(int, "PointerBits", m->ptr_bits);
+    ADD_JSON_VALUE(boolean, "DataFromSuperUser", m->is_su_data);
+    ADD_JSON_VALUE(int, "PhysicalMemoryInMiB", m->memory_phys_MiB);
+    ADD_JSON_VALUE(string, "MemoryTypes", m->ram_types);
+    ADD_JSON_VALUE(int, "MachineDataVersion", m->machine_data_version);
+    ADD_JSON_VALUE(string, "MachineType", m->machine_type);
+    ADD_JSON_VALUE(string, "LinuxKernel", m->linux_kernel);
+    ADD_JSON_VALUE(string, "LinuxOS", m->linux_os);
+}
+
+/* rows of cells, null where not measured */
+static void bench_json_add_matrix(JsonBuilder *builder, const bench_matrix *m,
+                                  const double v[BENCH_MATRIX_MAX][BENCH_MATRIX_MAX])
+{
+    gint i, j;
+
+    json_builder_begin_array(builder);
+    for (i = 0; i < m->n; i++) {
+        json_builder_begin_array(builder);
+        for (j = 0; j < m->n; j++) {
+            if (v[i][j] >= 0)
+                json_builder_add_double_value(builder, v[i][j]);
+            else
+                json_builder_add_null_value(builder);
+        }
+        json_builder_end_array(builder);
+    }
+    json_builder_end_array(builder);
+}
+
+/* result members, shared by the upload and -g json */
+static void bench_json_add_value(JsonBuilder *builder, const bench_value *r)
+{
+    ADD_JSON_VALUE(string, "ExtraInfo", r->extra);
+    ADD_JSON_VALUE(double, "BenchmarkResult", r->result);
+    ADD_JSON_VALUE(double, "ElapsedTime", r->elapsed_time);
+    ADD_JSON_VALUE(int, "UsedThreads", r->threads_used);
+    ADD_JSON_VALUE(int, "BenchmarkVersion", r->revision);
+    if (r->stats.n > 1) {
+        ADD_JSON_VALUE(int, "Repetitions", r->stats.n);
+        ADD_JSON_VALUE(double, "ResultMedian", r->stats.median);
+        ADD_JSON_VALUE(double, "ResultMean", r->stats.mean);
+        ADD_JSON_VALUE(double, "ResultStdDev", r->stats.stddev);
+        ADD_JSON_VALUE(double, "ResultMin", r->stats.min);
+        ADD_JSON_VALUE(double, "ResultMax", r->stats.max);
+        ADD_JSON_VALUE(double, "ResultCI95", r->stats.ci95);
+    }
+    if (r->scaling.n > 0) {
+        const bench_scaling *sc = &r->scaling;
+        gint step;
+
+        json_builder_set_member_name(builder, "ThreadScaling");
+        json_builder_begin_array(builder);
+        for (step = 0; step < sc->n; step++) {
+            json_builder_begin_object(builder);
+            ADD_JSON_VALUE(int, "Threads", sc->step[step].threads);
+            ADD_JSON_VALUE(double, "Result", sc->step[step].result);
+            ADD_JSON_VALUE(double, "Efficiency",
+                           bench_scaling_efficiency(sc, step));
+            json_builder_end_object(builder);
+        }
+        json_builder_end_array(builder);
+    }
+    if (r->latency.n > 0) {
+        const bench_latency *l = &r->latency;
+
+        /* nanoseconds */
+        json_builder_set_member_name(builder, "IterationLatency");
+        json_builder_begin_object(builder);
+        ADD_JSON_VALUE(int, "Samples", l->n);
+        ADD_JSON_VALUE(int, "P50", l->p50);
+        ADD_JSON_VALUE(int, "P90", l->p90);
+        ADD_JSON_VALUE(int, "P99", l->p99);
+        ADD_JSON_VALUE(int, "P999", l->p999);
+        ADD_JSON_VALUE(int, "Max", l->max);
+        json_builder_end_object(builder);
+    }
+    if (r->counters.mask) {
+        const bench_counters *c = &r->counters;
+        bench_perf_event e;
+
+        json_builder_set_member_name(builder, "PerfCounters");
+        json_builder_begin_object(builder);
+        for (e = 0; e < BENCH_PERF_N_EVENTS; e++) {
+            if (bench_counters_has(c, e))
+                ADD_JSON_VALUE(int, bench_perf_event_name(e), c->value[e]);
+        }
+        json_builder_end_object(builder);
+    }
+    if (r->thermal.samples > 0) {
+        const bench_thermal *th = &r->thermal;
+
+        json_builder_set_member_name(builder, "Telemetry");
+        json_builder_begin_object(builder);
+        ADD_JSON_VALUE(int, "Samples", th->samples);
+        if (th->mhz_max > 0) {
+            ADD_JSON_VALUE(double, "FreqMinMHz", th->mhz_min);
+            ADD_JSON_VALUE(double, "FreqAvgMHz", th->mhz_avg);
+            ADD_JSON_VALUE(double, "FreqMaxMHz", th->mhz_max);
+        }
+        if (th->has_temp)
+            ADD_JSON_VALUE(double, "TempMaxC", th->temp_max);
+        ADD_JSON_VALUE(boolean, "Throttled", th->throttled);
+        if (th->throttle_events >= 0)
+            ADD_JSON_VALUE(int, "ThrottleEvents", th->throttle_events);
+        json_builder_end_object(builder);
+    }
+    if (r->curve && r->curve->n > 0) {
+        const bench_curve *c = r->curve;
+        gint i;
+
+        json_builder_set_member_name(builder, "WorkingSetSweep");
+        json_builder_begin_array(builder);
+        for (i = 0; i < c->n; i++) {
+            json_builder_begin_object(builder);
+            ADD_JSON_VALUE(int, "Bytes", c->point[i].bytes);
+            ADD_JSON_VALUE(double, "Result", c->point[i].result);
+            json_builder_end_object(builder);
+        }
+        json_builder_end_array(builder);
+    }
+    if (r->matrix && r->matrix->n > 0) {
+        const bench_matrix *m = r->matrix;
+        gint i;
+
+        json_builder_set_member_name(builder, "Matrix");
+        json_builder_begin_object(builder);
+        ADD_JSON_VALUE(string, "Of", m->cpus ? "Cpus" : "NumaNodes");
+        json_builder_set_member_name(builder, "Ids");
+        json_builder_begin_array(builder);
+        for (i = 0; i < m->n; i++)
+            json_builder_add_int_value(builder, m->id[i]);
+        json_builder_end_array(builder);
+        if (bench_matrix_has_gbs(m)) {
+            json_builder_set_member_name(builder, "BandwidthGBs");
+            bench_json_add_matrix(builder, m, m->gbs);
+        }
+        if (bench_matrix_has_ns(m)) {
+            json_builder_set_member_name(builder, "LatencyNs");
+            bench_json_add_matrix(builder, m, m->ns);
+        }
+        json_builder_end_object(builder);
+    }
+}
+
+static gchar *bench_json_to_data(JsonBuilder *builder, gsize *len)
 {
-    void (*scan_callback)(gboolean);
-    JsonBuilder *builder;
     JsonGenerator *generator;
-    bench_machine *this_machine;
     gchar *out;
-    guint i;
 
-    for (i = 0; i < G_N_ELEMENTS(entries); i++) {
-        if (!entries[i].name || !entries[i].scan_callback)
-            continue;
-        if (entries[i].flags & MODULE_FLAG_HIDE)
-            continue;
+    generator = json_generator_new();
+    json_generator_set_root(generator, json_builder_get_root(builder));
+    json_generator_set_pretty(generator, TRUE);
 
-        scan_callback = entries[i].scan_callback;
-        if (scan_callback)
-            scan_callback(bench_results[i].result < 0.0);
-    }
+    out = json_generator_to_data(generator, len);
+
+    g_object_unref(generator);
+    return out;
+}
+
+/* the format sent to the server, one object per benchmark */
+static gchar *benchmark_results_upload_json(const gint *selected,
+                                            gint n_selected, gsize *len)
+{
+    JsonBuilder *builder;
+    bench_machine *this_machine;
+    gchar *out;
+    gint i;
 
     this_machine = bench_machine_this();
     builder = json_builder_new();
     json_builder_begin_object(builder);
-    for (i = 0; i < G_N_ELEMENTS(entries); i++) {
-        if (!entries[i].name || entries[i].flags & MODULE_FLAG_HIDE)
-            continue;
-        if (bench_results[i].result < 0.0) {
+    for (i = 0; i < n_selected; i++) {
+        if (bench_results[selected[i]].result < 0.0) {
             /* Benchmark failed? */
             continue;
         }
 
-        json_builder_set_member_name(builder, entries_english_name[i]);
+        json_builder_set_member_name(builder, entries_english_name[selected[i]]);
 
         json_builder_begin_object(builder);
-
-#define ADD_JSON_VALUE(type, name, value)                                      \
-    do {                                                                       \
-        json_builder_set_member_name(builder, (name));                         \
-        json_builder_add_##type##_value(builder, (value));                     \
-    } while (0)
-
-        ADD_JSON_VALUE(string, "Board", this_machine->board);
-        ADD_JSON_VALUE(int, "MemoryInKiB", this_machine->memory_kiB);
-        ADD_JSON_VALUE(string, "CpuName", this_machine->cpu_name);
-        ADD_JSON_VALUE(string, "CpuDesc", this_machine->cpu_desc);
-        ADD_JSON_VALUE(string, "CpuConfig", this_machine->cpu_config);
-        ADD_JSON_VALUE(string, "CpuConfig", this_machine->cpu_config);
-        ADD_JSON_VALUE(string, "OpenGlRenderer", this_machine->ogl_renderer);
-        ADD_JSON_VALUE(string, "GpuDesc", this_machine->gpu_desc);
-        ADD_JSON_VALUE(int, "NumCpus", this_machine->processors);
-        ADD_JSON_VALUE(int, "NumCores", this_machine->cores);
-        ADD_JSON_VALUE(int, "NumNodes", this_machine->nodes);
-        ADD_JSON_VALUE(int, "NumThreads", this_machine->threads);
-        ADD_JSON_VALUE(string, "MachineId", this_machine->mid);
-        ADD_JSON_VALUE(int, "PointerBits", this_machine->ptr_bits);
-        ADD_JSON_VALUE(boolean, "DataFromSuperUser", this_machine->is_su_data);
-        ADD_JSON_VALUE(int, "PhysicalMemoryInMiB",
-                       this_machine->memory_phys_MiB);
-        ADD_JSON_VALUE(string, "MemoryTypes", this_machine->ram_types);
-        ADD_JSON_VALUE(int, "MachineDataVersion",
-                       this_machine->machine_data_version);
-        ADD_JSON_VALUE(string, "MachineType", this_machine->machine_type);
-        ADD_JSON_VALUE(string, "LinuxKernel", this_machine->linux_kernel);
-        ADD_JSON_VALUE(string, "LinuxOS", this_machine->linux_os);
+        bench_json_add_machine(builder, this_machine);
         ADD_JSON_VALUE(boolean, "Legacy", FALSE);
-        ADD_JSON_VALUE(string, "ExtraInfo", bench_results[i].extra);
 	if(params.bench_user_note){
             ADD_JSON_VALUE(string, "UserNote", params.bench_user_note);
 	}else{
             ADD_JSON_VALUE(string, "UserNote", "");
 	}
-        ADD_JSON_VALUE(double, "BenchmarkResult", bench_results[i].result);
-        ADD_JSON_VALUE(double, "ElapsedTime", bench_results[i].elapsed_time);
-        ADD_JSON_VALUE(int, "UsedThreads", bench_results[i].threads_used);
-        ADD_JSON_VALUE(int, "BenchmarkVersion", bench_results[i].revision);
-
-#undef ADD_JSON_VALUE
+        bench_json_add_value(builder, &bench_results[selected[i]]);
 
         json_builder_end_object(builder);
     }
     json_builder_end_object(builder);
 
-    generator = json_generator_new();
-    json_generator_set_root(generator, json_builder_get_root(builder));
-    json_generator_set_pretty(generator, TRUE);
+    out = bench_json_to_data(builder, len);
 
-    out = json_generator_to_data(generator, len);
+    g_object_unref(builder);
+    bench_machine_free(this_machine);
+
+    return out;
+}
+
+static gchar *get_benchmark_results(gsize *len)
+{
+    void (*scan_callback)(gboolean);
+    gchar *out;
+    gint *queue, n_queued = 0;
+    guint i;
+
+    /* in the GUI, everything that still has to run goes to one child */
+    if (params.gui_running && !params.run_benchmark &&
+        !params.skip_benchmarks && !params.aborting_benchmarks) {
+        queue = g_new0(gint, G_N_ELEMENTS(entries));
+        for (i = 0; i < G_N_ELEMENTS(entries); i++) {
+            if (!entries[i].name || !entries[i].scan_callback)
+                continue;
+            if (entries[i].flags & (MODULE_FLAG_HIDE | MODULE_FLAG_NO_REPORT))
+                continue;
+            if (bench_results[i].result < 0.0)
+                queue[n_queued++] = i;
+        }
+        benchmark_run_batch(queue, n_queued);
+        g_free(queue);
+    }
+
+    for (i = 0; i < G_N_ELEMENTS(entries); i++) {
+        if (!entries[i].name || !entries[i].scan_callback)
+            continue;
+        if (entries[i].flags & (MODULE_FLAG_HIDE | MODULE_FLAG_NO_REPORT))
+            continue;
+
+        scan_callback = entries[i].scan_callback;
+        if (scan_callback)
+            scan_callback(bench_results[i].result < 0.0);
+    }
+    memset(bench_batch_done, 0, sizeof(bench_batch_done));
+
+    queue = g_new0(gint, G_N_ELEMENTS(entries));
+    n_queued = 0;
+    for (i = 0; i < G_N_ELEMENTS(entries); i++) {
+        if (entries[i].name && !(entries[i].flags & (MODULE_FLAG_HIDE | MODULE_FLAG_NO_REPORT)))
+            queue[n_queued++] = i;
+    }
+    out = benchmark_results_upload_json(queue, n_queued, len);
+    g_free(queue);
+
+    return out;
+}
+
+/* UTC, like 2026-01-31T12:00:00Z */
+static gchar *bench_timestamp(void)
+{
+    GDateTime *now = g_date_time_new_now_utc();
+    gchar *ret = g_date_time_format(now, "%Y-%m-%dT%H:%M:%SZ");
+
+    g_date_time_unref(now);
+    return ret;
+}
+
+/* -g json: the machine once, then every result that ran */
+static gchar *benchmark_results_json(const gint *selected, gint n_selected)
+{
+    JsonBuilder *builder;
+    bench_machine *this_machine;
+    gchar *out, *timestamp;
+    gint i;
+
+    this_machine = bench_machine_this();
+    timestamp = bench_timestamp();
+
+    builder = json_builder_new();
+    json_builder_begin_object(builder);
+    ADD_JSON_VALUE(string, "Timestamp", timestamp);
+    json_builder_set_member_name(builder, "Machine");
+    json_builder_begin_object(builder);
+    bench_json_add_machine(builder, this_machine);
+    json_builder_end_object(builder);
+
+    json_builder_set_member_name(builder, "Results");
+    json_builder_begin_array(builder);
+    for (i = 0; i < n_selected; i++) {
+        if (bench_results[selected[i]].result < 0.0)
+            continue;
+        json_builder_begin_object(builder);
+        ADD_JSON_VALUE(string, "Benchmark", entries_english_name[selected[i]]);
+        bench_json_add_value(builder, &bench_results[selected[i]]);
+        json_builder_end_object(builder);
+    }
+    json_builder_end_array(builder);
+    json_builder_end_object(builder);
+
+    out = bench_json_to_data(builder, NULL);
 
-    g_object_unref(generator);
     g_object_unref(builder);
     bench_machine_free(this_machine);
+    g_free(timestamp);
 
     return out;
 }
 
-static gchar *run_benchmark(gchar *name)
+#undef ADD_JSON_VALUE
+
+static void csv_add_str(GString *line, const gchar *value)
 {
-    int i;
-    //DEBUG("run_benchmark = %s", name);
-    for (i = 0; entries[i].name; i++) {
-        if (g_str_equal(entries[i].name, name)) {
-            void (*scan_callback)(gboolean rescan);
+    const gchar *p;
+
+    if (line->len)
+        g_string_append_c(line, ',');
+    if (!value)
+        return;
+    if (!strpbrk(value, ",\"\r\n")) {
+        g_string_append(line, value);
+        return;
+    }
+    g_string_append_c(line, '"');
+    for (p = value; *p; p++) {
+        if (*p == '"')
+            g_string_append_c(line, '"');
+        g_string_append_c(line, *p);
+    }
+    g_string_append_c(line, '"');
+}
+
+/* locale independent; nothing when !valid */
+static void csv_add_double(GString *line, double value, gboolean valid)
+{
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+    csv_add_str(line, valid ? g_ascii_formatd(buf, sizeof(buf), "%.6g", value)
+                            : NULL);
+}
+
+static void csv_add_int(GString *line, gint64 value, gboolean valid)
+{
+    gchar buf[24];
+
+    g_snprintf(buf, sizeof(buf), "%" G_GINT64_FORMAT, value);
+    csv_add_str(line, valid ? buf : NULL);
+}
+
+/* -g csv: one row per result, with the machine repeated in each */
+static gchar *benchmark_results_csv(const gint *selected, gint n_selected)
+{
+    static const gchar *header =
+        "Timestamp,MachineId,Board,CpuName,CpuConfig,NumCpus,NumCores,"
+        "NumThreads,NumNodes,MemoryInKiB,LinuxKernel,LinuxOS,Benchmark,"
+        "BenchmarkVersion,BenchmarkResult,ElapsedTime,UsedThreads,Repetitions,"
+        "ResultMedian,ResultStdDev,ResultCI95,FreqMinMHz,FreqAvgMHz,"
+        "FreqMaxMHz,TempMaxC,Throttled,ExtraInfo";
+    GString *out = g_string_new(header), *line = g_string_new(NULL);
+    bench_machine *this_machine;
+    gchar *timestamp;
+    gint i;
 
-            if ((scan_callback = entries[i].scan_callback)) {
-                scan_callback(FALSE);
+    this_machine = bench_machine_this();
+    timestamp = bench_timestamp();
+
+    for (i = 0; i < n_selected; i++) {
+        const bench_value *r = &bench_results[selected[i]];
+        gboolean has_stats = (r->stats.n > 1);
+        gboolean has_mhz = (r->thermal.samples > 0 && r->thermal.mhz_max > 0);
+
+        if (r->result < 0.0)
+            continue;
+
+        g_string_truncate(line, 0);
+        csv_add_str(line, timestamp);
+        csv_add_str(line, this_machine->mid);
+        csv_add_str(line, this_machine->board);
+        csv_add_str(line, this_machine->cpu_name);
+        csv_add_str(line, this_machine->cpu_config);
+        csv_add_int(line, this_machine->processors, TRUE);
+        csv_add_int(line, this_machine->cores, TRUE);
+        csv_add_int(line, this_machine->threads, TRUE);
+        csv_add_int(line, this_machine->nodes, TRUE);
+        csv_add_int(line, this_machine->memory_kiB, TRUE);
+        csv_add_str(line, this_machine->linux_kernel);
+        csv_add_str(line, this_machine->linux_os);
+        csv_add_str(line, entries_english_name[selected[i]]);
+        csv_add_int(line, r->revision, r->revision >= 0);
+        csv_add_double(line, r->result, TRUE);
+        csv_add_double(line, r->elapsed_time, TRUE);
+        csv_add_int(line, r->threads_used, TRUE);
+        csv_add_int(line, MAX(r->stats.n, 1), TRUE);
+        csv_add_double(line, r->stats.median, has_stats);
+        csv_add_double(line, r->stats.stddev, has_stats);
+        csv_add_double(line, r->stats.ci95, has_stats);
+        csv_add_double(line, r->thermal.mhz_min, has_mhz);
+        csv_add_double(line, r->thermal.mhz_avg, has_mhz);
+        csv_add_double(line, r->thermal.mhz_max, has_mhz);
+        csv_add_double(line, r->thermal.temp_max,
+                       r->thermal.samples > 0 && r->thermal.has_temp);
+        csv_add_int(line, r->thermal.throttled, r->thermal.samples > 0);
+        csv_add_str(line, r->extra);
+
+        g_string_append_printf(out, "\n%s", line->str);
+    }
+
+    g_string_free(line, TRUE);
+    bench_machine_free(this_machine);
+    g_free(timestamp);
+
+    return g_string_free(out, FALSE);
+}
+
+/* results without repetitions compare as a single sample */
+static bench_stats bench_value_stats(const bench_value *r)
+{
+    bench_stats s = { 0 };
+
+    if (r->stats.n > 1)
+        return r->stats;
+    s.n = 1;
+    s.median = s.mean = s.min = s.max = r->result;
+    return s;
+}
+
+/* the baseline entry for benchmark, from a file written by
+ * --bench-save-baseline or one in the server's format */
+static bench_result *baseline_find(JsonObject *results, const gchar *benchmark)
+{
+    JsonNode *node;
+    JsonArray *machines;
+
+    if (!json_object_has_member(results, benchmark))
+        return NULL;
+    node = json_object_get_member(results, benchmark);
+    if (JSON_NODE_HOLDS_ARRAY(node)) {
+        machines = json_node_get_array(node);
+        if (!machines || json_array_get_length(machines) < 1)
+            return NULL;
+        node = json_array_get_element(machines, 0);
+    }
+    return bench_result_benchmarkjson(benchmark, node);
+}
+
+/* --bench-baseline: one verdict line per benchmark that ran; sets
+ * params.bench_regressed when any is slower */
+static gchar *benchmark_compare_baseline(const gint *selected, gint n_selected)
+{
+    JsonParser *parser;
+    JsonNode *root;
+    GError *error = NULL;
+    GString *out;
+    gint i;
+
+    parser = json_parser_new();
+    json_parser_load_from_file(parser, params.bench_baseline, &error);
+    if (error) {
+        out = g_string_new(NULL);
+        g_string_printf(out, _("Unable to read baseline %s: %s\n"),
+                        params.bench_baseline, error->message);
+        g_error_free(error);
+        g_object_unref(parser);
+        params.bench_regressed = TRUE;
+        return g_string_free(out, FALSE);
+    }
+
+    root = json_parser_get_root(parser);
+    if (!root || json_node_get_node_type(root) != JSON_NODE_OBJECT) {
+        g_object_unref(parser);
+        params.bench_regressed = TRUE;
+        return g_strdup_printf(_("Unable to read baseline %s\n"),
+                               params.bench_baseline);
+    }
+
+    out = g_string_new(NULL);
+    g_string_append_printf(out, _("Compared with %s (threshold %0.1f%%):\n"),
+                           params.bench_baseline, params.bench_threshold);
+    for (i = 0; i < n_selected; i++) {
+        const gchar *name = entries_english_name[selected[i]];
+        const bench_value *r = &bench_results[selected[i]];
+        bench_stats base_stats, run_stats;
+        bench_verdict verdict;
+        bench_result *base;
+        double change;
+        gboolean tested;
+
+        if (r->result < 0.0)
+            continue;
+        base = baseline_find(json_node_get_object(root), name);
+        if (!base) {
+            g_string_append_printf(out, "%s\t%s\n", name, _("not in baseline"));
+            continue;
+        }
+
+        base_stats = bench_value_stats(&base->bvalue);
+        run_stats = bench_value_stats(r);
+        verdict = bench_stats_compare(&base_stats, &run_stats,
+                                      entries_lower_is_better[selected[i]],
+                                      params.bench_threshold, &change, &tested);
+        if (verdict == BENCH_VERDICT_SLOWER)
+            params.bench_regressed = TRUE;
+
+        g_string_append_printf(out, "%s\t%0.2f -> %0.2f\t%+0.1f%%\t%s%s%s\n",
+            name, base_stats.median, run_stats.median, change,
+            verdict == BENCH_VERDICT_FASTER ? _("faster") :
+            verdict == BENCH_VERDICT_SLOWER ? _("slower") : _("within noise"),
+            tested ? "" : _(" (not tested, needs --bench-repeat 2 or more)"),
+            base->bvalue.revision != r->revision ? _(" (revision differs)") : "");
+        bench_result_free(base);
+    }
+    g_object_unref(parser);
+
+    return g_string_free(out, FALSE);
+}
 
 #define CHK_RESULT_FORMAT(F)                                                   \
     (params.result_format && strcmp(params.result_format, F) == 0)
 
-                if (params.run_benchmark) {
-                    if (CHK_RESULT_FORMAT("shell")) {
-                        bench_result *b =
-                            bench_result_this_machine(name, bench_results[i]);
-                        char *temp = bench_result_more_info_complete(b);
-                        bench_result_free(b);
-                        return temp;
-                    }
-                    /* defaults to "short" which is below */
-                }
-
-                return bench_value_to_str(bench_results[i]);
+/* Fills selected with the entries named in list, a comma separated list
+ * of benchmark names and patterns ('*' and '?'); "all" is the same as
+ * "*". Patterns skip the hidden variants, the entries left out of
+ * reports and GPU Drawing, which would need a display; those run only
+ * when named. Returns how many. */
+static gint benchmark_select(const gchar *list, gint *selected)
+{
+    gboolean picked[G_N_ELEMENTS(entries)] = { FALSE };
+    gchar **names;
+    gint i, j, n = 0;
+
+    names = g_strsplit(list, ",", -1);
+    for (j = 0; names[j]; j++) {
+        GPatternSpec *pattern;
+        gboolean found = FALSE;
+
+        g_strstrip(names[j]);
+        if (!*names[j])
+            continue;
+
+        for (i = 0; entries[i].name; i++) {
+            if (entries[i].scan_callback && g_str_equal(entries[i].name, names[j])) {
+                picked[i] = found = TRUE;
+                break;
             }
         }
+        if (found)
+            continue;
+
+        if (g_str_equal(names[j], "all"))
+            pattern = g_pattern_spec_new("*");
+        else if (strpbrk(names[j], "*?"))
+            pattern = g_pattern_spec_new(names[j]);
+        else
+            pattern = NULL;
+        for (i = 0; pattern && entries[i].name; i++) {
+            if (!entries[i].scan_callback || i == BENCHMARK_GUI ||
+                entries[i].flags & (MODULE_FLAG_HIDE | MODULE_FLAG_NO_REPORT))
+                continue;
+            if (g_pattern_match_string(pattern, entries[i].name))
+                picked[i] = found = TRUE;
+        }
+        if (pattern)
+            g_pattern_spec_free(pattern);
+
+        if (!found)
+            fprintf(stderr, _("Unknown benchmark ``%s''\n"), names[j]);
     }
-    return NULL;
+    g_strfreev(names);
+
+    for (i = 0; entries[i].name; i++) {
+        if (picked[i])
+            selected[n++] = i;
+    }
+    return n;
+}
+
+static gchar *run_benchmark_entry(gint i)
+{
+    void (*scan_callback)(gboolean rescan) = entries[i].scan_callback;
+
+    scan_callback(FALSE);
+
+    /* batch records are one line each */
+    if (params.run_benchmark && !params.bench_batch) {
+        if (CHK_RESULT_FORMAT("shell")) {
+            bench_result *b =
+                bench_result_this_machine(entries[i].name, bench_results[i]);
+            char *temp = bench_result_more_info_complete(b);
+            bench_result_free(b);
+            return temp;
+        }
+        /* defaults to "short" which is below */
+    }
+
+    return bench_value_to_str(bench_results[i]);
+}
+
+/* name is a list of benchmarks, see benchmark_select(). With -g json or
+ * csv, all results come out together at the end. Otherwise, with
+ * --bench-batch or more than one benchmark, a "name<TAB>result" line is
+ * written as soon as each one finishes. The baseline comparison, if
+ * any, comes last. */
+static gchar *run_benchmark(gchar *name)
+{
+    void (*scan_callback)(gboolean rescan);
+    gint *selected, n_selected, i;
+    gchar *result;
+
+    selected = g_new0(gint, G_N_ELEMENTS(entries));
+    n_selected = benchmark_select(name, selected);
+    if (!n_selected) {
+        g_free(selected);
+        return NULL;
+    }
+
+    if (CHK_RESULT_FORMAT("json") || CHK_RESULT_FORMAT("csv")) {
+        for (i = 0; i < n_selected && !params.aborting_benchmarks; i++) {
+            scan_callback = entries[selected[i]].scan_callback;
+            scan_callback(FALSE);
+        }
+        result = CHK_RESULT_FORMAT("json")
+                     ? benchmark_results_json(selected, n_selected)
+                     : benchmark_results_csv(selected, n_selected);
+    } else if (params.bench_batch || n_selected > 1) {
+        for (i = 0; i < n_selected; i++) {
+            result = run_benchmark_entry(selected[i]);
+            fprintf(stdout, "%s\t%s\n", entries[selected[i]].name, result);
+            fflush(stdout);
+            g_free(result);
+        }
+        /* hardinfo2 prints this after the records */
+        result = g_strdup("");
+    } else {
+        result = run_benchmark_entry(selected[0]);
+    }
+
+    if (params.bench_save_baseline) {
+        gchar *json = benchmark_results_upload_json(selected, n_selected, NULL);
+        GError *error = NULL;
+
+        if (!g_file_set_contents(params.bench_save_baseline, json, -1, &error)) {
+            fprintf(stderr, _("Unable to save baseline %s: %s\n"),
+                    params.bench_save_baseline, error->message);
+            g_error_free(error);
+        }
+        g_free(json);
+    }
+
+    /* keeps json and csv on stdout parseable */
+    if (params.bench_baseline) {
+        gchar *report = benchmark_compare_baseline(selected, n_selected);
+
+        if (CHK_RESULT_FORMAT("json") || CHK_RESULT_FORMAT("csv")) {
+            fprintf(stderr, "%s", report);
+        } else {
+            gchar *tmp = result;
+            result = g_strconcat(tmp, *tmp ? "\n" : "", report, NULL);
+            g_free(tmp);
+        }
+        g_free(report);
+    }
+
+    g_free(selected);
+    return result;
 }
 
 const ShellModuleMethod *hi_exported_methods(void)
@@ -877,6 +1891,11 @@ const ShellModuleMethod *hi_exported_methods(void)
     return m;
 }
 
+void hi_module_deinit(void)
+{
+    bench_pool_shutdown();
+}
+
 void hi_module_init(void)
 {
     static SyncEntry se[] = {
@@ -0,0 +1,772 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* AES-128 and AES-256 bulk encryption in CTR and GCM, in GB/s, with
+ * the instructions the cpu has for it: AES-NI and PCLMULQDQ, or VAES
+ * for the cipher, on x86-64; the crypto extensions on AArch64; lookup
+ * tables everywhere.
+ *
+ * Every worker encrypts the same AES_BUFFER bytes into a buffer of its
+ * own, like a TLS record or a disk sector run. GCM is the CTR pass and
+ * then the GHASH pass over the ciphertext, which is still in L1. Each
+ * implementation is checked with known answers and against the tables
+ * before it runs; the one used is the last of aes_impls that passes
+ * and that the cpu flags allow.
+ *
+ * The result is the AES-128-GCM GB/s; the extra has both modes and key
+ * sizes. */
+
+/* if anything changes in this block, increment revision */
+#define BENCH_REVISION 1
+#define AES_SECONDS 1.5 /* per mode and key size */
+#define AES_BUFFER (16 << 10)
+
+typedef struct {
+    guint32 w[60];          /* round keys, words as in FIPS-197 */
+    guchar rk[15][16];      /* the same, bytes */
+    gint rounds;
+    guint64 hl[16], hh[16]; /* GHASH, 4 bits at a time */
+    guchar hpow[4][16];     /* H, H^2, H^3, H^4 */
+} AesKey;
+
+typedef struct {
+    const gchar *name;
+    const gchar *flags; /* all needed, as in /proc/cpuinfo */
+    /* len is a multiple of 16; the last 32 bits of ctr count, big-endian */
+    void (*ctr)(const AesKey *k, const guchar *ctr, const guchar *in,
+                guchar *out, gsize len);
+    /* x = (x ^ block) * H for every block */
+    void (*ghash)(const AesKey *k, guchar *x, const guchar *in, gsize len);
+} AesImpl;
+
+typedef struct {
+    const AesImpl *impl;
+    const AesKey *key;
+    gboolean gcm;
+    const guchar *in;
+    guchar *out; /* AES_BUFFER per thread */
+} AesData;
+
+static guchar aes_sbox[256];
+static guint32 aes_te[4][256];
+
+#define ROTL8(x, n) ((guchar)(((x) << (n)) | ((x) >> (8 - (n)))))
+#define XTIME(x) ((guchar)(((x) << 1) ^ ((x) & 0x80 ? 0x1b : 0)))
+
+static guint32 load_be32(const guchar *p)
+{
+    return (guint32)p[0] << 24 | (guint32)p[1] << 16 | (guint32)p[2] << 8 | p[3];
+}
+
+static void store_be32(guchar *p, guint32 v)
+{
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+/* the S-box from the multiplicative inverse, and the round tables */
+static void aes_tables_init(void)
+{
+    guchar p = 1, q = 1, s;
+    guint32 t;
+    gint i;
+
+    do {
+        p = p ^ XTIME(p);
+        q ^= q << 1;
+        q ^= q << 2;
+        q ^= q << 4;
+        if (q & 0x80)
+            q ^= 0x09;
+        aes_sbox[p] = q ^ ROTL8(q, 1) ^ ROTL8(q, 2) ^ ROTL8(q, 3) ^ ROTL8(q, 4) ^ 0x63;
+    } while (p != 1);
+    aes_sbox[0] = 0x63;
+
+    for (i = 0; i < 256; i++) {
+        s = aes_sbox[i];
+        t = (guint32)XTIME(s) << 24 | (guint32)s << 16 | (guint32)s << 8 |
+            (guchar)(XTIME(s) ^ s);
+        aes_te[0][i] = t;
+        aes_te[1][i] = t >> 8 | t << 24;
+        aes_te[2][i] = t >> 16 | t << 16;
+        aes_te[3][i] = t >> 24 | t << 8;
+    }
+}
+
+static void aes_encrypt_c(const AesKey *k, const guchar *in, guchar *out)
+{
+    const guint32 *w = k->w;
+    guint32 s0, s1, s2, s3, t0, t1, t2, t3;
+    gint r;
+
+    s0 = load_be32(in) ^ w[0];
+    s1 = load_be32(in + 4) ^ w[1];
+    s2 = load_be32(in + 8) ^ w[2];
+    s3 = load_be32(in + 12) ^ w[3];
+    for (r = 1; r < k->rounds; r++) {
+        w += 4;
+        t0 = aes_te[0][s0 >> 24] ^ aes_te[1][(s1 >> 16) & 0xff] ^
+             aes_te[2][(s2 >> 8) & 0xff] ^ aes_te[3][s3 & 0xff] ^ w[0];
+        t1 = aes_te[0][s1 >> 24] ^ aes_te[1][(s2 >> 16) & 0xff] ^
+             aes_te[2][(s3 >> 8) & 0xff] ^ aes_te[3][s0 & 0xff] ^ w[1];
+        t2 = aes_te[0][s2 >> 24] ^ aes_te[1][(s3 >> 16) & 0xff] ^
+             aes_te[2][(s0 >> 8) & 0xff] ^ aes_te[3][s1 & 0xff] ^ w[2];
+        t3 = aes_te[0][s3 >> 24] ^ aes_te[1][(s0 >> 16) & 0xff] ^
+             aes_te[2][(s1 >> 8) & 0xff] ^ aes_te[3][s2 & 0xff] ^ w[3];
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+    }
+    w += 4;
+#define AES_LAST(a, b, c, d) \
+    ((guint32)aes_sbox[(a) >> 24] << 24 | (guint32)aes_sbox[((b) >> 16) & 0xff] << 16 | \
+     (guint32)aes_sbox[((c) >> 8) & 0xff] << 8 | aes_sbox[(d) & 0xff])
+    store_be32(out, AES_LAST(s0, s1, s2, s3) ^ w[0]);
+    store_be32(out + 4, AES_LAST(s1, s2, s3, s0) ^ w[1]);
+    store_be32(out + 8, AES_LAST(s2, s3, s0, s1) ^ w[2]);
+    store_be32(out + 12, AES_LAST(s3, s0, s1, s2) ^ w[3]);
+#undef AES_LAST
+}
+
+/* the multiplication of the GCM spec, bit by bit; for the key setup */
+static void gf128_mul(const guchar *x, const guchar *y, guchar *out)
+{
+    guchar z[16] = { 0 }, v[16], lsb;
+    gint i, j;
+
+    memcpy(v, y, 16);
+    for (i = 0; i < 128; i++) {
+        if (x[i / 8] & (0x80 >> (i % 8))) {
+            for (j = 0; j < 16; j++)
+                z[j] ^= v[j];
+        }
+        lsb = v[15] & 1;
+        for (j = 15; j > 0; j--)
+            v[j] = v[j] >> 1 | v[j - 1] << 7;
+        v[0] >>= 1;
+        if (lsb)
+            v[0] ^= 0xe1;
+    }
+    memcpy(out, z, 16);
+}
+
+static void aes_key_init(AesKey *k, const guchar *key, gint bits)
+{
+    static const guchar zero[16];
+    gint nk = bits / 32, i;
+    guint32 t, rcon = 1;
+    guchar h[16];
+    guint64 vh, vl;
+
+    k->rounds = nk + 6;
+    for (i = 0; i < nk; i++)
+        k->w[i] = load_be32(key + 4 * i);
+    for (i = nk; i < 4 * (k->rounds + 1); i++) {
+        t = k->w[i - 1];
+        if (i % nk == 0) {
+            t = t << 8 | t >> 24;
+            t = (guint32)aes_sbox[t >> 24] << 24 | (guint32)aes_sbox[(t >> 16) & 0xff] << 16 |
+                (guint32)aes_sbox[(t >> 8) & 0xff] << 8 | aes_sbox[t & 0xff];
+            t ^= rcon << 24;
+            rcon = XTIME(rcon);
+        } else if (nk > 6 && i % nk == 4) {
+            t = (guint32)aes_sbox[t >> 24] << 24 | (guint32)aes_sbox[(t >> 16) & 0xff] << 16 |
+                (guint32)aes_sbox[(t >> 8) & 0xff] << 8 | aes_sbox[t & 0xff];
+        }
+        k->w[i] = k->w[i - nk] ^ t;
+    }
+    for (i = 0; i < 4 * (k->rounds + 1); i++)
+        store_be32(k->rk[i / 4] + 4 * (i % 4), k->w[i]);
+
+    aes_encrypt_c(k, zero, h);
+
+    /* Shoup's tables: hh:hl[n] is H times the 4 bits of n */
+    vh = (guint64)load_be32(h) << 32 | load_be32(h + 4);
+    vl = (guint64)load_be32(h + 8) << 32 | load_be32(h + 12);
+    k->hl[0] = k->hh[0] = 0;
+    k->hl[8] = vl;
+    k->hh[8] = vh;
+    for (i = 4; i > 0; i >>= 1) {
+        t = (vl & 1) * 0xe1000000U;
+        vl = vh << 63 | vl >> 1;
+        vh = vh >> 1 ^ (guint64)t << 32;
+        k->hl[i] = vl;
+        k->hh[i] = vh;
+    }
+    for (i = 2; i <= 8; i *= 2) {
+        gint j;
+        for (j = 1; j < i; j++) {
+            k->hh[i + j] = k->hh[i] ^ k->hh[j];
+            k->hl[i + j] = k->hl[i] ^ k->hl[j];
+        }
+    }
+
+    memcpy(k->hpow[0], h, 16);
+    for (i = 1; i < 4; i++)
+        gf128_mul(k->hpow[i - 1], h, k->hpow[i]);
+}
+
+static void aes_ctr_c(const AesKey *k, const guchar *ctr, const guchar *in,
+                      guchar *out, gsize len)
+{
+    guchar cb[16], ks[16];
+    guint32 c = load_be32(ctr + 12);
+    guint64 a, b;
+    gsize i;
+
+    memcpy(cb, ctr, 12);
+    for (i = 0; i < len; i += 16) {
+        store_be32(cb + 12, c++);
+        aes_encrypt_c(k, cb, ks);
+        memcpy(&a, in + i, 8);
+        memcpy(&b, ks, 8);
+        a ^= b;
+        memcpy(out + i, &a, 8);
+        memcpy(&a, in + i + 8, 8);
+        memcpy(&b, ks + 8, 8);
+        a ^= b;
+        memcpy(out + i + 8, &a, 8);
+    }
+}
+
+static const guint64 ghash_last4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0,
+};
+
+static void ghash_c(const AesKey *k, guchar *x, const guchar *in, gsize len)
+{
+    guint64 zh, zl;
+    guchar b, lo, hi, rem;
+    gsize n;
+    gint i;
+
+    for (n = 0; n < len; n += 16) {
+        for (i = 0; i < 16; i++)
+            x[i] ^= in[n + i];
+
+        lo = x[15] & 0xf;
+        zh = k->hh[lo];
+        zl = k->hl[lo];
+        for (i = 15; i >= 0; i--) {
+            b = x[i];
+            lo = b & 0xf;
+            hi = b >> 4;
+            if (i != 15) {
+                rem = zl & 0xf;
+                zl = zh << 60 | zl >> 4;
+                zh = zh >> 4 ^ ghash_last4[rem] << 48;
+                zh ^= k->hh[lo];
+                zl ^= k->hl[lo];
+            }
+            rem = zl & 0xf;
+            zl = zh << 60 | zl >> 4;
+            zh = zh >> 4 ^ ghash_last4[rem] << 48;
+            zh ^= k->hh[hi];
+            zl ^= k->hl[hi];
+        }
+        store_be32(x, zh >> 32);
+        store_be32(x + 4, zh);
+        store_be32(x + 8, zl >> 32);
+        store_be32(x + 12, zl);
+    }
+}
+
+#if defined(__x86_64__)
+#define AESNI __attribute__((target("aes,pclmul,sse4.1")))
+#define VAES __attribute__((target("vaes,avx512f,avx512bw,aes,pclmul,sse4.1")))
+#define AES_BSWAP _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)
+
+static AESNI void aes_ctr_aesni(const AesKey *k, const guchar *ctr,
+                                const guchar *in, guchar *out, gsize len)
+{
+    const __m128i bswap = AES_BSWAP;
+    __m128i c = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)ctr), bswap);
+    __m128i b[8];
+    gsize i;
+    gint j, r;
+
+    /* eight blocks at a time: aesenc can start every cycle, and takes
+     * about four */
+    for (i = 0; i + 128 <= len; i += 128) {
+#pragma GCC unroll 8
+        for (j = 0; j < 8; j++)
+            b[j] = _mm_xor_si128(_mm_shuffle_epi8(_mm_add_epi32(c, _mm_set_epi32(0, 0, 0, j)),
+                                                  bswap),
+                                 _mm_loadu_si128((const __m128i *)k->rk[0]));
+        c = _mm_add_epi32(c, _mm_set_epi32(0, 0, 0, 8));
+        for (r = 1; r < k->rounds; r++) {
+            __m128i rk = _mm_loadu_si128((const __m128i *)k->rk[r]);
+#pragma GCC unroll 8
+            for (j = 0; j < 8; j++)
+                b[j] = _mm_aesenc_si128(b[j], rk);
+        }
+#pragma GCC unroll 8
+        for (j = 0; j < 8; j++) {
+            b[j] = _mm_aesenclast_si128(b[j], _mm_loadu_si128((const __m128i *)k->rk[k->rounds]));
+            _mm_storeu_si128((__m128i *)(out + i + 16 * j),
+                             _mm_xor_si128(b[j], _mm_loadu_si128((const __m128i *)(in + i + 16 * j))));
+        }
+    }
+    for (; i < len; i += 16) {
+        b[0] = _mm_xor_si128(_mm_shuffle_epi8(c, bswap),
+                             _mm_loadu_si128((const __m128i *)k->rk[0]));
+        c = _mm_add_epi32(c, _mm_set_epi32(0, 0, 0, 1));
+        for (r = 1; r < k->rounds; r++)
+            b[0] = _mm_aesenc_si128(b[0], _mm_loadu_si128((const __m128i *)k->rk[r]));
+        b[0] = _mm_aesenclast_si128(b[0], _mm_loadu_si128((const __m128i *)k->rk[k->rounds]));
+        _mm_storeu_si128((__m128i *)(out + i),
+                         _mm_xor_si128(b[0], _mm_loadu_si128((const __m128i *)(in + i))));
+    }
+}
+
+static VAES void aes_ctr_vaes(const AesKey *k, const guchar *ctr,
+                              const guchar *in, guchar *out, gsize len)
+{
+    const __m512i bswap = _mm512_broadcast_i32x4(AES_BSWAP);
+    const __m512i four = _mm512_broadcast_i32x4(_mm_set_epi32(0, 0, 0, 4));
+    __m512i rk[15], c, b[4];
+    guchar cb[16];
+    gsize i;
+    gint j, r;
+
+    /* four blocks in each register, the counters 0 to 3 apart */
+    c = _mm512_broadcast_i32x4(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)ctr),
+                                                AES_BSWAP));
+    c = _mm512_add_epi32(c, _mm512_set_epi32(0, 0, 0, 3, 0, 0, 0, 2,
+                                             0, 0, 0, 1, 0, 0, 0, 0));
+    for (r = 0; r <= k->rounds; r++)
+        rk[r] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)k->rk[r]));
+
+    for (i = 0; i + 256 <= len; i += 256) {
+#pragma GCC unroll 4
+        for (j = 0; j < 4; j++) {
+            b[j] = _mm512_xor_si512(_mm512_shuffle_epi8(c, bswap), rk[0]);
+            c = _mm512_add_epi32(c, four);
+        }
+        for (r = 1; r < k->rounds; r++) {
+#pragma GCC unroll 4
+            for (j = 0; j < 4; j++)
+                b[j] = _mm512_aesenc_epi128(b[j], rk[r]);
+        }
+#pragma GCC unroll 4
+        for (j = 0; j < 4; j++) {
+            b[j] = _mm512_aesenclast_epi128(b[j], rk[k->rounds]);
+            _mm512_storeu_si512(out + i + 64 * j,
+                                _mm512_xor_si512(b[j], _mm512_loadu_si512(in + i + 64 * j)));
+        }
+    }
+    if (i < len) {
+        memcpy(cb, ctr, 12);
+        store_be32(cb + 12, load_be32(ctr + 12) + i / 16);
+        aes_ctr_aesni(k, cb, in + i, out + i, len - i);
+    }
+}
+
+static inline AESNI __attribute__((always_inline))
+void clmul_acc(__m128i a, __m128i b, __m128i *lo, __m128i *mid, __m128i *hi)
+{
+    *lo = _mm_xor_si128(*lo, _mm_clmulepi64_si128(a, b, 0x00));
+    *hi = _mm_xor_si128(*hi, _mm_clmulepi64_si128(a, b, 0x11));
+    *mid = _mm_xor_si128(*mid, _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10),
+                                             _mm_clmulepi64_si128(a, b, 0x01)));
+}
+
+/* the 256 bit product, shifted a bit left for the reflected bit order,
+ * modulo x^128 + x^7 + x^2 + x + 1; it is linear, so the sum of several
+ * products needs only one */
+static inline AESNI __attribute__((always_inline))
+__m128i ghash_reduce(__m128i lo, __m128i mid, __m128i hi)
+{
+    __m128i t2, t4, t5, t7, t8, t9;
+
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    t7 = _mm_srli_epi32(lo, 31);
+    t8 = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    t9 = _mm_srli_si128(t7, 12);
+    t8 = _mm_slli_si128(t8, 4);
+    t7 = _mm_slli_si128(t7, 4);
+    lo = _mm_or_si128(lo, t7);
+    hi = _mm_or_si128(_mm_or_si128(hi, t8), t9);
+
+    t7 = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)),
+                       _mm_slli_epi32(lo, 25));
+    t8 = _mm_srli_si128(t7, 4);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(t7, 12));
+    t2 = _mm_srli_epi32(lo, 1);
+    t4 = _mm_srli_epi32(lo, 2);
+    t5 = _mm_srli_epi32(lo, 7);
+    t2 = _mm_xor_si128(_mm_xor_si128(t2, t4), _mm_xor_si128(t5, t8));
+    return _mm_xor_si128(hi, _mm_xor_si128(lo, t2));
+}
+
+static AESNI void ghash_clmul(const AesKey *k, guchar *x, const guchar *in, gsize len)
+{
+    const __m128i bswap = AES_BSWAP;
+    __m128i h[4], xv, lo, mid, hi;
+    gsize i;
+    gint j;
+
+    for (j = 0; j < 4; j++)
+        h[j] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)k->hpow[j]), bswap);
+    xv = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)x), bswap);
+
+    /* four blocks for one reduction: x1 H^4 + x2 H^3 + x3 H^2 + x4 H */
+    for (i = 0; i + 64 <= len; i += 64) {
+        lo = mid = hi = _mm_setzero_si128();
+#pragma GCC unroll 4
+        for (j = 0; j < 4; j++) {
+            __m128i b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(in + i + 16 * j)),
+                                         bswap);
+            clmul_acc(j ? b : _mm_xor_si128(xv, b), h[3 - j], &lo, &mid, &hi);
+        }
+        xv = ghash_reduce(lo, mid, hi);
+    }
+    for (; i < len; i += 16) {
+        lo = mid = hi = _mm_setzero_si128();
+        clmul_acc(_mm_xor_si128(xv, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(in + i)),
+                                                     bswap)),
+                  h[0], &lo, &mid, &hi);
+        xv = ghash_reduce(lo, mid, hi);
+    }
+    _mm_storeu_si128((__m128i *)x, _mm_shuffle_epi8(xv, bswap));
+}
+#elif defined(__aarch64__)
+#define AES_ARM __attribute__((target("+crypto")))
+
+static AES_ARM void aes_ctr_arm(const AesKey *k, const guchar *ctr,
+                                const guchar *in, guchar *out, gsize len)
+{
+    uint8x16_t rk[15], b[4];
+    guchar cb[4][16];
+    guint32 c = load_be32(ctr + 12);
+    gsize i;
+    gint j, r;
+
+    for (r = 0; r <= k->rounds; r++)
+        rk[r] = vld1q_u8(k->rk[r]);
+    for (j = 0; j < 4; j++)
+        memcpy(cb[j], ctr, 12);
+
+    /* aese and aesmc fuse; four blocks keep them busy */
+    for (i = 0; i + 64 <= len; i += 64) {
+#pragma GCC unroll 4
+        for (j = 0; j < 4; j++) {
+            store_be32(cb[j] + 12, c++);
+            b[j] = vld1q_u8(cb[j]);
+        }
+        for (r = 0; r < k->rounds - 1; r++) {
+#pragma GCC unroll 4
+            for (j = 0; j < 4; j++)
+                b[j] = vaesmcq_u8(vaeseq_u8(b[j], rk[r]));
+        }
+#pragma GCC unroll 4
+        for (j = 0; j < 4; j++) {
+            b[j] = veorq_u8(vaeseq_u8(b[j], rk[k->rounds - 1]), rk[k->rounds]);
+            vst1q_u8(out + i + 16 * j, veorq_u8(b[j], vld1q_u8(in + i + 16 * j)));
+        }
+    }
+    for (; i < len; i += 16) {
+        store_be32(cb[0] + 12, c++);
+        b[0] = vld1q_u8(cb[0]);
+        for (r = 0; r < k->rounds - 1; r++)
+            b[0] = vaesmcq_u8(vaeseq_u8(b[0], rk[r]));
+        b[0] = veorq_u8(vaeseq_u8(b[0], rk[k->rounds - 1]), rk[k->rounds]);
+        vst1q_u8(out + i, veorq_u8(b[0], vld1q_u8(in + i)));
+    }
+}
+
+/* the x86 reduction, with NEON for the SSE it uses */
+#define U32(x) vreinterpretq_u32_u8(x)
+#define U8(x) vreinterpretq_u8_u32(x)
+#define SHL128(x, n) vextq_u8(vdupq_n_u8(0), (x), 16 - (n))
+#define SHR128(x, n) vextq_u8((x), vdupq_n_u8(0), (n))
+#define CLMUL(a, b, i, j) vreinterpretq_u8_p128(vmull_p64(                 \
+    (poly64_t)vgetq_lane_u64(vreinterpretq_u64_u8(a), i),                   \
+    (poly64_t)vgetq_lane_u64(vreinterpretq_u64_u8(b), j)))
+#define BSWAP128(x) ({ uint8x16_t _r = vrev64q_u8(x); vextq_u8(_r, _r, 8); })
+
+static inline AES_ARM __attribute__((always_inline))
+uint8x16_t ghash_mul_arm(uint8x16_t a, uint8x16_t b)
+{
+    uint8x16_t lo, mid, hi, t2, t4, t5, t7, t8, t9;
+
+    lo = CLMUL(a, b, 0, 0);
+    hi = CLMUL(a, b, 1, 1);
+    mid = veorq_u8(CLMUL(a, b, 0, 1), CLMUL(a, b, 1, 0));
+    lo = veorq_u8(lo, SHL128(mid, 8));
+    hi = veorq_u8(hi, SHR128(mid, 8));
+
+    t7 = U8(vshrq_n_u32(U32(lo), 31));
+    t8 = U8(vshrq_n_u32(U32(hi), 31));
+    lo = U8(vshlq_n_u32(U32(lo), 1));
+    hi = U8(vshlq_n_u32(U32(hi), 1));
+    t9 = SHR128(t7, 12);
+    t8 = SHL128(t8, 4);
+    t7 = SHL128(t7, 4);
+    lo = vorrq_u8(lo, t7);
+    hi = vorrq_u8(vorrq_u8(hi, t8), t9);
+
+    t7 = veorq_u8(veorq_u8(U8(vshlq_n_u32(U32(lo), 31)), U8(vshlq_n_u32(U32(lo), 30))),
+                  U8(vshlq_n_u32(U32(lo), 25)));
+    t8 = SHR128(t7, 4);
+    lo = veorq_u8(lo, SHL128(t7, 12));
+    t2 = U8(vshrq_n_u32(U32(lo), 1));
+    t4 = U8(vshrq_n_u32(U32(lo), 2));
+    t5 = U8(vshrq_n_u32(U32(lo), 7));
+    t2 = veorq_u8(veorq_u8(t2, t4), veorq_u8(t5, t8));
+    return veorq_u8(hi, veorq_u8(lo, t2));
+}
+
+static AES_ARM void ghash_pmull(const AesKey *k, guchar *x, const guchar *in, gsize len)
+{
+    uint8x16_t h = BSWAP128(vld1q_u8(k->hpow[0]));
+    uint8x16_t xv = BSWAP128(vld1q_u8(x));
+    gsize i;
+
+    for (i = 0; i < len; i += 16)
+        xv = ghash_mul_arm(veorq_u8(xv, BSWAP128(vld1q_u8(in + i))), h);
+    vst1q_u8(x, BSWAP128(xv));
+}
+#endif
+
+static const AesImpl aes_impls[] = {
+    { "tables", "", aes_ctr_c, ghash_c },
+#if defined(__x86_64__)
+    { "AES-NI", "aes pclmulqdq sse4_1", aes_ctr_aesni, ghash_clmul },
+    { "VAES", "vaes avx512f avx512bw aes pclmulqdq sse4_1", aes_ctr_vaes, ghash_clmul },
+#elif defined(__aarch64__)
+    { "ARMv8 AES", "aes pmull", aes_ctr_arm, ghash_pmull },
+#endif
+};
+
+/* GCM with a 96 bit IV and no additional data */
+static void aes_gcm(const AesImpl *impl, const AesKey *k, const guchar *iv,
+                    const guchar *in, guchar *out, gsize len, guchar *tag)
+{
+    static const guchar zero[16];
+    guchar j0[16], ek[16], x[16] = { 0 }, lens[16] = { 0 };
+    guint64 bits = (guint64)len * 8;
+    gint i;
+
+    memcpy(j0, iv, 12);
+    store_be32(j0 + 12, 1);
+    impl->ctr(k, j0, zero, ek, 16);
+    store_be32(j0 + 12, 2);
+    impl->ctr(k, j0, in, out, len);
+    impl->ghash(k, x, out, len);
+    store_be32(lens + 8, bits >> 32);
+    store_be32(lens + 12, bits);
+    impl->ghash(k, x, lens, 16);
+    for (i = 0; i < 16; i++)
+        tag[i] = x[i] ^ ek[i];
+}
+
+typedef struct {
+    const gchar *key, *iv, *plain, *cipher, *tag; /* hex; no tag for a block */
+} AesKnown;
+
+static const AesKnown aes_known[] = {
+    /* FIPS-197 C.1 and C.3 */
+    { "000102030405060708090a0b0c0d0e0f", NULL, "00112233445566778899aabbccddeeff",
+      "69c4e0d86a7b0430d8cdb78070b4c55a", NULL },
+    { "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", NULL,
+      "00112233445566778899aabbccddeeff", "8ea2b7ca516745bfeafc49904b496089", NULL },
+    /* the GCM spec, test cases 2, 3 and 14 */
+    { "00000000000000000000000000000000", "000000000000000000000000",
+      "00000000000000000000000000000000", "0388dace60b6a392f328c2b971b2fe78",
+      "ab6e47d42cec13bdf53a67b21257bddf" },
+    { "feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+      "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+      "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255",
+      "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+      "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985",
+      "4d5c2af327cd64a62cf35abd2ba6fab4" },
+    { "0000000000000000000000000000000000000000000000000000000000000000",
+      "000000000000000000000000", "00000000000000000000000000000000",
+      "cea7403d4d606b6e074ec5d3baf39d18", "d0d1c8a799996bf0265b98b5d48ab919" },
+    { NULL }
+};
+
+static gsize aes_unhex(const gchar *hex, guchar *out)
+{
+    gsize n;
+
+    for (n = 0; hex[2 * n]; n++)
+        out[n] = g_ascii_xdigit_value(hex[2 * n]) << 4 |
+                 g_ascii_xdigit_value(hex[2 * n + 1]);
+    return n;
+}
+
+static gboolean aes_known_ok(const AesImpl *impl)
+{
+    guchar key[32], iv[12], plain[64], expect[64], out[64], tag[16];
+    gchar *hex;
+    gboolean ok = TRUE;
+    AesKey k;
+    gsize n;
+    gint i;
+
+    for (i = 0; aes_known[i].key && ok; i++) {
+        n = aes_unhex(aes_known[i].key, key);
+        aes_key_init(&k, key, n * 8);
+        n = aes_unhex(aes_known[i].plain, plain);
+        aes_unhex(aes_known[i].cipher, expect);
+        if (aes_known[i].tag) {
+            aes_unhex(aes_known[i].iv, iv);
+            aes_gcm(impl, &k, iv, plain, out, n, tag);
+            hex = digest_to_str((const char *)tag, 16);
+            ok = g_str_equal(hex, aes_known[i].tag);
+            free(hex);
+        } else {
+            /* the plaintext as the counter block encrypts it */
+            memset(out, 0, 16);
+            impl->ctr(&k, plain, out, out, 16);
+        }
+        ok = ok && !memcmp(out, expect, n);
+    }
+    return ok;
+}
+
+/* the same as the tables on a whole buffer, with both key sizes */
+static gboolean aes_same(const AesImpl *impl, const AesImpl *first, const AesKey *keys,
+                         const guchar *in, guchar *out)
+{
+    static const guchar iv[12] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+    guchar *expect = g_malloc(AES_BUFFER), tag[2][16];
+    gboolean ok = TRUE;
+    gint i;
+
+    for (i = 0; i < 2 && ok; i++) {
+        aes_gcm(impl, &keys[i], iv, in, out, AES_BUFFER, tag[0]);
+        aes_gcm(first, &keys[i], iv, in, expect, AES_BUFFER, tag[1]);
+        ok = !memcmp(out, expect, AES_BUFFER) && !memcmp(tag[0], tag[1], 16);
+    }
+    g_free(expect);
+    return ok;
+}
+
+static gpointer aes_for(void *data, gint thread_number)
+{
+    static const guchar iv[12] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+    AesData *ad = data;
+    guchar *out = ad->out + (gsize)thread_number * AES_BUFFER, cb[16], tag[16];
+
+    if (ad->gcm) {
+        aes_gcm(ad->impl, ad->key, iv, ad->in, out, AES_BUFFER, tag);
+    } else {
+        memcpy(cb, iv, 12);
+        store_be32(cb + 12, 0);
+        ad->impl->ctr(ad->key, cb, ad->in, out, AES_BUFFER);
+    }
+    return NULL;
+}
+
+static void benchmark_aes_run(gint n_threads, gint entry)
+{
+    static const gint key_bits[2] = { 128, 256 };
+    bench_value r = EMPTY_BENCH_VALUE, lr;
+    AesData ad;
+    AesKey keys[2];
+    guchar key[32], *in;
+    gchar **cpu_flags;
+    double gbs[2][2] = { { 0 } }; /* [gcm][key] */
+    gint i, m;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running AES benchmark...");
+
+    aes_tables_init();
+    for (i = 0; i < 32; i++)
+        key[i] = i * 7 + 3;
+    aes_key_init(&keys[0], key, 128);
+    aes_key_init(&keys[1], key, 256);
+
+    n_threads = benchmark_threads(n_threads);
+    in = g_malloc(AES_BUFFER);
+    for (i = 0; i < AES_BUFFER; i++)
+        in[i] = i * 131 + (i >> 8);
+    ad.in = in;
+    ad.out = g_malloc((gsize)n_threads * AES_BUFFER);
+
+    ad.impl = NULL;
+    cpu_flags = bench_cpu_flags();
+    for (i = 0; i < (gint)G_N_ELEMENTS(aes_impls); i++) {
+        if (cpu_flags ? !bench_cpu_has(cpu_flags, aes_impls[i].flags) : i > 0)
+            continue;
+        if (aes_known_ok(&aes_impls[i]) &&
+            (!i || aes_same(&aes_impls[i], &aes_impls[0], keys, in, ad.out)))
+            ad.impl = &aes_impls[i];
+        else
+            bench_msg("%s gives wrong results, not used", aes_impls[i].name);
+        if (!ad.impl)
+            break;
+    }
+    g_strfreev(cpu_flags);
+
+    for (m = 0; ad.impl && m < 2 && !params.aborting_benchmarks; m++) {
+        for (i = 0; i < 2 && !params.aborting_benchmarks; i++) {
+            ad.gcm = m;
+            ad.key = &keys[i];
+            lr = benchmark_crunch_for(AES_SECONDS, n_threads, aes_for, &ad);
+            if (lr.elapsed_time <= 0)
+                continue;
+            gbs[m][i] = lr.result * AES_BUFFER / lr.elapsed_time / 1e9;
+            /* AES-128-GCM is the result */
+            if (m == 1 && i == 0) {
+                bench_thermal_merge(&lr.thermal, &r.thermal);
+                r = lr;
+            } else {
+                bench_thermal_merge(&r.thermal, &lr.thermal);
+            }
+        }
+    }
+
+    if (gbs[1][0] > 0) {
+        r.result = gbs[1][0];
+        r.revision = BENCH_REVISION;
+        bench_value_append_extra(&r, "%s, CTR %d/%d %0.2f/%0.2f GB/s, "
+                                 "GCM %d/%d %0.2f/%0.2f GB/s",
+                                 ad.impl->name, key_bits[0], key_bits[1],
+                                 gbs[0][0], gbs[0][1], key_bits[0], key_bits[1],
+                                 gbs[1][0], gbs[1][1]);
+    } else {
+        r.result = -1;
+    }
+
+    g_free(in);
+    g_free(ad.out);
+
+    bench_results[entry] = r;
+}
+
+void benchmark_aes_single(void) { benchmark_aes_run(1, BENCHMARK_AES_SINGLE); }
+void benchmark_aes_all(void) { benchmark_aes_run(0, BENCHMARK_AES_ALL); }
@@ -0,0 +1,173 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <time.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* Log-linear latency histogram.
+ *
+ * Values below 2^SUB_BITS have a bucket each; above that, every power of
+ * two is split into 2^SUB_BITS buckets, so a bucket is never wider than
+ * 1/16 (~6%) of the values in it. A histogram belongs to one worker and
+ * is only written by it; merging happens after the workers are done. */
+
+#define SUB_BITS 4
+#define SUB_COUNT (1 << SUB_BITS)
+
+static gint msb64(guint64 v)
+{
+    gint e = 0;
+
+    if (v >> 32) { v >>= 32; e += 32; }
+    if (v >> 16) { v >>= 16; e += 16; }
+    if (v >> 8) { v >>= 8; e += 8; }
+    if (v >> 4) { v >>= 4; e += 4; }
+    if (v >> 2) { v >>= 2; e += 2; }
+    if (v >> 1) { e += 1; }
+    return e;
+}
+
+static gint hist_bucket(guint64 v)
+{
+    gint e;
+
+    if (v < SUB_COUNT)
+        return (gint)v;
+    e = msb64(v);
+    return (e - SUB_BITS + 1) * SUB_COUNT +
+           (gint)((v >> (e - SUB_BITS)) & (SUB_COUNT - 1));
+}
+
+/* highest value that lands in bucket b */
+static guint64 hist_bucket_upper(gint b)
+{
+    gint e, sub;
+
+    if (b < SUB_COUNT)
+        return b;
+    e = b / SUB_COUNT + SUB_BITS - 1;
+    sub = b % SUB_COUNT;
+    return ((guint64)(SUB_COUNT + sub + 1) << (e - SUB_BITS)) - 1;
+}
+
+guint64 bench_hist_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (guint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void bench_hist_add(bench_hist *h, guint64 ns)
+{
+    gint b = hist_bucket(ns);
+
+    if (b >= BENCH_HIST_BUCKETS)
+        b = BENCH_HIST_BUCKETS - 1;
+    h->count[b]++;
+    h->n++;
+    if (ns > h->max)
+        h->max = ns;
+}
+
+void bench_hist_merge(bench_hist *dst, const bench_hist *src)
+{
+    gint b;
+
+    for (b = 0; b < BENCH_HIST_BUCKETS; b++)
+        dst->count[b] += src->count[b];
+    dst->n += src->n;
+    if (src->max > dst->max)
+        dst->max = src->max;
+}
+
+/* upper bound of the bucket holding the p-th fraction of samples */
+guint64 bench_hist_percentile(const bench_hist *h, double p)
+{
+    guint64 rank, seen = 0;
+    gint b;
+
+    if (!h->n)
+        return 0;
+
+    rank = (guint64)(p * h->n + 0.999999);
+    if (rank < 1)
+        rank = 1;
+    for (b = 0; b < BENCH_HIST_BUCKETS; b++) {
+        seen += h->count[b];
+        if (seen >= rank)
+            return MIN(hist_bucket_upper(b), h->max);
+    }
+    return h->max;
+}
+
+void bench_latency_from_hist(bench_latency *l, const bench_hist *h)
+{
+    memset(l, 0, sizeof(bench_latency));
+    if (!h->n)
+        return;
+
+    l->n = h->n;
+    l->p50 = bench_hist_percentile(h, 0.50);
+    l->p90 = bench_hist_percentile(h, 0.90);
+    l->p99 = bench_hist_percentile(h, 0.99);
+    l->p999 = bench_hist_percentile(h, 0.999);
+    l->max = h->max;
+}
+
+/* "n:p50:p90:p99:p999:max", in nanoseconds */
+gchar *bench_latency_to_str(const bench_latency *l)
+{
+    return g_strdup_printf("%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT
+                           ":%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT
+                           ":%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT,
+                           l->n, l->p50, l->p90, l->p99, l->p999, l->max);
+}
+
+gboolean bench_latency_from_str(bench_latency *l, const gchar *str)
+{
+    gchar **f = g_strsplit(str, ":", -1);
+    gboolean ok = (g_strv_length(f) == 6);
+
+    memset(l, 0, sizeof(bench_latency));
+    if (ok) {
+        l->n = g_ascii_strtoull(f[0], NULL, 10);
+        l->p50 = g_ascii_strtoull(f[1], NULL, 10);
+        l->p90 = g_ascii_strtoull(f[2], NULL, 10);
+        l->p99 = g_ascii_strtoull(f[3], NULL, 10);
+        l->p999 = g_ascii_strtoull(f[4], NULL, 10);
+        l->max = g_ascii_strtoull(f[5], NULL, 10);
+    }
+    g_strfreev(f);
+
+    return ok;
+}
+
+/* "850 ns", "12.3 µs", "4.56 ms" */
+gchar *bench_latency_format(guint64 ns)
+{
+    if (ns < 1000)
+        return g_strdup_printf("%" G_GUINT64_FORMAT " %s", ns, _("ns"));
+    if (ns < 1000000)
+        return g_strdup_printf("%0.2f %s", ns / 1e3, _("µs"));
+    if (ns < 1000000000)
+        return g_strdup_printf("%0.2f %s", ns / 1e6, _("ms"));
+    return g_strdup_printf("%0.2f %s", ns / 1e9, _("s"));
+}
@@ -0,0 +1,245 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <errno.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* Hardware performance counters for the benchmark pool workers.
+ *
+ * Every worker opens its own counters, for its own thread, user space
+ * only (allowed up to perf_event_paranoid=2). They are not grouped, so
+ * the kernel can multiplex them when the PMU is short of counters;
+ * values are scaled by enabled/running time. The counters stay enabled
+ * and a run is measured as the difference of two reads. */
+
+struct _BenchPerfThread {
+    gint fd[BENCH_PERF_N_EVENTS];
+    guint64 value[BENCH_PERF_N_EVENTS];
+    guint64 enabled[BENCH_PERF_N_EVENTS];
+    guint64 running[BENCH_PERF_N_EVENTS];
+    guint mask;
+};
+
+static const struct {
+    const gchar *name;
+    guint32 type;
+    guint64 config;
+} perf_events[BENCH_PERF_N_EVENTS] = {
+    [BENCH_PERF_CYCLES] = { "Cycles",
+        PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    [BENCH_PERF_INSTRUCTIONS] = { "Instructions",
+        PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    [BENCH_PERF_CACHE_REFS] = { "CacheReferences",
+        PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES },
+    [BENCH_PERF_CACHE_MISSES] = { "CacheMisses",
+        PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    [BENCH_PERF_BRANCH_MISSES] = { "BranchMisses",
+        PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    [BENCH_PERF_LLC_MISSES] = { "LLCMisses",
+        PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+                            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+};
+
+/* once a worker finds there are no counters, the others don't try */
+static gint perf_unavailable = 0;
+
+const gchar *bench_perf_event_name(bench_perf_event e)
+{
+    return perf_events[e].name;
+}
+
+static gint perf_paranoid(void)
+{
+    gchar *tmp = NULL;
+    gint ret = -100;
+
+    if (g_file_get_contents("/proc/sys/kernel/perf_event_paranoid", &tmp, NULL, NULL))
+        ret = atoi(tmp);
+    g_free(tmp);
+    return ret;
+}
+
+BenchPerfThread *bench_perf_thread_open(void)
+{
+    struct perf_event_attr attr;
+    BenchPerfThread *pt;
+    gint e;
+
+    if (g_atomic_int_get(&perf_unavailable))
+        return NULL;
+
+    pt = g_new0(BenchPerfThread, 1);
+    for (e = 0; e < BENCH_PERF_N_EVENTS; e++) {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = perf_events[e].type;
+        attr.config = perf_events[e].config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        pt->fd[e] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        if (pt->fd[e] >= 0) {
+            pt->mask |= 1 << e;
+        } else if (e == BENCH_PERF_CYCLES) {
+            /* no point in trying the others */
+            if (g_atomic_int_compare_and_exchange(&perf_unavailable, 0, 1))
+                bench_msg("hardware counters unavailable: %s (perf_event_paranoid=%d)",
+                          g_strerror(errno), perf_paranoid());
+            g_free(pt);
+            return NULL;
+        } else {
+            DEBUG("perf event %s unavailable: %s", perf_events[e].name,
+                  g_strerror(errno));
+        }
+    }
+
+    return pt;
+}
+
+void bench_perf_thread_close(BenchPerfThread *pt)
+{
+    gint e;
+
+    if (!pt)
+        return;
+    for (e = 0; e < BENCH_PERF_N_EVENTS; e++) {
+        if (pt->mask & (1 << e))
+            close(pt->fd[e]);
+    }
+    g_free(pt);
+}
+
+static gboolean perf_read(gint fd, guint64 *value, guint64 *enabled, guint64 *running)
+{
+    guint64 buf[3];
+
+    if (read(fd, buf, sizeof(buf)) != sizeof(buf))
+        return FALSE;
+    *value = buf[0];
+    *enabled = buf[1];
+    *running = buf[2];
+    return TRUE;
+}
+
+void bench_perf_thread_start(BenchPerfThread *pt)
+{
+    gint e;
+
+    if (!pt)
+        return;
+    for (e = 0; e < BENCH_PERF_N_EVENTS; e++) {
+        if (!(pt->mask & (1 << e)))
+            continue;
+        if (!perf_read(pt->fd[e], &pt->value[e], &pt->enabled[e], &pt->running[e]))
+            pt->mask &= ~(1 << e);
+    }
+}
+
+/* counts since bench_perf_thread_start() */
+void bench_perf_thread_stop(BenchPerfThread *pt, bench_counters *c)
+{
+    guint64 value, enabled, running;
+    gint e;
+
+    memset(c, 0, sizeof(bench_counters));
+    if (!pt)
+        return;
+    for (e = 0; e < BENCH_PERF_N_EVENTS; e++) {
+        if (!(pt->mask & (1 << e)))
+            continue;
+        if (!perf_read(pt->fd[e], &value, &enabled, &running))
+            continue;
+        value -= pt->value[e];
+        enabled -= pt->enabled[e];
+        running -= pt->running[e];
+        if (running == 0)
+            continue; /* never got a counter */
+        if (running < enabled)
+            value = (guint64)((double)value * enabled / running);
+        c->value[e] = value;
+        c->mask |= 1 << e;
+    }
+}
+
+void bench_counters_reset(bench_counters *c)
+{
+    memset(c, 0, sizeof(bench_counters));
+    c->mask = (1 << BENCH_PERF_N_EVENTS) - 1;
+}
+
+/* an event is only kept if every part was counted */
+void bench_counters_add(bench_counters *dst, const bench_counters *src)
+{
+    gint e;
+
+    dst->mask &= src->mask;
+    for (e = 0; e < BENCH_PERF_N_EVENTS; e++)
+        dst->value[e] = (dst->mask & (1 << e)) ? dst->value[e] + src->value[e] : 0;
+}
+
+gboolean bench_counters_has(const bench_counters *c, bench_perf_event e)
+{
+    return (c->mask & (1 << e)) != 0;
+}
+
+/* ratio of two events, per `per` of the second; -1 if either is missing */
+double bench_counters_ratio(const bench_counters *c, bench_perf_event num,
+                            bench_perf_event den, double per)
+{
+    if (!bench_counters_has(c, num) || !bench_counters_has(c, den) ||
+        !c->value[den])
+        return -1;
+    return per * c->value[num] / c->value[den];
+}
+
+/* "mask:v0:v1:..." */
+gchar *bench_counters_to_str(const bench_counters *c)
+{
+    GString *str = g_string_new(NULL);
+    gint e;
+
+    g_string_append_printf(str, "%u", c->mask);
+    for (e = 0; e < BENCH_PERF_N_EVENTS; e++)
+        g_string_append_printf(str, ":%" G_GUINT64_FORMAT, c->value[e]);
+
+    return g_string_free(str, FALSE);
+}
+
+gboolean bench_counters_from_str(bench_counters *c, const gchar *str)
+{
+    gchar **f = g_strsplit(str, ":", -1);
+    gboolean ok = (g_strv_length(f) == BENCH_PERF_N_EVENTS + 1);
+    gint e;
+
+    memset(c, 0, sizeof(bench_counters));
+    if (ok) {
+        c->mask = atoi(f[0]) & ((1 << BENCH_PERF_N_EVENTS) - 1);
+        for (e = 0; e < BENCH_PERF_N_EVENTS; e++)
+            c->value[e] = g_ascii_strtoull(f[e + 1], NULL, 10);
+    }
+    g_strfreev(f);
+
+    return ok;
+}
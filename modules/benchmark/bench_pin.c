@@ -0,0 +1,304 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <sched.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+#include "cpu_util.h"
+#include "cpubits.h"
+
+/* Worker placement for the benchmark pool.
+ *
+ * A placement is an ordered list of logical CPUs; worker N is pinned to
+ * cpus[N % n_cpus]. The order is built from the sysfs topology read by
+ * cputopo_new():
+ *   cores - one worker per physical core first, SMT siblings only after
+ *           every core has a worker
+ *   smt   - SMT siblings of a core are filled before moving on
+ *   numa  - consecutive workers go to different NUMA nodes
+ *   <list> - an explicit cpu list, like "0-3,8,10"
+ */
+
+typedef struct {
+    cpu_topology_data *topo;
+    gint thread; /* index of this cpu among the SMT siblings of its core */
+} pin_cpu;
+
+static const char *pin_names[] = {
+    [BENCH_PIN_NONE] = "none",
+    [BENCH_PIN_CORES] = "cores",
+    [BENCH_PIN_SMT] = "smt",
+    [BENCH_PIN_NUMA] = "numa",
+    [BENCH_PIN_LIST] = "list",
+};
+
+static bench_placement placement = { BENCH_PIN_NONE, NULL, 0 };
+
+#define TOPO_CMP(F) if (a->topo->F != b->topo->F) return a->topo->F < b->topo->F ? -1 : 1;
+#define THREAD_CMP() if (a->thread != b->thread) return a->thread < b->thread ? -1 : 1;
+
+static gint pin_cmp_cores(gconstpointer pa, gconstpointer pb)
+{
+    const pin_cpu *a = pa, *b = pb;
+    THREAD_CMP();
+    TOPO_CMP(node_id);
+    TOPO_CMP(socket_id);
+    TOPO_CMP(core_id);
+    TOPO_CMP(id);
+    return 0;
+}
+
+static gint pin_cmp_smt(gconstpointer pa, gconstpointer pb)
+{
+    const pin_cpu *a = pa, *b = pb;
+    TOPO_CMP(node_id);
+    TOPO_CMP(socket_id);
+    TOPO_CMP(core_id);
+    THREAD_CMP();
+    TOPO_CMP(id);
+    return 0;
+}
+
+/* like cores, but node last so the nodes interleave */
+static gint pin_cmp_numa(gconstpointer pa, gconstpointer pb)
+{
+    const pin_cpu *a = pa, *b = pb;
+    TOPO_CMP(node_id);
+    THREAD_CMP();
+    TOPO_CMP(socket_id);
+    TOPO_CMP(core_id);
+    TOPO_CMP(id);
+    return 0;
+}
+
+/* all online cpus with topology, sorted by id */
+static pin_cpu *pin_cpus_online(gint *n_cpus)
+{
+    gchar *tmp = NULL;
+    cpubits *online;
+    pin_cpu *cpus;
+    gint i, j, n = 0, max;
+
+    g_file_get_contents("/sys/devices/system/cpu/online", &tmp, NULL, NULL);
+    if (!tmp) {
+        *n_cpus = 0;
+        return NULL;
+    }
+    online = cpubits_from_str(tmp);
+    g_free(tmp);
+
+    max = cpubits_max(online);
+    cpus = g_new0(pin_cpu, cpubits_count(online));
+    for (i = 0; i <= max; i++) {
+        if (!CPUBIT_GET(online, i))
+            continue;
+        cpus[n].topo = cputopo_new(i);
+        /* a cpu without topology is a core of its own */
+        if (cpus[n].topo->core_id == CPU_TOPO_NULL)
+            cpus[n].topo->core_id = i;
+        if (cpus[n].topo->socket_id < 0)
+            cpus[n].topo->socket_id = 0;
+        if (cpus[n].topo->node_id < 0)
+            cpus[n].topo->node_id = 0;
+        for (j = 0; j < n; j++) {
+            if (cpus[j].topo->socket_id == cpus[n].topo->socket_id &&
+                cpus[j].topo->core_id == cpus[n].topo->core_id)
+                cpus[n].thread++;
+        }
+        n++;
+    }
+    free(online);
+
+    *n_cpus = n;
+    return cpus;
+}
+
+static gint *pin_order_topology(bench_pin_policy policy, gint *n_cpus)
+{
+    GCompareFunc cmp = pin_cmp_cores;
+    pin_cpu *cpus;
+    gint *order = NULL;
+    gint i, n, *nodes, n_nodes, node, k;
+
+    cpus = pin_cpus_online(&n);
+    if (!cpus) {
+        *n_cpus = 0;
+        return NULL;
+    }
+
+    if (policy == BENCH_PIN_SMT)
+        cmp = pin_cmp_smt;
+    else if (policy == BENCH_PIN_NUMA)
+        cmp = pin_cmp_numa;
+    qsort(cpus, n, sizeof(pin_cpu), (int (*)(const void *, const void *))cmp);
+
+    order = g_new0(gint, n);
+    if (policy == BENCH_PIN_NUMA) {
+        /* cpus are grouped by node now; deal them out round-robin */
+        nodes = g_new0(gint, n + 1); /* start of each node's group */
+        n_nodes = 0;
+        for (i = 0; i < n; i++) {
+            if (i == 0 || cpus[i].topo->node_id != cpus[i - 1].topo->node_id)
+                nodes[n_nodes++] = i;
+        }
+        nodes[n_nodes] = n;
+        for (i = 0, k = 0; k < n; i++) {
+            for (node = 0; node < n_nodes; node++) {
+                if (nodes[node] + i < nodes[node + 1])
+                    order[k++] = cpus[nodes[node] + i].topo->id;
+            }
+        }
+        g_free(nodes);
+    } else {
+        for (i = 0; i < n; i++)
+            order[i] = cpus[i].topo->id;
+    }
+
+    for (i = 0; i < n; i++)
+        cputopo_free(cpus[i].topo);
+    g_free(cpus);
+
+    *n_cpus = n;
+    return order;
+}
+
+/* an explicit "0-3,8" list, in increasing order, without the cpus that
+ * are offline; n_cpus is 0 when any part of it is not a valid cpu */
+static gint *pin_order_list(const gchar *list, gint *n_cpus)
+{
+    const glong limit = MIN(CPUBITS_SIZE * 8, CPU_SETSIZE);
+    gchar *tmp = NULL, **parts;
+    cpubits *online;
+    gboolean *picked;
+    gint *order, i, n = 0;
+    glong first, last;
+    gchar *end;
+
+    *n_cpus = 0;
+    if (!g_file_get_contents("/sys/devices/system/cpu/online", &tmp, NULL, NULL))
+        return NULL;
+    online = cpubits_from_str(g_strstrip(tmp));
+    g_free(tmp);
+
+    picked = g_new0(gboolean, limit);
+    parts = g_strsplit(list, ",", -1);
+    for (i = 0; parts[i]; i++) {
+        errno = 0;
+        first = strtol(parts[i], &end, 10);
+        last = first;
+        if (end != parts[i] && *end == '-') {
+            gchar *range = end + 1;
+            last = strtol(range, &end, 10);
+            if (end == range)
+                break;
+        }
+        if (end == parts[i] || *end || errno || first < 0 || last < first ||
+            last >= limit)
+            break;
+        for (; first <= last; first++)
+            picked[first] = TRUE;
+    }
+
+    order = g_new0(gint, limit);
+    if (!parts[i] && i > 0) {
+        for (i = 0; i < limit; i++) {
+            if (picked[i] && CPUBIT_GET(online, i))
+                order[n++] = i;
+        }
+    }
+    g_strfreev(parts);
+    g_free(picked);
+    free(online);
+
+    *n_cpus = n;
+    return order;
+}
+
+const gchar *bench_pin_policy_name(bench_pin_policy policy)
+{
+    return pin_names[policy];
+}
+
+gboolean bench_placement_set(const gchar *policy)
+{
+    bench_pin_policy p = BENCH_PIN_NONE;
+    gint i;
+
+    g_free(placement.cpus);
+    placement.cpus = NULL;
+    placement.n_cpus = 0;
+    placement.policy = BENCH_PIN_NONE;
+
+    if (!policy || !*policy || SEQ(policy, "none")) {
+        bench_pool_set_affinity(NULL, 0);
+        return TRUE;
+    }
+
+    for (i = BENCH_PIN_CORES; i < BENCH_PIN_LIST; i++) {
+        if (SEQ(policy, pin_names[i]))
+            p = i;
+    }
+
+    if (p != BENCH_PIN_NONE) {
+        placement.cpus = pin_order_topology(p, &placement.n_cpus);
+    } else if (isdigit(*policy)) {
+        p = BENCH_PIN_LIST;
+        placement.cpus = pin_order_list(policy, &placement.n_cpus);
+    }
+
+    if (!placement.n_cpus) {
+        bench_msg("unusable placement \"%s\", workers will not be pinned", policy);
+        g_free(placement.cpus);
+        placement.cpus = NULL;
+        bench_pool_set_affinity(NULL, 0);
+        return FALSE;
+    }
+
+    placement.policy = p;
+    bench_pool_set_affinity(placement.cpus, placement.n_cpus);
+    return TRUE;
+}
+
+const bench_placement *bench_placement_get(void)
+{
+    return &placement;
+}
+
+/* "pin:cores(0-3,8)", the cpus used by the first n_threads workers */
+gchar *bench_placement_describe(gint n_threads)
+{
+    cpubits *used;
+    gchar *list, *ret;
+    gint i;
+
+    if (placement.policy == BENCH_PIN_NONE || !placement.n_cpus)
+        return NULL;
+
+    used = cpubits_from_str("");
+    for (i = 0; i < n_threads; i++)
+        CPUBIT_SET(used, placement.cpus[i % placement.n_cpus]);
+    list = cpubits_to_str(used, NULL, 0);
+    ret = g_strdup_printf("pin:%s(%s)", pin_names[placement.policy], list);
+    free(list);
+    free(used);
+
+    return ret;
+}
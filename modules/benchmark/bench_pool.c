@@ -0,0 +1,325 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#define _GNU_SOURCE
+#include <sched.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* Long-lived benchmark worker pool.
+ *
+ * Workers are created on first use and parked on a condition between
+ * runs, so back-to-back benchmarks (and repeated runs of one benchmark)
+ * don't pay for thread creation and teardown. Worker N is always the
+ * same OS thread, so per-thread data set up by one run (first-touch
+ * memory, affinity) is still valid for the next one.
+ *
+ * Every run releases all of its workers, and the caller, from a barrier,
+ * so the threads start working at the same moment and the caller can
+ * start its timer right after bench_pool_start() returns.
+ *
+ * With bench_pool_set_affinity(), worker N pins itself to
+ * cpus[N % n_cpus] before its next run.
+ *
+ * Each worker counts its own hardware events around func(); the sum for
+ * the last run is in bench_pool_counters(). */
+
+static struct {
+    GMutex lock;
+    GCond wake, done;
+    GThread **threads;
+    gint n_threads;     /* spawned so far */
+    gint n_active;      /* taking part in the current run */
+    gint running;       /* active workers that didn't finish yet */
+    guint generation;   /* bumped for every run */
+    guint runs;
+    BenchPoolFunc func;
+    gpointer *tasks;
+    gboolean quit;
+    bench_counters counters; /* of the current run */
+
+    /* placement */
+    gint *cpus;
+    gint n_cpus;
+    guint affinity_generation;
+    cpu_set_t *default_mask;
+    gint mask_cpus;
+
+    /* start barrier */
+    GMutex barrier_lock;
+    GCond barrier_cond;
+    gint barrier_count;
+    guint barrier_generation;
+} pool;
+
+static gboolean pool_ready = FALSE;
+
+static void bench_pool_barrier(void)
+{
+    guint gen;
+
+    g_mutex_lock(&pool.barrier_lock);
+    gen = pool.barrier_generation;
+    if (++pool.barrier_count == pool.n_active + 1) {
+        /* last one in releases everybody */
+        pool.barrier_count = 0;
+        pool.barrier_generation++;
+        g_cond_broadcast(&pool.barrier_cond);
+    } else {
+        while (gen == pool.barrier_generation)
+            g_cond_wait(&pool.barrier_cond, &pool.barrier_lock);
+    }
+    g_mutex_unlock(&pool.barrier_lock);
+}
+
+/* cpu < 0 puts back the mask the process started with */
+static void bench_pool_pin_self(gint worker, gint cpu)
+{
+    size_t size = CPU_ALLOC_SIZE(pool.mask_cpus);
+    cpu_set_t *mask;
+
+    if (cpu >= pool.mask_cpus)
+        return;
+
+    if (cpu < 0) {
+        if (pool.default_mask)
+            sched_setaffinity(0, size, pool.default_mask);
+        return;
+    }
+
+    mask = CPU_ALLOC(pool.mask_cpus);
+    CPU_ZERO_S(size, mask);
+    CPU_SET_S(cpu, size, mask);
+    if (sched_setaffinity(0, size, mask) != 0) {
+        bench_msg("could not pin worker %d to cpu %d", worker, cpu);
+    } else {
+        DEBUG("worker %d pinned to cpu %d", worker, cpu);
+    }
+    CPU_FREE(mask);
+}
+
+static gpointer bench_pool_worker(gpointer data)
+{
+    gint worker = GPOINTER_TO_INT(data);
+    guint seen = 0, affinity_seen = 0;
+    gint cpu = -1;
+    gboolean repin, perf_tried = FALSE;
+    BenchPerfThread *perf = NULL;
+    bench_counters counters;
+    BenchPoolFunc func;
+    gpointer task;
+
+    g_mutex_lock(&pool.lock);
+    for (;;) {
+        while (pool.generation == seen && !pool.quit)
+            g_cond_wait(&pool.wake, &pool.lock);
+        if (pool.quit)
+            break;
+        seen = pool.generation;
+        if (worker >= pool.n_active)
+            continue; /* not needed for this run, stay parked */
+
+        func = pool.func;
+        task = pool.tasks ? pool.tasks[worker] : NULL;
+        repin = (affinity_seen != pool.affinity_generation);
+        if (repin) {
+            affinity_seen = pool.affinity_generation;
+            cpu = pool.n_cpus ? pool.cpus[worker % pool.n_cpus] : -1;
+        }
+        g_mutex_unlock(&pool.lock);
+
+        if (repin)
+            bench_pool_pin_self(worker, cpu);
+        if (!perf_tried) {
+            perf = bench_perf_thread_open();
+            perf_tried = TRUE;
+        }
+
+        bench_pool_barrier();
+        bench_perf_thread_start(perf);
+        func(task, worker);
+        bench_perf_thread_stop(perf, &counters);
+
+        g_mutex_lock(&pool.lock);
+        bench_counters_add(&pool.counters, &counters);
+        if (--pool.running == 0)
+            g_cond_signal(&pool.done);
+    }
+    g_mutex_unlock(&pool.lock);
+
+    bench_perf_thread_close(perf);
+
+    DEBUG("benchmark worker %d leaving", worker);
+    return NULL;
+}
+
+static void bench_pool_init(void)
+{
+    if (pool_ready)
+        return;
+
+    memset(&pool, 0, sizeof(pool));
+    g_mutex_init(&pool.lock);
+    g_cond_init(&pool.wake);
+    g_cond_init(&pool.done);
+    g_mutex_init(&pool.barrier_lock);
+    g_cond_init(&pool.barrier_cond);
+
+    pool.mask_cpus = MAX(CPU_SETSIZE, sysconf(_SC_NPROCESSORS_CONF));
+    pool.default_mask = CPU_ALLOC(pool.mask_cpus);
+    if (sched_getaffinity(0, CPU_ALLOC_SIZE(pool.mask_cpus), pool.default_mask) != 0) {
+        CPU_FREE(pool.default_mask);
+        pool.default_mask = NULL;
+    }
+    pool_ready = TRUE;
+}
+
+/* called with pool.lock held */
+static void bench_pool_grow(gint n_threads)
+{
+    gint i;
+
+    if (n_threads <= pool.n_threads)
+        return;
+
+    pool.threads = g_renew(GThread *, pool.threads, n_threads);
+    for (i = pool.n_threads; i < n_threads; i++) {
+        DEBUG("launching benchmark worker %d", i);
+#if GLIB_CHECK_VERSION(2,32,0)
+        pool.threads[i] = g_thread_new("bench_worker", bench_pool_worker, GINT_TO_POINTER(i));
+#else
+        pool.threads[i] = g_thread_create(bench_pool_worker, GINT_TO_POINTER(i), TRUE, NULL);
+#endif
+    }
+    pool.n_threads = n_threads;
+}
+
+void bench_pool_set_affinity(const gint *cpus, gint n_cpus)
+{
+    bench_pool_init();
+
+    g_mutex_lock(&pool.lock);
+    if (!n_cpus && !pool.n_cpus) {
+        /* still unpinned */
+        g_mutex_unlock(&pool.lock);
+        return;
+    }
+    g_free(pool.cpus);
+    pool.cpus = NULL;
+    if (n_cpus) {
+        pool.cpus = g_new(gint, n_cpus);
+        memcpy(pool.cpus, cpus, n_cpus * sizeof(gint));
+    }
+    pool.n_cpus = n_cpus;
+    pool.affinity_generation++;
+    g_mutex_unlock(&pool.lock);
+}
+
+gint bench_pool_size(void)
+{
+    return pool_ready ? pool.n_threads : 0;
+}
+
+guint bench_pool_runs(void)
+{
+    return pool_ready ? pool.runs : 0;
+}
+
+void bench_pool_counters(bench_counters *c)
+{
+    if (!pool_ready) {
+        memset(c, 0, sizeof(bench_counters));
+        return;
+    }
+
+    g_mutex_lock(&pool.lock);
+    *c = pool.counters;
+    g_mutex_unlock(&pool.lock);
+}
+
+void bench_pool_start(gint n_workers, BenchPoolFunc func, gpointer *tasks)
+{
+    if (n_workers < 1)
+        n_workers = 1;
+
+    bench_pool_init();
+
+    g_mutex_lock(&pool.lock);
+    bench_pool_grow(n_workers);
+    pool.n_active = n_workers;
+    pool.running = n_workers;
+    pool.func = func;
+    pool.tasks = tasks;
+    bench_counters_reset(&pool.counters);
+    pool.generation++;
+    pool.runs++;
+    g_cond_broadcast(&pool.wake);
+    g_mutex_unlock(&pool.lock);
+
+    /* returns once every worker is ready to go */
+    bench_pool_barrier();
+}
+
+void bench_pool_wait(void)
+{
+    if (!pool_ready)
+        return;
+
+    g_mutex_lock(&pool.lock);
+    while (pool.running > 0)
+        g_cond_wait(&pool.done, &pool.lock);
+    pool.func = NULL;
+    pool.tasks = NULL;
+    g_mutex_unlock(&pool.lock);
+}
+
+void bench_pool_run(gint n_workers, BenchPoolFunc func, gpointer *tasks)
+{
+    bench_pool_start(n_workers, func, tasks);
+    bench_pool_wait();
+}
+
+void bench_pool_shutdown(void)
+{
+    gint i;
+
+    if (!pool_ready)
+        return;
+
+    bench_pool_wait();
+
+    g_mutex_lock(&pool.lock);
+    pool.quit = TRUE;
+    g_cond_broadcast(&pool.wake);
+    g_mutex_unlock(&pool.lock);
+
+    for (i = 0; i < pool.n_threads; i++)
+        g_thread_join(pool.threads[i]);
+    g_free(pool.threads);
+
+    g_mutex_clear(&pool.lock);
+    g_cond_clear(&pool.wake);
+    g_cond_clear(&pool.done);
+    g_mutex_clear(&pool.barrier_lock);
+    g_cond_clear(&pool.barrier_cond);
+    g_free(pool.cpus);
+    if (pool.default_mask)
+        CPU_FREE(pool.default_mask);
+    pool_ready = FALSE;
+}
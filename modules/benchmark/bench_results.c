@@ -219,6 +219,7 @@ void bench_result_free(bench_result *s)
     if (s) {
         free(s->name);
         bench_machine_free(s->machine);
+        bench_value_free(&s->bvalue);
         g_free(s);
     }
 }
@@ -232,7 +233,7 @@ bench_result *bench_result_this_machine(const char *bench_name, bench_value r)
         memset(b, 0, sizeof(bench_result));
         b->machine = bench_machine_this();
         b->name = strdup(bench_name);
-        b->bvalue = r;
+        b->bvalue = bench_value_copy(&r);
         b->legacy = 0;
     }
     return b;
@@ -323,6 +324,14 @@ static int json_get_int(JsonObject *obj, const gchar *key)
     return json_object_get_int_member(obj, key);
 }
 
+/* counters and nanoseconds go past G_MAXINT */
+static gint64 json_get_int64(JsonObject *obj, const gchar *key)
+{
+    if (!json_object_has_member(obj, key))
+        return 0;
+    return json_object_get_int_member(obj, key);
+}
+
 static const gchar *json_get_string(JsonObject *obj, const gchar *key)
 {
     if (!json_object_has_member(obj, key))
@@ -335,6 +344,161 @@ static gchar *json_get_string_dup(JsonObject *obj, const gchar *key)
     return g_strdup(json_get_string(obj, key));
 }
 
+static void json_get_latency(JsonObject *obj, bench_latency *l)
+{
+    JsonObject *lat;
+
+    memset(l, 0, sizeof(bench_latency));
+    if (!json_object_has_member(obj, "IterationLatency"))
+        return;
+
+    lat = json_object_get_object_member(obj, "IterationLatency");
+    if (!lat)
+        return;
+    l->n = json_get_int64(lat, "Samples");
+    l->p50 = json_get_int64(lat, "P50");
+    l->p90 = json_get_int64(lat, "P90");
+    l->p99 = json_get_int64(lat, "P99");
+    l->p999 = json_get_int64(lat, "P999");
+    l->max = json_get_int64(lat, "Max");
+}
+
+static void json_get_counters(JsonObject *obj, bench_counters *c)
+{
+    JsonObject *counters;
+    bench_perf_event e;
+
+    memset(c, 0, sizeof(bench_counters));
+    if (!json_object_has_member(obj, "PerfCounters"))
+        return;
+
+    counters = json_object_get_object_member(obj, "PerfCounters");
+    for (e = 0; counters && e < BENCH_PERF_N_EVENTS; e++) {
+        if (!json_object_has_member(counters, bench_perf_event_name(e)))
+            continue;
+        c->value[e] = json_get_int64(counters, bench_perf_event_name(e));
+        c->mask |= 1 << e;
+    }
+}
+
+static void json_get_thermal(JsonObject *obj, bench_thermal *th)
+{
+    JsonObject *tel;
+
+    memset(th, 0, sizeof(bench_thermal));
+    if (!json_object_has_member(obj, "Telemetry"))
+        return;
+
+    tel = json_object_get_object_member(obj, "Telemetry");
+    if (!tel)
+        return;
+    th->samples = json_get_int(tel, "Samples");
+    th->mhz_min = json_get_double(tel, "FreqMinMHz");
+    th->mhz_avg = json_get_double(tel, "FreqAvgMHz");
+    th->mhz_max = json_get_double(tel, "FreqMaxMHz");
+    th->has_temp = json_object_has_member(tel, "TempMaxC");
+    th->temp_max = json_get_double(tel, "TempMaxC");
+    th->throttled = json_get_boolean(tel, "Throttled");
+    th->throttle_events = json_object_has_member(tel, "ThrottleEvents")
+                              ? json_get_int64(tel, "ThrottleEvents") : -1;
+}
+
+static void json_get_scaling(JsonObject *obj, bench_scaling *sc)
+{
+    JsonArray *steps;
+    JsonObject *step;
+    guint i;
+
+    memset(sc, 0, sizeof(bench_scaling));
+    if (!json_object_has_member(obj, "ThreadScaling"))
+        return;
+
+    steps = json_object_get_array_member(obj, "ThreadScaling");
+    for (i = 0; steps && i < json_array_get_length(steps) &&
+                sc->n < BENCH_SCALING_MAX; i++) {
+        step = json_array_get_object_element(steps, i);
+        if (!step)
+            continue;
+        sc->step[sc->n].threads = json_get_int(step, "Threads");
+        sc->step[sc->n].result = json_get_double(step, "Result");
+        sc->n++;
+    }
+}
+
+static bench_curve *json_get_curve(JsonObject *obj)
+{
+    JsonArray *points;
+    JsonObject *point;
+    bench_curve *c;
+    guint i;
+
+    if (!json_object_has_member(obj, "WorkingSetSweep"))
+        return NULL;
+
+    c = g_new0(bench_curve, 1);
+    points = json_object_get_array_member(obj, "WorkingSetSweep");
+    for (i = 0; points && i < json_array_get_length(points) &&
+                c->n < BENCH_CURVE_MAX; i++) {
+        point = json_array_get_object_element(points, i);
+        if (!point || !json_object_has_member(point, "Bytes"))
+            continue;
+        c->point[c->n].bytes = json_get_int64(point, "Bytes");
+        c->point[c->n].result = json_get_double(point, "Result");
+        c->n++;
+    }
+    if (!c->n) {
+        g_free(c);
+        return NULL;
+    }
+    return c;
+}
+
+static void json_get_matrix_cells(JsonObject *obj, const gchar *key,
+                                  int n, double v[BENCH_MATRIX_MAX][BENCH_MATRIX_MAX])
+{
+    JsonArray *rows, *row;
+    JsonNode *cell;
+    int i, j;
+
+    if (!json_object_has_member(obj, key))
+        return;
+    rows = json_object_get_array_member(obj, key);
+    for (i = 0; rows && i < n && i < (int)json_array_get_length(rows); i++) {
+        row = json_array_get_array_element(rows, i);
+        for (j = 0; row && j < n && j < (int)json_array_get_length(row); j++) {
+            cell = json_array_get_element(row, j);
+            if (!JSON_NODE_HOLDS_NULL(cell))
+                v[i][j] = json_node_get_double(cell);
+        }
+    }
+}
+
+static bench_matrix *json_get_matrix(JsonObject *obj)
+{
+    JsonObject *mat;
+    JsonArray *ids;
+    bench_matrix *m;
+    int i;
+
+    if (!json_object_has_member(obj, "Matrix"))
+        return NULL;
+
+    mat = json_object_get_object_member(obj, "Matrix");
+    if (!mat || !json_object_has_member(mat, "Ids"))
+        return NULL;
+    ids = json_object_get_array_member(mat, "Ids");
+    if (!ids || !json_array_get_length(ids))
+        return NULL;
+
+    m = bench_matrix_new(json_array_get_length(ids),
+                         SEQ(json_get_string(mat, "Of"), "Cpus"));
+    for (i = 0; i < m->n; i++)
+        m->id[i] = json_array_get_int_element(ids, i);
+    json_get_matrix_cells(mat, "BandwidthGBs", m->n, m->gbs);
+    json_get_matrix_cells(mat, "LatencyNs", m->n, m->ns);
+    return m;
+}
+
 static double parse_frequency(const char *freq)
 {
     static locale_t locale;
@@ -433,8 +597,24 @@ bench_result *bench_result_benchmarkjson(const gchar *bench_name,
         .elapsed_time = json_get_double(machine, "ElapsedTime"),
         .threads_used = json_get_int(machine, "UsedThreads"),
         .revision = json_get_int(machine, "BenchmarkVersion"),//Revision
+        .stats = {
+            .n = json_get_int(machine, "Repetitions"),
+            .median = json_get_double(machine, "ResultMedian"),
+            .mean = json_get_double(machine, "ResultMean"),
+            .stddev = json_get_double(machine, "ResultStdDev"),
+            .min = json_get_double(machine, "ResultMin"),
+            .max = json_get_double(machine, "ResultMax"),
+            .ci95 = json_get_double(machine, "ResultCI95"),
+        },
     };
 
+    json_get_scaling(machine, &b->bvalue.scaling);
+    json_get_latency(machine, &b->bvalue.latency);
+    json_get_counters(machine, &b->bvalue.counters);
+    json_get_thermal(machine, &b->bvalue.thermal);
+    b->bvalue.curve = json_get_curve(machine);
+    b->bvalue.matrix = json_get_matrix(machine);
+
     snprintf(b->bvalue.extra, sizeof(b->bvalue.extra), "%s",
              json_get_string(machine, "ExtraInfo"));
     filter_invalid_chars(b->bvalue.extra);
@@ -469,9 +649,175 @@ bench_result *bench_result_benchmarkjson(const gchar *bench_name,
     return b;
 }
 
+/* one group of a matrix: a row of column ids, then a row per id */
+static char *matrix_group(char *ret, const bench_matrix *m, const char *title,
+                          const double v[BENCH_MATRIX_MAX][BENCH_MATRIX_MAX],
+                          const char *fmt)
+{
+    const char *what = m->cpus ? _("CPU") : _("Node");
+    GString *row = g_string_new(NULL);
+    int i, j;
+
+    for (j = 0; j < m->n; j++)
+        g_string_append_printf(row, "%s%8d", j ? " " : "", m->id[j]);
+    ret = h_strdup_cprintf("[%s]\n%s=%s\n", ret, title, _("From / To"), row->str);
+
+    for (i = 0; i < m->n; i++) {
+        g_string_truncate(row, 0);
+        for (j = 0; j < m->n; j++) {
+            g_string_append(row, j ? " " : "");
+            if (v[i][j] >= 0)
+                g_string_append_printf(row, fmt, v[i][j]);
+            else
+                g_string_append_printf(row, "%8s", "-");
+        }
+        ret = h_strdup_cprintf("%s %d=%s\n", ret, what, m->id[i], row->str);
+    }
+    g_string_free(row, TRUE);
+
+    return ret;
+}
+
+/* groups for thread sweeps, working set sweeps, matrices, latency,
+ * hardware counters and repeated runs; empty when the result has none
+ * of them */
+static char *bench_result_more_info_analysis(bench_result *b)
+{
+    bench_stats *s = &b->bvalue.stats;
+    bench_scaling *sc = &b->bvalue.scaling;
+    bench_latency *l = &b->bvalue.latency;
+    bench_counters *c = &b->bvalue.counters;
+    bench_thermal *th = &b->bvalue.thermal;
+    bench_curve *cv = b->bvalue.curve;
+    bench_matrix *m = b->bvalue.matrix;
+    char *ret = g_strdup("");
+    int i;
+
+    if (sc->n > 0) {
+        ret = h_strdup_cprintf("[%s]\n", ret, _("Thread Scaling"));
+        for (i = 0; i < sc->n; i++) {
+            ret = h_strdup_cprintf("%s %d=%0.2f (%s %0.0f%%)\n", ret,
+                                   _("Threads"), sc->step[i].threads,
+                                   sc->step[i].result, _("efficiency"),
+                                   100.0 * bench_scaling_efficiency(sc, i));
+        }
+    }
+
+    if (cv && cv->n > 0) {
+        ret = h_strdup_cprintf("[%s]\n", ret, _("Working Set Sweep"));
+        for (i = 0; i < cv->n; i++) {
+            gchar *size = size_human_readable(cv->point[i].bytes);
+            ret = h_strdup_cprintf("%s=%0.2f\n", ret, size, cv->point[i].result);
+            g_free(size);
+        }
+    }
+
+    if (m && m->n > 0 && bench_matrix_has_gbs(m))
+        ret = matrix_group(ret, m, _("Bandwidth Matrix (GB/s)"), m->gbs, "%8.2f");
+    if (m && m->n > 0 && bench_matrix_has_ns(m))
+        ret = matrix_group(ret, m, _("Latency Matrix (ns)"), m->ns, "%8.1f");
+
+    if (l->n > 0) {
+        const struct {
+            const char *name;
+            guint64 ns;
+        } pct[] = {
+            { "p50", l->p50 }, { "p90", l->p90 }, { "p99", l->p99 },
+            { "p99.9", l->p999 }, { _("Max"), l->max },
+        };
+
+        ret = h_strdup_cprintf("[%s]\n%s=%" G_GUINT64_FORMAT "\n", ret,
+                               _("Iteration Latency"), _("Iterations"), l->n);
+        for (i = 0; i < (int)G_N_ELEMENTS(pct); i++) {
+            gchar *t = bench_latency_format(pct[i].ns);
+            ret = h_strdup_cprintf("%s=%s\n", ret, pct[i].name, t);
+            g_free(t);
+        }
+    }
+
+    if (c->mask) {
+        const struct {
+            const char *name;
+            double value;
+            const char *fmt;
+        } metric[] = {
+            { _("Instructions per Cycle"),
+              bench_counters_ratio(c, BENCH_PERF_INSTRUCTIONS, BENCH_PERF_CYCLES, 1),
+              "%s=%0.2f\n" },
+            { _("Cache Miss Rate"),
+              bench_counters_ratio(c, BENCH_PERF_CACHE_MISSES, BENCH_PERF_CACHE_REFS, 100),
+              "%s=%0.2f%%\n" },
+            { _("Cache Misses per 1k Instructions"),
+              bench_counters_ratio(c, BENCH_PERF_CACHE_MISSES, BENCH_PERF_INSTRUCTIONS, 1000),
+              "%s=%0.2f\n" },
+            { _("LLC Misses per 1k Instructions"),
+              bench_counters_ratio(c, BENCH_PERF_LLC_MISSES, BENCH_PERF_INSTRUCTIONS, 1000),
+              "%s=%0.2f\n" },
+            { _("Branch Misses per 1k Instructions"),
+              bench_counters_ratio(c, BENCH_PERF_BRANCH_MISSES, BENCH_PERF_INSTRUCTIONS, 1000),
+              "%s=%0.2f\n" },
+        };
+
+        ret = h_strdup_cprintf("[%s]\n", ret, _("Hardware Counters"));
+        for (i = 0; i < (int)G_N_ELEMENTS(metric); i++) {
+            if (metric[i].value >= 0)
+                ret = h_strdup_cprintf(metric[i].fmt, ret, metric[i].name,
+                                       metric[i].value);
+        }
+        if (bench_counters_has(c, BENCH_PERF_CYCLES))
+            ret = h_strdup_cprintf("%s=%" G_GUINT64_FORMAT "\n", ret, _("Cycles"),
+                                   c->value[BENCH_PERF_CYCLES]);
+        if (bench_counters_has(c, BENCH_PERF_INSTRUCTIONS))
+            ret = h_strdup_cprintf("%s=%" G_GUINT64_FORMAT "\n", ret, _("Instructions"),
+                                   c->value[BENCH_PERF_INSTRUCTIONS]);
+    }
+
+    if (th->samples > 0) {
+        ret = h_strdup_cprintf("[%s]\n%s=%d\n", ret,
+                               _("Clocks and Temperature"), _("Samples"),
+                               th->samples);
+        if (th->mhz_max > 0)
+            ret = h_strdup_cprintf("%s=%0.0f / %0.0f / %0.0f %s\n", ret,
+                                   _("Frequency (min / avg / max)"),
+                                   th->mhz_min, th->mhz_avg, th->mhz_max,
+                                   _("MHz"));
+        if (th->has_temp)
+            ret = h_strdup_cprintf("%s=%0.1f °C\n", ret,
+                                   _("Maximum Temperature"), th->temp_max);
+        if (th->throttle_events >= 0)
+            ret = h_strdup_cprintf("%s=%s (%" G_GINT64_FORMAT " %s)\n", ret,
+                                   _("Throttled"),
+                                   th->throttled ? _("Yes") : _("No"),
+                                   th->throttle_events, _("events"));
+        else
+            ret = h_strdup_cprintf("%s=%s\n", ret, _("Throttled"),
+                                   th->throttled ? _("Yes") : _("No"));
+    }
+
+    if (s->n < 2)
+        return ret;
+
+    return h_strdup_cprintf(
+        "[%s]\n"
+        /* n */ "%s=%d\n"
+        /* median */ "%s=%0.2f\n"
+        /* mean */ "%s=%0.2f\n"
+        /* ci95 */ "%s=%0.2f - %0.2f\n"
+        /* stddev */ "%s=%0.2f (%0.1f%%)\n"
+        /* range */ "%s=%0.2f - %0.2f\n",
+        ret, _("Statistics"),
+        _("Repetitions"), s->n,
+        _("Median"), s->median,
+        _("Mean"), s->mean,
+        _("95% Confidence Interval"), s->mean - s->ci95, s->mean + s->ci95,
+        _("Standard Deviation"), s->stddev,
+        s->mean != 0 ? 100.0 * s->stddev / s->mean : 0.0,
+        _("Range"), s->min, s->max);
+}
+
 static char *bench_result_more_info_less(bench_result *b)
 {
-    char *memory = NULL;
+    char *memory = NULL, *analysis;
     if (b->machine->memory_phys_MiB) {
         memory =
             g_strdup_printf("%" PRId64 " %s %s", b->machine->memory_phys_MiB,
@@ -530,11 +876,15 @@ static char *bench_result_more_info_less(bench_result *b)
         _("Memory"), memory,
         b->machine->ptr_bits ? _("Pointer Size") : "#AddySize", bits);
     free(memory);
+    analysis = bench_result_more_info_analysis(b);
+    ret = h_strconcat(ret, analysis, NULL);
+    g_free(analysis);
     return ret;
 }
 
 static char *bench_result_more_info_complete(bench_result *b)
 {
+    char *ret, *analysis;
     char bench_str[256] = "";
     strncpy(bench_str, b->name, 127);
     if (b->bvalue.revision >= 0)
@@ -544,7 +894,7 @@ static char *bench_result_more_info_complete(bench_result *b)
     if (b->machine->ptr_bits)
         snprintf(bits, 23, _("%d-bit"), b->machine->ptr_bits);
 
-    return g_strdup_printf(
+    ret = g_strdup_printf(
         "[%s]\n"
         /* bench name */ "%s=%s\n"
         /* threads */ "%s=%d\n"
@@ -600,6 +950,11 @@ static char *bench_result_more_info_complete(bench_result *b)
         ".machine_data_version", b->machine->machine_data_version,
         ".is_su_data", b->machine->is_su_data, _("Handles"), _("mid"),
         b->machine->mid, _("cfg_val"), cpu_config_val(b->machine->cpu_config));
+
+    analysis = bench_result_more_info_analysis(b);
+    ret = h_strconcat(ret, analysis, NULL);
+    g_free(analysis);
+    return ret;
 }
 
 char *bench_result_more_info(bench_result *b)
@@ -0,0 +1,394 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <math.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* two-sided 95% critical values of Student's t, by degrees of freedom */
+static const double t95[] = {
+    0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+    2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093,
+    2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045,
+    2.042,
+};
+
+double bench_stats_t95(int df)
+{
+    if (df < 1)
+        return 0;
+    if (df < (int)G_N_ELEMENTS(t95))
+        return t95[df];
+    if (df < 60)
+        return 2.000;
+    if (df < 120)
+        return 1.980;
+    return 1.960;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+void bench_stats_compute(bench_stats *s, const double *samples, int n)
+{
+    double *sorted, sum = 0, sq = 0;
+    int i;
+
+    memset(s, 0, sizeof(bench_stats));
+    if (n < 1)
+        return;
+
+    sorted = g_new(double, n);
+    memcpy(sorted, samples, n * sizeof(double));
+    qsort(sorted, n, sizeof(double), cmp_double);
+
+    for (i = 0; i < n; i++)
+        sum += sorted[i];
+
+    s->n = n;
+    s->mean = sum / n;
+    s->min = sorted[0];
+    s->max = sorted[n - 1];
+    s->median = (n % 2) ? sorted[n / 2]
+                        : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+
+    if (n > 1) {
+        for (i = 0; i < n; i++)
+            sq += (sorted[i] - s->mean) * (sorted[i] - s->mean);
+        s->stddev = sqrt(sq / (n - 1));
+        s->ci95 = bench_stats_t95(n - 1) * s->stddev / sqrt(n);
+    }
+
+    g_free(sorted);
+}
+
+void bench_stats_scale(bench_stats *s, double factor)
+{
+    s->median *= factor;
+    s->mean *= factor;
+    s->min *= factor;
+    s->max *= factor;
+    s->stddev *= fabs(factor);
+    s->ci95 *= fabs(factor);
+    if (factor < 0) {
+        double t = s->min;
+        s->min = s->max;
+        s->max = t;
+    }
+}
+
+/* "n:median:mean:stddev:min:max:ci95", always with '.' as the decimal point */
+gchar *bench_stats_to_str(const bench_stats *s)
+{
+    gchar buf[6][G_ASCII_DTOSTR_BUF_SIZE];
+
+    return g_strdup_printf("%d:%s:%s:%s:%s:%s:%s", s->n,
+        g_ascii_formatd(buf[0], sizeof(buf[0]), "%.6g", s->median),
+        g_ascii_formatd(buf[1], sizeof(buf[1]), "%.6g", s->mean),
+        g_ascii_formatd(buf[2], sizeof(buf[2]), "%.6g", s->stddev),
+        g_ascii_formatd(buf[3], sizeof(buf[3]), "%.6g", s->min),
+        g_ascii_formatd(buf[4], sizeof(buf[4]), "%.6g", s->max),
+        g_ascii_formatd(buf[5], sizeof(buf[5]), "%.6g", s->ci95));
+}
+
+gboolean bench_stats_from_str(bench_stats *s, const gchar *str)
+{
+    gchar **f = g_strsplit(str, ":", -1);
+    gboolean ok = (g_strv_length(f) == 7);
+
+    memset(s, 0, sizeof(bench_stats));
+    if (ok) {
+        s->n = atoi(f[0]);
+        s->median = g_ascii_strtod(f[1], NULL);
+        s->mean = g_ascii_strtod(f[2], NULL);
+        s->stddev = g_ascii_strtod(f[3], NULL);
+        s->min = g_ascii_strtod(f[4], NULL);
+        s->max = g_ascii_strtod(f[5], NULL);
+        s->ci95 = g_ascii_strtod(f[6], NULL);
+    }
+    g_strfreev(f);
+
+    return ok;
+}
+
+double bench_scaling_efficiency(const bench_scaling *s, int step)
+{
+    if (step < 0 || step >= s->n || s->step[0].threads != 1 ||
+        s->step[0].result <= 0)
+        return 0;
+
+    return s->step[step].result /
+           (s->step[step].threads * s->step[0].result);
+}
+
+/* "threads:result,threads:result,..." */
+gchar *bench_scaling_to_str(const bench_scaling *s)
+{
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+    GString *str = g_string_new(NULL);
+    int i;
+
+    for (i = 0; i < s->n; i++) {
+        g_string_append_printf(str, "%s%d:%s", i ? "," : "",
+            s->step[i].threads,
+            g_ascii_formatd(buf, sizeof(buf), "%.6g", s->step[i].result));
+    }
+
+    return g_string_free(str, FALSE);
+}
+
+gboolean bench_scaling_from_str(bench_scaling *s, const gchar *str)
+{
+    gchar **steps = g_strsplit(str, ",", -1), *p;
+    int i;
+
+    memset(s, 0, sizeof(bench_scaling));
+    for (i = 0; steps[i] && s->n < BENCH_SCALING_MAX; i++) {
+        if (!(p = strchr(steps[i], ':')))
+            continue;
+        s->step[s->n].threads = atoi(steps[i]);
+        s->step[s->n].result = g_ascii_strtod(p + 1, NULL);
+        s->n++;
+    }
+    g_strfreev(steps);
+
+    return s->n > 0;
+}
+
+/* "bytes:result,bytes:result,..." */
+gchar *bench_curve_to_str(const bench_curve *c)
+{
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+    GString *str = g_string_new(NULL);
+    int i;
+
+    for (i = 0; i < c->n; i++) {
+        g_string_append_printf(str, "%s%" G_GUINT64_FORMAT ":%s", i ? "," : "",
+            c->point[i].bytes,
+            g_ascii_formatd(buf, sizeof(buf), "%.6g", c->point[i].result));
+    }
+
+    return g_string_free(str, FALSE);
+}
+
+gboolean bench_curve_from_str(bench_curve *c, const gchar *str)
+{
+    gchar **points = g_strsplit(str, ",", -1), *p;
+    int i;
+
+    memset(c, 0, sizeof(bench_curve));
+    for (i = 0; points[i] && c->n < BENCH_CURVE_MAX; i++) {
+        if (!(p = strchr(points[i], ':')))
+            continue;
+        c->point[c->n].bytes = g_ascii_strtoull(points[i], NULL, 10);
+        c->point[c->n].result = g_ascii_strtod(p + 1, NULL);
+        c->n++;
+    }
+    g_strfreev(points);
+
+    return c->n > 0;
+}
+
+/* all cells not measured */
+void bench_matrix_init(bench_matrix *m, int n, gboolean cpus)
+{
+    int i, j;
+
+    memset(m, 0, sizeof(bench_matrix));
+    m->n = MIN(n, BENCH_MATRIX_MAX);
+    m->cpus = cpus;
+    for (i = 0; i < BENCH_MATRIX_MAX; i++) {
+        for (j = 0; j < BENCH_MATRIX_MAX; j++)
+            m->gbs[i][j] = m->ns[i][j] = -1;
+    }
+}
+
+bench_matrix *bench_matrix_new(int n, gboolean cpus)
+{
+    bench_matrix *m = g_new(bench_matrix, 1);
+
+    bench_matrix_init(m, n, cpus);
+    return m;
+}
+
+static gboolean matrix_has(const bench_matrix *m,
+                           const double v[BENCH_MATRIX_MAX][BENCH_MATRIX_MAX])
+{
+    int i, j;
+
+    for (i = 0; i < m->n; i++) {
+        for (j = 0; j < m->n; j++) {
+            if (v[i][j] >= 0)
+                return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+gboolean bench_matrix_has_gbs(const bench_matrix *m)
+{
+    return matrix_has(m, m->gbs);
+}
+
+gboolean bench_matrix_has_ns(const bench_matrix *m)
+{
+    return matrix_has(m, m->ns);
+}
+
+/* "cpus:id,id,...:gbs,gbs,...:ns,ns,...", the cells row by row */
+gchar *bench_matrix_to_str(const bench_matrix *m)
+{
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+    GString *str = g_string_new(NULL);
+    int i;
+
+    g_string_append_printf(str, "%d:", m->cpus);
+    for (i = 0; i < m->n; i++)
+        g_string_append_printf(str, "%s%d", i ? "," : "", m->id[i]);
+    g_string_append_c(str, ':');
+    for (i = 0; i < m->n * m->n; i++) {
+        g_string_append_printf(str, "%s%s", i ? "," : "",
+            g_ascii_formatd(buf, sizeof(buf), "%.4g", m->gbs[i / m->n][i % m->n]));
+    }
+    g_string_append_c(str, ':');
+    for (i = 0; i < m->n * m->n; i++) {
+        g_string_append_printf(str, "%s%s", i ? "," : "",
+            g_ascii_formatd(buf, sizeof(buf), "%.4g", m->ns[i / m->n][i % m->n]));
+    }
+
+    return g_string_free(str, FALSE);
+}
+
+gboolean bench_matrix_from_str(bench_matrix *m, const gchar *str)
+{
+    gchar **f = g_strsplit(str, ":", -1), **ids = NULL, **gbs = NULL, **ns = NULL;
+    gboolean ok = (g_strv_length(f) == 4);
+    int i, n = 0;
+
+    bench_matrix_init(m, 0, FALSE);
+    if (ok) {
+        ids = g_strsplit(f[1], ",", -1);
+        gbs = g_strsplit(f[2], ",", -1);
+        ns = g_strsplit(f[3], ",", -1);
+        n = g_strv_length(ids);
+        ok = (n > 0 && n <= BENCH_MATRIX_MAX &&
+              g_strv_length(gbs) == (guint)(n * n) &&
+              g_strv_length(ns) == (guint)(n * n));
+    }
+    if (ok) {
+        bench_matrix_init(m, n, atoi(f[0]));
+        for (i = 0; i < n; i++)
+            m->id[i] = atoi(ids[i]);
+        for (i = 0; i < n * n; i++) {
+            m->gbs[i / n][i % n] = g_ascii_strtod(gbs[i], NULL);
+            m->ns[i / n][i % n] = g_ascii_strtod(ns[i], NULL);
+        }
+    }
+    g_strfreev(ids);
+    g_strfreev(gbs);
+    g_strfreev(ns);
+    g_strfreev(f);
+
+    return ok;
+}
+
+bench_value bench_value_copy(const bench_value *r)
+{
+    bench_value ret = *r;
+
+    if (r->curve) {
+        ret.curve = g_new(bench_curve, 1);
+        *ret.curve = *r->curve;
+    }
+    if (r->matrix) {
+        ret.matrix = g_new(bench_matrix, 1);
+        *ret.matrix = *r->matrix;
+    }
+    return ret;
+}
+
+void bench_value_free(bench_value *r)
+{
+    g_free(r->curve);
+    g_free(r->matrix);
+    r->curve = NULL;
+    r->matrix = NULL;
+}
+
+/* Welch's t-test of run against base; both need at least two samples.
+ * df is the Welch-Satterthwaite estimate. */
+gboolean bench_stats_welch(const bench_stats *base, const bench_stats *run,
+                           double *t, double *df)
+{
+    double va, vb, se2;
+
+    if (base->n < 2 || run->n < 2)
+        return FALSE;
+
+    va = base->stddev * base->stddev / base->n;
+    vb = run->stddev * run->stddev / run->n;
+    se2 = va + vb;
+    if (se2 <= 0) {
+        /* no spread at all: any difference is significant */
+        if (run->mean == base->mean)
+            *t = 0;
+        else
+            *t = (run->mean > base->mean) ? HUGE_VAL : -HUGE_VAL;
+        *df = base->n + run->n - 2;
+        return TRUE;
+    }
+
+    *t = (run->mean - base->mean) / sqrt(se2);
+    *df = se2 * se2 / (va * va / (base->n - 1) + vb * vb / (run->n - 1));
+    return TRUE;
+}
+
+/* Change of run against base in percent, positive when run is better.
+ * A result is faster or slower only when the change reaches
+ * threshold_pct and, if both sides have repetitions, the t-test finds
+ * it significant at 95%. */
+bench_verdict bench_stats_compare(const bench_stats *base, const bench_stats *run,
+                                  gboolean lower_is_better, double threshold_pct,
+                                  double *change_pct, gboolean *tested)
+{
+    double t, df, change;
+    gboolean significant = TRUE;
+
+    *change_pct = 0;
+    *tested = FALSE;
+    if (base->median == 0)
+        return BENCH_VERDICT_NOISE;
+
+    change = 100.0 * (run->median - base->median) / fabs(base->median);
+    if (lower_is_better)
+        change = -change;
+    *change_pct = change;
+
+    if (bench_stats_welch(base, run, &t, &df)) {
+        *tested = TRUE;
+        significant = (fabs(t) > bench_stats_t95((int)df));
+    }
+
+    if (!significant || fabs(change) < threshold_pct)
+        return BENCH_VERDICT_NOISE;
+    return change > 0 ? BENCH_VERDICT_FASTER : BENCH_VERDICT_SLOWER;
+}
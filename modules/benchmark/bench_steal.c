@@ -0,0 +1,234 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* Fork-join tasks on the worker pool, with work stealing.
+ *
+ * Every worker has a deque of tasks. A task spawns children onto the
+ * bottom of its own worker's deque and syncs on a join counter; while
+ * the count isn't zero, the worker runs tasks from the bottom of its
+ * deque, its latest children first, and then steals from the top of
+ * the others' deques, the oldest and usually largest tasks. Workers
+ * without tasks steal too. A full deque runs the child in place.
+ *
+ * The deques are locked, but only their owner uses them most of the
+ * time; a thief looks at the indices before taking the lock.
+ *
+ * bench_steal_for() runs the root task on worker 0 again and again for
+ * the time given, like benchmark_crunch_for() runs its callback, with
+ * the same clock and temperature sampling and hardware counters. */
+
+#define STEAL_DEQUE 4096
+#define STEAL_SPINS 64 /* failed steals before yielding */
+
+typedef struct {
+    BenchStealFunc func;
+    gpointer arg;
+    gint *join;
+} StealTask;
+
+typedef struct {
+    GMutex lock;
+    StealTask tasks[STEAL_DEQUE];
+    gint top, bottom; /* thieves take at top, the owner at bottom */
+    guint64 seed;     /* for the victims */
+    BenchStealWorker count;
+} StealDeque;
+
+struct _BenchSteal {
+    StealDeque **d;
+    gint n_workers;
+    BenchStealFunc func;
+    gpointer arg;
+    gint stop;
+    guint runs;
+    double elapsed;
+};
+
+static gboolean steal_push(StealDeque *d, const StealTask *t)
+{
+    gboolean ok = FALSE;
+
+    g_mutex_lock(&d->lock);
+    if (d->bottom - d->top < STEAL_DEQUE) {
+        d->tasks[d->bottom % STEAL_DEQUE] = *t;
+        g_atomic_int_set(&d->bottom, d->bottom + 1);
+        ok = TRUE;
+    }
+    g_mutex_unlock(&d->lock);
+    return ok;
+}
+
+static gboolean steal_pop(StealDeque *d, StealTask *t)
+{
+    gboolean ok = FALSE;
+
+    g_mutex_lock(&d->lock);
+    if (d->bottom > d->top) {
+        g_atomic_int_set(&d->bottom, d->bottom - 1);
+        *t = d->tasks[d->bottom % STEAL_DEQUE];
+        ok = TRUE;
+    }
+    g_mutex_unlock(&d->lock);
+    return ok;
+}
+
+static gboolean steal_take(StealDeque *d, StealTask *t)
+{
+    gboolean ok = FALSE;
+
+    if (g_atomic_int_get(&d->bottom) <= g_atomic_int_get(&d->top))
+        return FALSE;
+    g_mutex_lock(&d->lock);
+    if (d->bottom > d->top) {
+        *t = d->tasks[d->top % STEAL_DEQUE];
+        g_atomic_int_set(&d->top, d->top + 1);
+        ok = TRUE;
+    }
+    g_mutex_unlock(&d->lock);
+    return ok;
+}
+
+/* from a random victim, then the ones after it */
+static gboolean steal_any(BenchSteal *s, gint worker, StealTask *t)
+{
+    StealDeque *d = s->d[worker];
+    gint i, v;
+
+    if (s->n_workers < 2)
+        return FALSE;
+    d->seed ^= d->seed << 13;
+    d->seed ^= d->seed >> 7;
+    d->seed ^= d->seed << 17;
+    v = d->seed % s->n_workers;
+    for (i = 0; i < s->n_workers; i++, v = (v + 1) % s->n_workers) {
+        if (v != worker && steal_take(s->d[v], t)) {
+            d->count.steals++;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void steal_run(BenchSteal *s, gint worker, const StealTask *t)
+{
+    s->d[worker]->count.tasks++;
+    t->func(s, worker, t->arg);
+    g_atomic_int_add(t->join, -1);
+}
+
+void bench_steal_spawn(BenchSteal *s, gint worker, BenchStealFunc func,
+                       gpointer arg, gint *join)
+{
+    StealTask t = { func, arg, join };
+
+    g_atomic_int_inc(join);
+    if (!steal_push(s->d[worker], &t))
+        steal_run(s, worker, &t);
+}
+
+void bench_steal_sync(BenchSteal *s, gint worker, gint *join)
+{
+    StealTask t;
+    gint spins = 0;
+
+    while (g_atomic_int_get(join) > 0) {
+        if (steal_pop(s->d[worker], &t) || steal_any(s, worker, &t)) {
+            steal_run(s, worker, &t);
+            spins = 0;
+        } else if (++spins > STEAL_SPINS) {
+            g_thread_yield();
+            spins = 0;
+        }
+    }
+}
+
+static void steal_worker(gpointer task, gint worker)
+{
+    BenchSteal *s = task;
+    StealTask t;
+    guint64 t0;
+    gint spins = 0;
+
+    if (worker == 0) {
+        t0 = bench_hist_now_ns();
+        do {
+            s->func(s, 0, s->arg);
+            s->runs++;
+        } while (!g_atomic_int_get(&s->stop));
+        s->elapsed = (bench_hist_now_ns() - t0) / 1e9;
+        g_atomic_int_set(&s->stop, 2);
+        return;
+    }
+
+    while (g_atomic_int_get(&s->stop) < 2) {
+        if (steal_any(s, worker, &t)) {
+            steal_run(s, worker, &t);
+            spins = 0;
+        } else if (++spins > STEAL_SPINS) {
+            g_thread_yield();
+            spins = 0;
+        }
+    }
+}
+
+bench_value bench_steal_for(float seconds, gint n_workers, BenchStealFunc func,
+                            gpointer arg, BenchStealWorker *counts)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    BenchTelemetry *telemetry;
+    BenchSteal s;
+    gpointer *tasks;
+    gint i;
+
+    memset(&s, 0, sizeof(s));
+    s.n_workers = r.threads_used = benchmark_threads(n_workers);
+    s.func = func;
+    s.arg = arg;
+    s.d = g_new0(StealDeque *, s.n_workers);
+    tasks = g_new0(gpointer, s.n_workers);
+    for (i = 0; i < s.n_workers; i++) {
+        s.d[i] = g_new0(StealDeque, 1);
+        g_mutex_init(&s.d[i]->lock);
+        s.d[i]->seed = 0x9e3779b97f4a7c15ULL * (i + 1);
+        tasks[i] = &s;
+    }
+
+    telemetry = bench_telemetry_new(s.n_workers);
+    bench_pool_start(s.n_workers, steal_worker, tasks);
+    bench_telemetry_sleep(telemetry, seconds);
+    g_atomic_int_set(&s.stop, 1);
+    bench_pool_wait();
+    bench_telemetry_finish(telemetry, &r.thermal);
+    bench_pool_counters(&r.counters);
+
+    r.result = s.runs;
+    r.elapsed_time = s.elapsed;
+    for (i = 0; i < s.n_workers; i++) {
+        if (counts)
+            counts[i] = s.d[i]->count;
+        g_mutex_clear(&s.d[i]->lock);
+        g_free(s.d[i]);
+    }
+    g_free(s.d);
+    g_free(tasks);
+
+    return r;
+}
@@ -0,0 +1,366 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include "hardinfo.h"
+#include "benchmark.h"
+#include "cpu_util.h"
+#include "cpubits.h"
+
+/* Clock and temperature samples taken while a benchmark runs.
+ *
+ * The caller samples from the thread that would otherwise just sleep
+ * through the run, so nothing extra competes with the workers. Each
+ * sample reads scaling_cur_freq of the cpus the workers run on (all
+ * online cpus when they are not pinned) and the cpu package sensors,
+ * the same hwmon/thermal files the sensors page reads.
+ *
+ * Throttling comes from the x86 thermal_throttle counters. Without them,
+ * a run counts as throttled when the fastest watched cpu of a sample
+ * ran more than 10% below the fastest seen earlier in the run. */
+
+struct _BenchTelemetry {
+    cpufreq_data **cpufd;
+    gint n_cpus;
+    GSList *temp_paths;
+    gint64 throttle_start; /* -1 without counters */
+
+    gint samples;
+    gint mhz_samples;
+    double mhz_min, mhz_max, mhz_sum;
+    double peak_max; /* fastest cpu, highest so far */
+    gboolean clock_drop;
+    double temp_max;
+    gboolean has_temp;
+};
+
+/* hwmon drivers for cpu package/die temperature */
+static const gchar *cpu_hwmon_names[] = {
+    "coretemp", "k10temp", "zenpower", "cpu_thermal", "soc_thermal", NULL
+};
+
+/* thermal zone types for the same */
+static const gchar *cpu_zone_types[] = {
+    "x86_pkg_temp", "cpu", "soc", NULL
+};
+
+static gchar *sysfs_str(const gchar *path)
+{
+    gchar *tmp = NULL;
+
+    if (g_file_get_contents(path, &tmp, NULL, NULL))
+        g_strstrip(tmp);
+    return tmp;
+}
+
+static gboolean name_matches(const gchar *name, const gchar **list)
+{
+    for (; *list; list++) {
+        if (g_str_has_prefix(name, *list))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static GSList *find_temp_paths(void)
+{
+    GSList *paths = NULL;
+    const gchar *entry, *item;
+    gchar *path, *name;
+    GDir *dir, *hw;
+
+    if ((dir = g_dir_open("/sys/class/hwmon", 0, NULL))) {
+        while ((entry = g_dir_read_name(dir))) {
+            path = g_strdup_printf("/sys/class/hwmon/%s/name", entry);
+            name = sysfs_str(path);
+            g_free(path);
+            if (name && name_matches(name, cpu_hwmon_names)) {
+                path = g_strdup_printf("/sys/class/hwmon/%s", entry);
+                if ((hw = g_dir_open(path, 0, NULL))) {
+                    while ((item = g_dir_read_name(hw))) {
+                        if (g_str_has_prefix(item, "temp") &&
+                            g_str_has_suffix(item, "_input"))
+                            paths = g_slist_prepend(paths,
+                                g_strdup_printf("%s/%s", path, item));
+                    }
+                    g_dir_close(hw);
+                }
+                g_free(path);
+            }
+            g_free(name);
+        }
+        g_dir_close(dir);
+    }
+
+    if (paths || !(dir = g_dir_open("/sys/class/thermal", 0, NULL)))
+        return paths;
+
+    while ((entry = g_dir_read_name(dir))) {
+        if (!g_str_has_prefix(entry, "thermal_zone"))
+            continue;
+        path = g_strdup_printf("/sys/class/thermal/%s/type", entry);
+        name = sysfs_str(path);
+        g_free(path);
+        if (name && name_matches(name, cpu_zone_types))
+            paths = g_slist_prepend(paths,
+                g_strdup_printf("/sys/class/thermal/%s/temp", entry));
+        g_free(name);
+    }
+    g_dir_close(dir);
+
+    return paths;
+}
+
+/* core counters once for each core of the watched cpus, and the package
+ * counter once for each package they are in: every cpu of a core or a
+ * package shows the same one */
+static gint64 throttle_count(BenchTelemetry *t)
+{
+    cpubits *packages = cpubits_from_str(NULL);
+    GHashTable *cores = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    gint64 sum = 0;
+    gint i, v, pkg, core, found = 0;
+    gchar *key;
+
+    for (i = 0; i < t->n_cpus; i++) {
+        pkg = get_cpu_int("topology/physical_package_id", t->cpufd[i]->id, 0);
+        core = get_cpu_int("topology/core_id", t->cpufd[i]->id, t->cpufd[i]->id);
+        key = g_strdup_printf("%d:%d", pkg, core);
+        if (g_hash_table_lookup(cores, key)) {
+            g_free(key);
+        } else {
+            g_hash_table_insert(cores, key, GINT_TO_POINTER(1));
+            v = get_cpu_int("thermal_throttle/core_throttle_count", t->cpufd[i]->id, -1);
+            if (v >= 0) {
+                sum += v;
+                found++;
+            }
+        }
+        if (pkg < 0 || pkg >= CPUBITS_SIZE * 8 || CPUBIT_GET(packages, pkg))
+            continue;
+        CPUBIT_SET(packages, pkg);
+        v = get_cpu_int("thermal_throttle/package_throttle_count", t->cpufd[i]->id, -1);
+        if (v >= 0)
+            sum += v;
+    }
+    free(packages);
+    g_hash_table_destroy(cores);
+    return found ? sum : -1;
+}
+
+static gint *watched_cpus(gint n_threads, gint *n_cpus)
+{
+    const bench_placement *pl = bench_placement_get();
+    gchar *tmp = NULL;
+    cpubits *bits;
+    gint *cpus, i, n = 0, max;
+
+    if (pl->n_cpus) {
+        bits = cpubits_from_str(NULL);
+        for (i = 0; i < n_threads; i++)
+            CPUBIT_SET(bits, pl->cpus[i % pl->n_cpus]);
+    } else {
+        if (!g_file_get_contents("/sys/devices/system/cpu/online", &tmp, NULL, NULL)) {
+            *n_cpus = 0;
+            return NULL;
+        }
+        bits = cpubits_from_str(g_strstrip(tmp));
+        g_free(tmp);
+    }
+
+    max = cpubits_max(bits);
+    cpus = g_new0(gint, cpubits_count(bits) + 1);
+    for (i = 0; i <= max; i++) {
+        if (CPUBIT_GET(bits, i))
+            cpus[n++] = i;
+    }
+    free(bits);
+
+    *n_cpus = n;
+    return cpus;
+}
+
+BenchTelemetry *bench_telemetry_new(gint n_threads)
+{
+    BenchTelemetry *t = g_new0(BenchTelemetry, 1);
+    gint *cpus, i;
+
+    cpus = watched_cpus(n_threads, &t->n_cpus);
+    t->cpufd = g_new0(cpufreq_data *, t->n_cpus);
+    for (i = 0; i < t->n_cpus; i++)
+        t->cpufd[i] = cpufreq_new(cpus[i]);
+    g_free(cpus);
+
+    t->temp_paths = find_temp_paths();
+    t->throttle_start = throttle_count(t);
+    t->mhz_min = G_MAXDOUBLE;
+
+    return t;
+}
+
+void bench_telemetry_sample(BenchTelemetry *t)
+{
+    double mhz, sample_max = 0;
+    gchar *tmp;
+    GSList *l;
+    gint i;
+
+    t->samples++;
+
+    for (i = 0; i < t->n_cpus; i++) {
+        cpufreq_update(t->cpufd[i], 1);
+        if (t->cpufd[i]->cpukhz_cur <= 0)
+            continue;
+        mhz = t->cpufd[i]->cpukhz_cur / 1000.0;
+        t->mhz_min = MIN(t->mhz_min, mhz);
+        t->mhz_max = MAX(t->mhz_max, mhz);
+        t->mhz_sum += mhz;
+        t->mhz_samples++;
+        sample_max = MAX(sample_max, mhz);
+    }
+    if (sample_max > 0) {
+        if (sample_max < t->peak_max * 0.9)
+            t->clock_drop = TRUE;
+        t->peak_max = MAX(t->peak_max, sample_max);
+    }
+
+    for (l = t->temp_paths; l; l = l->next) {
+        if ((tmp = sysfs_str(l->data))) {
+            double c = atoi(tmp) / 1000.0;
+            if (!t->has_temp || c > t->temp_max)
+                t->temp_max = c;
+            t->has_temp = TRUE;
+            g_free(tmp);
+        }
+    }
+}
+
+/* sleeps for seconds, sampling every BENCH_TELEMETRY_INTERVAL_MS */
+void bench_telemetry_sleep(BenchTelemetry *t, double seconds)
+{
+    gint64 end = g_get_monotonic_time() + (gint64)(seconds * G_USEC_PER_SEC);
+    gint64 now, step = BENCH_TELEMETRY_INTERVAL_MS * 1000;
+
+    while ((now = g_get_monotonic_time()) < end) {
+        g_usleep(MIN(step, end - now));
+        if (g_get_monotonic_time() < end)
+            bench_telemetry_sample(t);
+    }
+}
+
+void bench_telemetry_finish(BenchTelemetry *t, bench_thermal *th)
+{
+    gint64 throttle_end;
+    gint i;
+
+    memset(th, 0, sizeof(bench_thermal));
+    th->samples = t->samples;
+    if (t->mhz_samples) {
+        th->mhz_min = t->mhz_min;
+        th->mhz_avg = t->mhz_sum / t->mhz_samples;
+        th->mhz_max = t->mhz_max;
+    }
+    th->has_temp = t->has_temp;
+    th->temp_max = t->temp_max;
+
+    throttle_end = throttle_count(t);
+    if (t->throttle_start >= 0 && throttle_end >= 0) {
+        th->throttle_events = throttle_end - t->throttle_start;
+        th->throttled = th->throttle_events > 0;
+    } else {
+        th->throttle_events = -1;
+        th->throttled = t->clock_drop;
+        if (!t->mhz_samples && !t->has_temp)
+            th->samples = 0; /* nothing to tell */
+    }
+
+    for (i = 0; i < t->n_cpus; i++)
+        cpufreq_free(t->cpufd[i]);
+    g_free(t->cpufd);
+    g_slist_free_full(t->temp_paths, g_free);
+    g_free(t);
+}
+
+/* for repeated runs */
+void bench_thermal_merge(bench_thermal *dst, const bench_thermal *src)
+{
+    if (!src->samples)
+        return;
+    if (!dst->samples) {
+        *dst = *src;
+        return;
+    }
+
+    if (src->mhz_max > 0) {
+        if (dst->mhz_max > 0) {
+            dst->mhz_avg = (dst->mhz_avg * dst->samples + src->mhz_avg * src->samples) /
+                           (dst->samples + src->samples);
+            dst->mhz_min = MIN(dst->mhz_min, src->mhz_min);
+            dst->mhz_max = MAX(dst->mhz_max, src->mhz_max);
+        } else {
+            dst->mhz_min = src->mhz_min;
+            dst->mhz_avg = src->mhz_avg;
+            dst->mhz_max = src->mhz_max;
+        }
+    }
+    if (src->has_temp) {
+        dst->temp_max = dst->has_temp ? MAX(dst->temp_max, src->temp_max) : src->temp_max;
+        dst->has_temp = TRUE;
+    }
+    if (src->throttle_events >= 0 && dst->throttle_events >= 0)
+        dst->throttle_events += src->throttle_events;
+    else
+        dst->throttle_events = -1;
+    dst->throttled = dst->throttled || src->throttled;
+    dst->samples += src->samples;
+}
+
+/* "samples:mhz_min:mhz_avg:mhz_max:has_temp:temp_max:throttled:events" */
+gchar *bench_thermal_to_str(const bench_thermal *th)
+{
+    gchar buf[4][G_ASCII_DTOSTR_BUF_SIZE];
+
+    return g_strdup_printf("%d:%s:%s:%s:%d:%s:%d:%" G_GINT64_FORMAT,
+        th->samples,
+        g_ascii_formatd(buf[0], sizeof(buf[0]), "%.1f", th->mhz_min),
+        g_ascii_formatd(buf[1], sizeof(buf[1]), "%.1f", th->mhz_avg),
+        g_ascii_formatd(buf[2], sizeof(buf[2]), "%.1f", th->mhz_max),
+        th->has_temp,
+        g_ascii_formatd(buf[3], sizeof(buf[3]), "%.1f", th->temp_max),
+        th->throttled, th->throttle_events);
+}
+
+gboolean bench_thermal_from_str(bench_thermal *th, const gchar *str)
+{
+    gchar **f = g_strsplit(str, ":", -1);
+    gboolean ok = (g_strv_length(f) == 8);
+
+    memset(th, 0, sizeof(bench_thermal));
+    if (ok) {
+        th->samples = atoi(f[0]);
+        th->mhz_min = g_ascii_strtod(f[1], NULL);
+        th->mhz_avg = g_ascii_strtod(f[2], NULL);
+        th->mhz_max = g_ascii_strtod(f[3], NULL);
+        th->has_temp = atoi(f[4]);
+        th->temp_max = g_ascii_strtod(f[5], NULL);
+        th->throttled = atoi(f[6]);
+        th->throttle_events = g_ascii_strtoll(f[7], NULL, 10);
+    }
+    g_strfreev(f);
+
+    return ok;
+}
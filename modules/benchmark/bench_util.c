@@ -1,5 +1,9 @@
 
+#include <sys/mman.h>
+
 #include "benchmark.h"
+#include "cpu_util.h"
+#include "cpubits.h"
 #include "md5.h"
 
 gchar *get_test_data(gsize min_size) {
@@ -35,6 +39,81 @@ gchar *get_test_data(gsize min_size) {
     return data;
 }
 
+/* The highest level cache of cpu0, times the number of such caches:
+ * online cpus / cpus sharing it. */
+gsize bench_llc_bytes(void)
+{
+    GSList *caches, *l;
+    cpu_cache_data *c, *best = NULL;
+    gint shared = 1, online;
+    gsize size = 0;
+    cpubits *bits;
+
+    caches = cpucache_list_new(0);
+    for (l = caches; l; l = l->next) {
+        c = l->data;
+        if (!best || c->level > best->level ||
+            (c->level == best->level && c->size > best->size))
+            best = c;
+    }
+    if (best) {
+        size = (gsize)best->size << 10;
+        if (best->shared_cpu_list) {
+            bits = cpubits_from_str(best->shared_cpu_list);
+            shared = MAX(cpubits_count(bits), 1);
+            free(bits);
+        }
+    }
+    cpucache_list_free(caches);
+
+    online = sysconf(_SC_NPROCESSORS_ONLN);
+    if (!size || online < 1)
+        return 0;
+    return size * MAX(online / shared, 1);
+}
+
+/* aligned for transparent huge pages where the kernel has them;
+ * free() it */
+gchar *bench_huge_alloc(gsize bytes)
+{
+    void *buf = NULL;
+
+    if (posix_memalign(&buf, 2 << 20, bytes))
+        return NULL;
+#ifdef MADV_HUGEPAGE
+    madvise(buf, bytes, MADV_HUGEPAGE);
+#endif
+    return buf;
+}
+
+/* the cpu flags of the devices module, as in /proc/cpuinfo; NULL if it
+ * has none. g_strfreev() it */
+gchar **bench_cpu_flags(void)
+{
+    gchar *tmp, **flags = NULL;
+
+    if ((tmp = module_call_method("devices::getProcessorFlags"))) {
+        if (*g_strstrip(tmp))
+            flags = g_strsplit(tmp, " ", -1);
+        g_free(tmp);
+    }
+    return flags;
+}
+
+gboolean bench_cpu_has(gchar **flags, const gchar *needed)
+{
+    gchar **need = g_strsplit(needed, " ", -1);
+    gboolean ok = TRUE;
+    gint i;
+
+    for (i = 0; need[i] && ok; i++) {
+        if (*need[i])
+            ok = g_strv_contains((const gchar * const *)flags, need[i]);
+    }
+    g_strfreev(need);
+    return ok;
+}
+
 char *digest_to_str(const char *digest, int len) {
     int max = len * 2;
     char *ret = malloc(max+1);
@@ -56,3 +135,23 @@ char *md5_digest_str(const char *data, unsigned int len) {
     MD5Final(digest, &ctx);
     return digest_to_str((char *)digest, 16);
 }
+
+void bench_value_append_extra(bench_value *r, const char *fmt, ...)
+{
+    gchar *str, *p;
+    size_t len = strlen(r->extra);
+    va_list ap;
+
+    va_start(ap, fmt);
+    str = g_strdup_vprintf(fmt, ap);
+    va_end(ap);
+
+    for (p = str; *p; p++) {
+        if (*p == '\n' || *p == ';' || *p == '|')
+            *p = '_';
+    }
+
+    snprintf(r->extra + len, sizeof(r->extra) - len, "%s%s",
+             len ? ", " : "", str);
+    g_free(str);
+}
@@ -44,23 +44,59 @@ void SN(gboolean reload) { \
     BENCH_SCAN_SIMPLE(scan_##BF, BF, BID, BN);
 
 // ID, NAME, FUNCTION, R (0 = lower is better, 1 = higher is better)
-BENCH_SIMPLE(BENCHMARK_FIB, "CPU Fibonacci", benchmark_fib, 1);
-BENCH_SIMPLE(BENCHMARK_NQUEENS, "CPU N-Queens", benchmark_nqueens, 1);
-BENCH_SIMPLE(BENCHMARK_FFT, "FPU FFT", benchmark_fft, 1);
-BENCH_SIMPLE(BENCHMARK_RAYTRACE, "FPU Raytracing (Single-thread)", benchmark_raytrace, 1);
-BENCH_SIMPLE(BENCHMARK_BLOWFISH_SINGLE, "CPU Blowfish (Single-thread)", benchmark_bfish_single, 1);
-BENCH_SIMPLE(BENCHMARK_BLOWFISH_THREADS, "CPU Blowfish (Multi-thread)", benchmark_bfish_threads, 1);
-BENCH_SIMPLE(BENCHMARK_BLOWFISH_CORES, "CPU Blowfish (Multi-core)", benchmark_bfish_cores, 1);
-BENCH_SIMPLE(BENCHMARK_ZLIB, "CPU Zlib", benchmark_zlib, 1);
-BENCH_SIMPLE(BENCHMARK_CRYPTOHASH, "CPU CryptoHash", benchmark_cryptohash, 1);
-BENCH_SIMPLE(BENCHMARK_IPERF3_SINGLE, "Internal Network Speed", benchmark_iperf3_single, 1);
-BENCH_SIMPLE(BENCHMARK_SBCPU_SINGLE, "SysBench CPU (Single-thread)", benchmark_sbcpu_single, 1);
-BENCH_SIMPLE(BENCHMARK_SBCPU_ALL, "SysBench CPU (Multi-thread)", benchmark_sbcpu_all, 1);
-BENCH_SIMPLE(BENCHMARK_SBCPU_QUAD, "SysBench CPU (Four threads)", benchmark_sbcpu_quad, 1);
-BENCH_SIMPLE(BENCHMARK_MEMORY_SINGLE, "SysBench Memory (Single-thread)", benchmark_memory_single, 1);
-BENCH_SIMPLE(BENCHMARK_MEMORY_DUAL, "SysBench Memory (Two threads)", benchmark_memory_dual, 1);
-BENCH_SIMPLE(BENCHMARK_MEMORY_QUAD, "SysBench Memory (Quad threads)", benchmark_memory_quad, 1);
-BENCH_SIMPLE(BENCHMARK_MEMORY_ALL, "SysBench Memory (Multi-thread)", benchmark_memory_all, 1);
+#define BENCH_SIMPLE_LIST(X) \
+    X(BENCHMARK_FIB, "CPU Fibonacci", benchmark_fib, 1) \
+    X(BENCHMARK_NQUEENS, "CPU N-Queens", benchmark_nqueens, 1) \
+    X(BENCHMARK_FFT, "FPU FFT", benchmark_fft, 1) \
+    X(BENCHMARK_RAYTRACE, "FPU Raytracing (Single-thread)", benchmark_raytrace, 1) \
+    X(BENCHMARK_BLOWFISH_SINGLE, "CPU Blowfish (Single-thread)", benchmark_bfish_single, 1) \
+    X(BENCHMARK_BLOWFISH_THREADS, "CPU Blowfish (Multi-thread)", benchmark_bfish_threads, 1) \
+    X(BENCHMARK_BLOWFISH_CORES, "CPU Blowfish (Multi-core)", benchmark_bfish_cores, 1) \
+    X(BENCHMARK_ZLIB, "CPU Zlib", benchmark_zlib, 1) \
+    X(BENCHMARK_CRYPTOHASH, "CPU CryptoHash", benchmark_cryptohash, 1) \
+    X(BENCHMARK_IPERF3_SINGLE, "Internal Network Speed", benchmark_iperf3_single, 1) \
+    X(BENCHMARK_SBCPU_SINGLE, "SysBench CPU (Single-thread)", benchmark_sbcpu_single, 1) \
+    X(BENCHMARK_SBCPU_ALL, "SysBench CPU (Multi-thread)", benchmark_sbcpu_all, 1) \
+    X(BENCHMARK_SBCPU_QUAD, "SysBench CPU (Four threads)", benchmark_sbcpu_quad, 1) \
+    X(BENCHMARK_MEMORY_SINGLE, "SysBench Memory (Single-thread)", benchmark_memory_single, 1) \
+    X(BENCHMARK_MEMORY_DUAL, "SysBench Memory (Two threads)", benchmark_memory_dual, 1) \
+    X(BENCHMARK_MEMORY_QUAD, "SysBench Memory (Quad threads)", benchmark_memory_quad, 1) \
+    X(BENCHMARK_MEMORY_ALL, "SysBench Memory (Multi-thread)", benchmark_memory_all, 1) \
+    X(BENCHMARK_STREAM_SINGLE, "Memory Bandwidth (Single-thread)", benchmark_stream_single, 1) \
+    X(BENCHMARK_STREAM_DUAL, "Memory Bandwidth (Two threads)", benchmark_stream_dual, 1) \
+    X(BENCHMARK_STREAM_QUAD, "Memory Bandwidth (Four threads)", benchmark_stream_quad, 1) \
+    X(BENCHMARK_STREAM_ALL, "Memory Bandwidth (Multi-thread)", benchmark_stream_all, 1) \
+    X(BENCHMARK_MEMORY_LATENCY, "Memory Latency", benchmark_memory_latency, 0) \
+    X(BENCHMARK_NUMA, "NUMA Bandwidth and Latency", benchmark_numa, 1) \
+    X(BENCHMARK_STORAGE, "Storage I/O", benchmark_storage, 1) \
+    X(BENCHMARK_LOOPBACK_TCP_SINGLE, "Loopback TCP (Single stream)", benchmark_loopback_tcp_single, 1) \
+    X(BENCHMARK_LOOPBACK_TCP_ALL, "Loopback TCP (Multi-stream)", benchmark_loopback_tcp_all, 1) \
+    X(BENCHMARK_LOOPBACK_UNIX_SINGLE, "Loopback Unix Socket (Single stream)", benchmark_loopback_unix_single, 1) \
+    X(BENCHMARK_LOOPBACK_UNIX_ALL, "Loopback Unix Socket (Multi-stream)", benchmark_loopback_unix_all, 1) \
+    X(BENCHMARK_LOOPBACK_ZEROCOPY, "Loopback TCP (MSG_ZEROCOPY)", benchmark_loopback_zerocopy, 1) \
+    X(BENCHMARK_LOOPBACK_SENDFILE, "Loopback TCP (sendfile)", benchmark_loopback_sendfile, 1) \
+    X(BENCHMARK_LOOPBACK_LATENCY, "Loopback Latency", benchmark_loopback_latency, 0) \
+    X(BENCHMARK_FLOPS_SINGLE, "FPU SIMD FLOPS (Single-thread)", benchmark_flops_single, 1) \
+    X(BENCHMARK_FLOPS_ALL, "FPU SIMD FLOPS (Multi-thread)", benchmark_flops_all, 1) \
+    X(BENCHMARK_ZLIB_LEVELS, "CPU Zlib Levels (Multi-thread)", benchmark_zlib_levels, 1) \
+    X(BENCHMARK_ZLIB_STREAMING, "CPU Zlib Streaming (Single-thread)", benchmark_zlib_streaming, 1) \
+    X(BENCHMARK_SHA256, "CPU SHA-256", benchmark_sha256, 1) \
+    X(BENCHMARK_CRC32C, "CPU CRC32C", benchmark_crc32c, 1) \
+    X(BENCHMARK_AES_SINGLE, "CPU AES (Single-thread)", benchmark_aes_single, 1) \
+    X(BENCHMARK_AES_ALL, "CPU AES (Multi-thread)", benchmark_aes_all, 1) \
+    X(BENCHMARK_DGEMM, "FPU DGEMM (Multi-thread)", benchmark_dgemm, 1) \
+    X(BENCHMARK_SGEMM, "FPU SGEMM (Multi-thread)", benchmark_sgemm, 1) \
+    X(BENCHMARK_NQUEENS_STEAL, "CPU N-Queens (Work-stealing)", benchmark_nqueens_steal, 1) \
+    X(BENCHMARK_FIB_TASKS, "CPU Fibonacci (Tasks)", benchmark_fib_tasks, 1) \
+    X(BENCHMARK_BVH_RAYTRACE_SINGLE, "FPU BVH Raytracing (Single-thread)", benchmark_bvh_raytrace_single, 1) \
+    X(BENCHMARK_BVH_RAYTRACE_ALL, "FPU BVH Raytracing (Multi-thread)", benchmark_bvh_raytrace_all, 1) \
+    X(BENCHMARK_KPATH_SYSCALL, "Kernel Syscall", benchmark_kpath_syscall, 0) \
+    X(BENCHMARK_KPATH_SWITCH, "Kernel Context Switch", benchmark_kpath_switch, 0) \
+    X(BENCHMARK_KPATH_FUTEX, "Kernel Futex Wake", benchmark_kpath_futex, 0) \
+    X(BENCHMARK_KPATH_CLOCK, "Kernel clock_gettime", benchmark_kpath_clock, 0) \
+    X(BENCHMARK_C2C, "CPU Core-to-Core Latency", benchmark_c2c, 0)
+
+BENCH_SIMPLE_LIST(BENCH_SIMPLE)
 
 BENCH_CALLBACK(callback_benchmark_gui, "GPU Drawing", BENCHMARK_GUI, 1);
 void scan_benchmark_gui(gboolean reload)
@@ -104,8 +140,53 @@ static char *entries_english_name[] = {
             "SysBench Memory (Two threads)",
             "SysBench Memory (Quad threads)",
             "SysBench Memory (Multi-thread)",
+            "Memory Bandwidth (Single-thread)",
+            "Memory Bandwidth (Two threads)",
+            "Memory Bandwidth (Four threads)",
+            "Memory Bandwidth (Multi-thread)",
+            "Memory Latency",
+            "NUMA Bandwidth and Latency",
+            "Storage I/O",
+            "Loopback TCP (Single stream)",
+            "Loopback TCP (Multi-stream)",
+            "Loopback Unix Socket (Single stream)",
+            "Loopback Unix Socket (Multi-stream)",
+            "Loopback TCP (MSG_ZEROCOPY)",
+            "Loopback TCP (sendfile)",
+            "Loopback Latency",
+            "FPU SIMD FLOPS (Single-thread)",
+            "FPU SIMD FLOPS (Multi-thread)",
+            "CPU Zlib Levels (Multi-thread)",
+            "CPU Zlib Streaming (Single-thread)",
+            "CPU SHA-256",
+            "CPU CRC32C",
+            "CPU AES (Single-thread)",
+            "CPU AES (Multi-thread)",
+            "FPU DGEMM (Multi-thread)",
+            "FPU SGEMM (Multi-thread)",
+            "CPU N-Queens (Work-stealing)",
+            "CPU Fibonacci (Tasks)",
+            "FPU BVH Raytracing (Single-thread)",
+            "FPU BVH Raytracing (Multi-thread)",
+            "Kernel Syscall",
+            "Kernel Context Switch",
+            "Kernel Futex Wake",
+            "Kernel clock_gettime",
+            "CPU Core-to-Core Latency",
             "GPU Drawing"};
 
+//Note: benchmarks with R = 0 above, used to compare against a baseline
+#define BENCH_LOWER_IS_BETTER(BID, BN, BF, R) [BID] = !(R),
+static const gboolean entries_lower_is_better[BENCHMARK_N_ENTRIES] = {
+            BENCH_SIMPLE_LIST(BENCH_LOWER_IS_BETTER)};
+
+//Note: benchmarks that pin their own workers; no placement note or thread sweep
+static const gboolean entries_pinned[BENCHMARK_N_ENTRIES] = {
+            [BENCHMARK_NUMA] = TRUE,
+            [BENCHMARK_KPATH_SWITCH] = TRUE,
+            [BENCHMARK_KPATH_FUTEX] = TRUE,
+            [BENCHMARK_C2C] = TRUE};
+
 
 static ModuleEntry entries[] = {
     [BENCHMARK_BLOWFISH_SINGLE] =
@@ -244,6 +325,270 @@ static ModuleEntry entries[] = {
             scan_benchmark_memory_all,
             MODULE_FLAG_NONE,
         },
+    [BENCHMARK_STREAM_SINGLE] =
+        {
+            N_("Memory Bandwidth (Single-thread)"),
+            "memory.png",
+            callback_benchmark_stream_single,
+            scan_benchmark_stream_single,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_STREAM_DUAL] =
+        {
+            N_("Memory Bandwidth (Two threads)"),
+            "memory.png",
+            callback_benchmark_stream_dual,
+            scan_benchmark_stream_dual,
+            MODULE_FLAG_HIDE,
+        },
+    [BENCHMARK_STREAM_QUAD] =
+        {
+            N_("Memory Bandwidth (Four threads)"),
+            "memory.png",
+            callback_benchmark_stream_quad,
+            scan_benchmark_stream_quad,
+            MODULE_FLAG_HIDE,
+        },
+    [BENCHMARK_STREAM_ALL] =
+        {
+            N_("Memory Bandwidth (Multi-thread)"),
+            "memory.png",
+            callback_benchmark_stream_all,
+            scan_benchmark_stream_all,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_MEMORY_LATENCY] =
+        {
+            N_("Memory Latency"),
+            "memory.png",
+            callback_benchmark_memory_latency,
+            scan_benchmark_memory_latency,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_NUMA] =
+        {
+            N_("NUMA Bandwidth and Latency"),
+            "memory.png",
+            callback_benchmark_numa,
+            scan_benchmark_numa,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_STORAGE] =
+        {
+            N_("Storage I/O"),
+            "hdd.png",
+            callback_benchmark_storage,
+            scan_benchmark_storage,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_LOOPBACK_TCP_SINGLE] =
+        {
+            N_("Loopback TCP (Single stream)"),
+            "network.png",
+            callback_benchmark_loopback_tcp_single,
+            scan_benchmark_loopback_tcp_single,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_LOOPBACK_TCP_ALL] =
+        {
+            N_("Loopback TCP (Multi-stream)"),
+            "network.png",
+            callback_benchmark_loopback_tcp_all,
+            scan_benchmark_loopback_tcp_all,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_LOOPBACK_UNIX_SINGLE] =
+        {
+            N_("Loopback Unix Socket (Single stream)"),
+            "network.png",
+            callback_benchmark_loopback_unix_single,
+            scan_benchmark_loopback_unix_single,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_LOOPBACK_UNIX_ALL] =
+        {
+            N_("Loopback Unix Socket (Multi-stream)"),
+            "network.png",
+            callback_benchmark_loopback_unix_all,
+            scan_benchmark_loopback_unix_all,
+            MODULE_FLAG_HIDE,
+        },
+    [BENCHMARK_LOOPBACK_ZEROCOPY] =
+        {
+            N_("Loopback TCP (MSG_ZEROCOPY)"),
+            "network.png",
+            callback_benchmark_loopback_zerocopy,
+            scan_benchmark_loopback_zerocopy,
+            MODULE_FLAG_HIDE,
+        },
+    [BENCHMARK_LOOPBACK_SENDFILE] =
+        {
+            N_("Loopback TCP (sendfile)"),
+            "network.png",
+            callback_benchmark_loopback_sendfile,
+            scan_benchmark_loopback_sendfile,
+            MODULE_FLAG_HIDE,
+        },
+    [BENCHMARK_LOOPBACK_LATENCY] =
+        {
+            N_("Loopback Latency"),
+            "network.png",
+            callback_benchmark_loopback_latency,
+            scan_benchmark_loopback_latency,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_FLOPS_SINGLE] =
+        {
+            N_("FPU SIMD FLOPS (Single-thread)"),
+            "processor.png",
+            callback_benchmark_flops_single,
+            scan_benchmark_flops_single,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_FLOPS_ALL] =
+        {
+            N_("FPU SIMD FLOPS (Multi-thread)"),
+            "processor.png",
+            callback_benchmark_flops_all,
+            scan_benchmark_flops_all,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_ZLIB_LEVELS] =
+        {
+            N_("CPU Zlib Levels (Multi-thread)"),
+            "file-roller.png",
+            callback_benchmark_zlib_levels,
+            scan_benchmark_zlib_levels,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_ZLIB_STREAMING] =
+        {
+            N_("CPU Zlib Streaming (Single-thread)"),
+            "file-roller.png",
+            callback_benchmark_zlib_streaming,
+            scan_benchmark_zlib_streaming,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_SHA256] =
+        {
+            N_("CPU SHA-256"),
+            "cryptohash.png",
+            callback_benchmark_sha256,
+            scan_benchmark_sha256,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_CRC32C] =
+        {
+            N_("CPU CRC32C"),
+            "cryptohash.png",
+            callback_benchmark_crc32c,
+            scan_benchmark_crc32c,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_AES_SINGLE] =
+        {
+            N_("CPU AES (Single-thread)"),
+            "blowfish.png",
+            callback_benchmark_aes_single,
+            scan_benchmark_aes_single,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_AES_ALL] =
+        {
+            N_("CPU AES (Multi-thread)"),
+            "blowfish.png",
+            callback_benchmark_aes_all,
+            scan_benchmark_aes_all,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_DGEMM] =
+        {
+            N_("FPU DGEMM (Multi-thread)"),
+            "processor.png",
+            callback_benchmark_dgemm,
+            scan_benchmark_dgemm,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_SGEMM] =
+        {
+            N_("FPU SGEMM (Multi-thread)"),
+            "processor.png",
+            callback_benchmark_sgemm,
+            scan_benchmark_sgemm,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_NQUEENS_STEAL] =
+        {
+            N_("CPU N-Queens (Work-stealing)"),
+            "nqueens.png",
+            callback_benchmark_nqueens_steal,
+            scan_benchmark_nqueens_steal,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_FIB_TASKS] =
+        {
+            N_("CPU Fibonacci (Tasks)"),
+            "nautilus.png",
+            callback_benchmark_fib_tasks,
+            scan_benchmark_fib_tasks,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_BVH_RAYTRACE_SINGLE] =
+        {
+            N_("FPU BVH Raytracing (Single-thread)"),
+            "raytrace.png",
+            callback_benchmark_bvh_raytrace_single,
+            scan_benchmark_bvh_raytrace_single,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_BVH_RAYTRACE_ALL] =
+        {
+            N_("FPU BVH Raytracing (Multi-thread)"),
+            "raytrace.png",
+            callback_benchmark_bvh_raytrace_all,
+            scan_benchmark_bvh_raytrace_all,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_KPATH_SYSCALL] =
+        {
+            N_("Kernel Syscall"),
+            "os.png",
+            callback_benchmark_kpath_syscall,
+            scan_benchmark_kpath_syscall,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_KPATH_SWITCH] =
+        {
+            N_("Kernel Context Switch"),
+            "os.png",
+            callback_benchmark_kpath_switch,
+            scan_benchmark_kpath_switch,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_KPATH_FUTEX] =
+        {
+            N_("Kernel Futex Wake"),
+            "os.png",
+            callback_benchmark_kpath_futex,
+            scan_benchmark_kpath_futex,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_KPATH_CLOCK] =
+        {
+            N_("Kernel clock_gettime"),
+            "os.png",
+            callback_benchmark_kpath_clock,
+            scan_benchmark_kpath_clock,
+            MODULE_FLAG_NO_REPORT,
+        },
+    [BENCHMARK_C2C] =
+        {
+            N_("CPU Core-to-Core Latency"),
+            "processor.png",
+            callback_benchmark_c2c,
+            scan_benchmark_c2c,
+            MODULE_FLAG_NO_REPORT,
+        },
     [BENCHMARK_GUI] =
         {
             N_("GPU Drawing"),
@@ -268,6 +613,89 @@ const gchar *hi_note_func(gint entry)
     case BENCHMARK_MEMORY_ALL:
         return _("Alexey Kopytov's <i><b>sysbench</b></i> is required.\n"
                  "Results in MiB/second. Higher is better.");
+    case BENCHMARK_STREAM_SINGLE:
+    case BENCHMARK_STREAM_DUAL:
+    case BENCHMARK_STREAM_QUAD:
+    case BENCHMARK_STREAM_ALL:
+        return _("Copy, scale, add and triad over arrays larger than the caches.\n"
+                 "Results in GB/s. Higher is better.");
+    case BENCHMARK_MEMORY_LATENCY:
+        return _("Random pointer chasing over working sets from 4 KiB up.\n"
+                 "Results in ns per load from memory. Lower is better.");
+    case BENCHMARK_NUMA:
+        return _("Read bandwidth and latency from the cpus of every NUMA node\n"
+                 "to the memory of every node.\n"
+                 "Results in GB/s, the average of all pairs. Higher is better.");
+    case BENCHMARK_STORAGE:
+        return _("Sequential and 4 KiB random reads and writes in a temporary file\n"
+                 "in --bench-dir, the temp directory by default.\n"
+                 "Results in random read IOPS at queue depth 64. Higher is better.");
+    case BENCHMARK_LOOPBACK_TCP_SINGLE:
+    case BENCHMARK_LOOPBACK_TCP_ALL:
+    case BENCHMARK_LOOPBACK_UNIX_SINGLE:
+    case BENCHMARK_LOOPBACK_UNIX_ALL:
+    case BENCHMARK_LOOPBACK_ZEROCOPY:
+    case BENCHMARK_LOOPBACK_SENDFILE:
+        return _("Streams between pairs of sockets on this machine.\n"
+                 "Results in Gbits/s. Higher is better.");
+    case BENCHMARK_LOOPBACK_LATENCY:
+        return _("Round trips of small messages over a TCP and a Unix socket.\n"
+                 "Results in microseconds over TCP. Lower is better.");
+    case BENCHMARK_FLOPS_SINGLE:
+    case BENCHMARK_FLOPS_ALL:
+        return _("Double precision multiply-adds with each SIMD instruction set\n"
+                 "the processor has.\n"
+                 "Results in GFLOPS of the fastest one. Higher is better.");
+    case BENCHMARK_ZLIB_LEVELS:
+    case BENCHMARK_ZLIB_STREAMING:
+        return _("zlib compression and decompression of text, tables and random\n"
+                 "data at levels 1, 6 and 9.\n"
+                 "Results in MB/s compressing at the default level. Higher is better.");
+    case BENCHMARK_SHA256:
+    case BENCHMARK_CRC32C:
+        return _("Several buffers hashed together on every thread, with the\n"
+                 "instructions the processor has for it.\n"
+                 "Results in GB/s of all threads. Higher is better.");
+    case BENCHMARK_AES_SINGLE:
+    case BENCHMARK_AES_ALL:
+        return _("AES-128 and AES-256 in CTR and GCM, with the instructions the\n"
+                 "processor has for it.\n"
+                 "Results in GB/s of AES-128-GCM. Higher is better.");
+    case BENCHMARK_DGEMM:
+    case BENCHMARK_SGEMM:
+        return _("Blocked matrix multiply on all threads, from matrices that fit\n"
+                 "in L2 to matrices that only fit in RAM.\n"
+                 "Results in GFLOPS of the largest. Higher is better.");
+    case BENCHMARK_NQUEENS_STEAL:
+        return _("A bitboard solver for 15 queens, split into tasks that the threads\n"
+                 "steal from each other.\n"
+                 "Results in solutions per second. Higher is better.");
+    case BENCHMARK_FIB_TASKS:
+        return _("Recursive Fibonacci as fork-join tasks on all threads; the extra\n"
+                 "information has the cost of each spawn against plain recursion.\n"
+                 "Results in tasks per second. Higher is better.");
+    case BENCHMARK_BVH_RAYTRACE_SINGLE:
+    case BENCHMARK_BVH_RAYTRACE_ALL:
+        return _("Spheres in a bounding volume hierarchy, traced in packets of rays,\n"
+                 "the image in tiles shared by the threads.\n"
+                 "Results in millions of rays per second. Higher is better.");
+    case BENCHMARK_KPATH_SYSCALL:
+        return _("A getpid() system call, with the vulnerability mitigations in use.\n"
+                 "Results in ns per call. Lower is better.");
+    case BENCHMARK_KPATH_SWITCH:
+        return _("Two threads on the same cpu passing a byte over pipes.\n"
+                 "Results in ns per context switch. Lower is better.");
+    case BENCHMARK_KPATH_FUTEX:
+        return _("Two threads on two cpus waking each other with futexes.\n"
+                 "Results in ns from the wake to the woken thread running. Lower is better.");
+    case BENCHMARK_C2C:
+        return _("A cache line bounced between every pair of cpus, in topology order;\n"
+                 "the matrix is in the details.\n"
+                 "Results in ns per transfer, the mean of all pairs. Lower is better.");
+    case BENCHMARK_KPATH_CLOCK:
+        return _("clock_gettime(CLOCK_MONOTONIC), answered by the vDSO when the\n"
+                 "clock source allows it.\n"
+                 "Results in ns per call. Lower is better.");
     case BENCHMARK_IPERF3_SINGLE:
         return _("<i><b>iperf3</b></i> is required.\n"
                  "Results in Gbits/s. Higher is better.");
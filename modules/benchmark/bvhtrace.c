@@ -0,0 +1,491 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <math.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* A raytracer: RT_SPHERES spheres on a checkered floor, with one point
+ * light and shadows, rendered RT_W x RT_H.
+ *
+ * The spheres are in a bounding volume hierarchy, split at the median
+ * along the longest axis down to RT_LEAF spheres. Rays are traced in
+ * packets of RT_PACKET x RT_PACKET, stored as arrays of each component
+ * rather than as an array of rays, so the box and sphere tests of a
+ * packet are loops the compiler can vectorize. A packet goes down the
+ * tree with a mask of the rays still inside the boxes, the near child
+ * first, and stops at a node none of them hits. Every hit casts a
+ * shadow ray to the light, traced the same way in packets.
+ *
+ * The image is cut in RT_TILE x RT_TILE tiles. Workers take the next
+ * tile from a shared counter, like the GEMM tasks, and render it to a
+ * buffer of their own. The traversal is checked against testing every
+ * sphere before it runs.
+ *
+ * The result is in millions of rays (primary and shadow) per second. */
+
+/* if anything changes in this block, increment revision */
+#define BENCH_REVISION 1
+#define RT_SECONDS 5
+#define RT_W 1024
+#define RT_H 768
+#define RT_TILE 32
+#define RT_PACKET 8
+#define RT_RAYS (RT_PACKET * RT_PACKET)
+#define RT_SPHERES 1024
+#define RT_LEAF 4
+#define RT_STACK 64
+#define RT_FAR 1e30f
+#define RT_EPS 1e-3f
+#define RT_TILES ((RT_W / RT_TILE) * (RT_H / RT_TILE))
+
+typedef struct {
+    float cx, cy, cz, r;
+} RtSphere;
+
+/* a leaf has count > 0 spheres from first; otherwise the children are
+ * first and first + 1, split on axis -count - 1 */
+typedef struct {
+    float bmin[3];
+    gint first;
+    float bmax[3];
+    gint count;
+} RtNode;
+
+typedef struct {
+    float ox[RT_RAYS], oy[RT_RAYS], oz[RT_RAYS];
+    float dx[RT_RAYS], dy[RT_RAYS], dz[RT_RAYS];
+    float ix[RT_RAYS], iy[RT_RAYS], iz[RT_RAYS]; /* 1 / d */
+    float t[RT_RAYS];
+    gint id[RT_RAYS];
+    gint n;
+} __attribute__((aligned(64))) RtPacket;
+
+typedef struct {
+    RtSphere *spheres;
+    RtNode *nodes;
+    gint n_nodes, depth;
+    float eye[3], fwd[3], right[3], up[3];
+} RtScene;
+
+typedef struct {
+    guint32 fb[RT_TILE * RT_TILE];
+} __attribute__((aligned(64))) RtThread;
+
+typedef struct {
+    const RtScene *sc;
+    RtThread *t;
+    gint next;
+} RtData;
+
+static guint64 rt_xorshift(guint64 *s)
+{
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+static float rt_uniform(guint64 *s, float lo, float hi)
+{
+    return lo + (hi - lo) * (rt_xorshift(s) >> 40) / (float)(1 << 24);
+}
+
+static gint rt_compare(gconstpointer a, gconstpointer b, gpointer data)
+{
+    const float *ca = &((const RtSphere *)a)->cx, *cb = &((const RtSphere *)b)->cx;
+    gint axis = GPOINTER_TO_INT(data);
+
+    return (ca[axis] > cb[axis]) - (ca[axis] < cb[axis]);
+}
+
+/* sorts the spheres of the node in place, so leaves are ranges */
+static void rt_build(RtScene *sc, gint node, gint first, gint count, gint depth)
+{
+    RtNode *n = &sc->nodes[node];
+    float cmin[3], cmax[3];
+    gint i, a, axis = 0;
+
+    for (a = 0; a < 3; a++) {
+        n->bmin[a] = cmin[a] = RT_FAR;
+        n->bmax[a] = cmax[a] = -RT_FAR;
+    }
+    for (i = first; i < first + count; i++) {
+        const RtSphere *s = &sc->spheres[i];
+        const float *c = &s->cx;
+
+        for (a = 0; a < 3; a++) {
+            n->bmin[a] = MIN(n->bmin[a], c[a] - s->r);
+            n->bmax[a] = MAX(n->bmax[a], c[a] + s->r);
+            cmin[a] = MIN(cmin[a], c[a]);
+            cmax[a] = MAX(cmax[a], c[a]);
+        }
+    }
+    sc->depth = MAX(sc->depth, depth);
+
+    if (count <= RT_LEAF) {
+        n->first = first;
+        n->count = count;
+        return;
+    }
+
+    for (a = 1; a < 3; a++)
+        if (cmax[a] - cmin[a] > cmax[axis] - cmin[axis])
+            axis = a;
+    g_qsort_with_data(&sc->spheres[first], count, sizeof(RtSphere), rt_compare,
+                      GINT_TO_POINTER(axis));
+
+    n->first = sc->n_nodes;
+    n->count = -axis - 1;
+    sc->n_nodes += 2;
+    rt_build(sc, n->first, first, count / 2, depth + 1);
+    rt_build(sc, sc->nodes[node].first + 1, first + count / 2, count - count / 2,
+             depth + 1);
+}
+
+static void rt_scene_init(RtScene *sc)
+{
+    static const float eye[3] = { 0, 14, -44 }, at[3] = { 0, 0, 6 };
+    guint64 seed = 0x2545f4914f6cdd1dULL;
+    float len;
+    gint i;
+
+    memset(sc, 0, sizeof(*sc));
+    sc->spheres = g_new(RtSphere, RT_SPHERES);
+    for (i = 0; i < RT_SPHERES; i++) {
+        RtSphere *s = &sc->spheres[i];
+
+        s->r = rt_uniform(&seed, 0.3f, 1.4f);
+        s->cx = rt_uniform(&seed, -40, 40);
+        s->cz = rt_uniform(&seed, -30, 50);
+        /* on the floor, a quarter of them floating */
+        s->cy = s->r + (i % 4 ? 0 : rt_uniform(&seed, 0.5f, 6));
+    }
+    sc->nodes = g_new0(RtNode, 2 * RT_SPHERES);
+    sc->n_nodes = 1;
+    rt_build(sc, 0, 0, RT_SPHERES, 1);
+
+    memcpy(sc->eye, eye, sizeof(eye));
+    for (i = 0; i < 3; i++)
+        sc->fwd[i] = at[i] - eye[i];
+    len = sqrtf(sc->fwd[0] * sc->fwd[0] + sc->fwd[1] * sc->fwd[1] + sc->fwd[2] * sc->fwd[2]);
+    for (i = 0; i < 3; i++)
+        sc->fwd[i] /= len;
+    /* right = up x fwd, with up = y; up = fwd x right */
+    len = sqrtf(sc->fwd[2] * sc->fwd[2] + sc->fwd[0] * sc->fwd[0]);
+    sc->right[0] = sc->fwd[2] / len;
+    sc->right[1] = 0;
+    sc->right[2] = -sc->fwd[0] / len;
+    sc->up[0] = sc->fwd[1] * sc->right[2] - sc->fwd[2] * sc->right[1];
+    sc->up[1] = sc->fwd[2] * sc->right[0] - sc->fwd[0] * sc->right[2];
+    sc->up[2] = sc->fwd[0] * sc->right[1] - sc->fwd[1] * sc->right[0];
+}
+
+static void rt_scene_free(RtScene *sc)
+{
+    g_free(sc->spheres);
+    g_free(sc->nodes);
+}
+
+static void rt_packet_set(RtPacket *p, gint i, const float o[3], const float d[3],
+                          float t)
+{
+    p->ox[i] = o[0];
+    p->oy[i] = o[1];
+    p->oz[i] = o[2];
+    p->dx[i] = d[0];
+    p->dy[i] = d[1];
+    p->dz[i] = d[2];
+    p->ix[i] = 1.0f / d[0];
+    p->iy[i] = 1.0f / d[1];
+    p->iz[i] = 1.0f / d[2];
+    p->t[i] = t;
+    p->id[i] = -1;
+}
+
+static void rt_hit_spheres(const RtSphere *spheres, gint first, gint count,
+                           RtPacket *p, const guint8 *m)
+{
+    gint i, k;
+
+    for (k = first; k < first + count; k++) {
+        const RtSphere *s = &spheres[k];
+
+        for (i = 0; i < RT_RAYS; i++) {
+            float ocx = p->ox[i] - s->cx, ocy = p->oy[i] - s->cy, ocz = p->oz[i] - s->cz;
+            float b = ocx * p->dx[i] + ocy * p->dy[i] + ocz * p->dz[i];
+            float c = ocx * ocx + ocy * ocy + ocz * ocz - s->r * s->r;
+            float disc = b * b - c, t;
+
+            if (!m[i] || disc <= 0)
+                continue;
+            t = -b - sqrtf(disc);
+            if (t > RT_EPS && t < p->t[i]) {
+                p->t[i] = t;
+                p->id[i] = k;
+            }
+        }
+    }
+}
+
+/* the nearest sphere of each ray closer than its t */
+static void rt_trace(const RtScene *sc, RtPacket *p)
+{
+    struct {
+        gint node;
+        guint8 mask[RT_RAYS];
+    } stack[RT_STACK];
+    guint8 m[RT_RAYS];
+    gint sp = 0, i;
+
+    stack[0].node = 0;
+    for (i = 0; i < RT_RAYS; i++)
+        stack[0].mask[i] = i < p->n;
+
+    while (sp >= 0) {
+        const RtNode *n = &sc->nodes[stack[sp].node];
+        const guint8 *in = stack[sp].mask;
+        guint8 any = 0;
+
+        for (i = 0; i < RT_RAYS; i++) {
+            float x0 = (n->bmin[0] - p->ox[i]) * p->ix[i], x1 = (n->bmax[0] - p->ox[i]) * p->ix[i];
+            float y0 = (n->bmin[1] - p->oy[i]) * p->iy[i], y1 = (n->bmax[1] - p->oy[i]) * p->iy[i];
+            float z0 = (n->bmin[2] - p->oz[i]) * p->iz[i], z1 = (n->bmax[2] - p->oz[i]) * p->iz[i];
+            float tn = MAX(MAX(MIN(x0, x1), MIN(y0, y1)), MAX(MIN(z0, z1), 0.0f));
+            float tf = MIN(MIN(MAX(x0, x1), MAX(y0, y1)), MIN(MAX(z0, z1), p->t[i]));
+
+            m[i] = in[i] & (tn <= tf);
+            any |= m[i];
+        }
+        sp--;
+        if (!any)
+            continue;
+
+        if (n->count > 0) {
+            rt_hit_spheres(sc->spheres, n->first, n->count, p, m);
+        } else {
+            /* the far child first on the stack, by the first ray */
+            gint axis = -n->count - 1, near;
+            const float *d = axis == 0 ? p->dx : axis == 1 ? p->dy : p->dz;
+
+            near = n->first + (d[0] < 0);
+            stack[++sp].node = n->first + (d[0] >= 0);
+            memcpy(stack[sp].mask, m, RT_RAYS);
+            stack[++sp].node = near;
+            memcpy(stack[sp].mask, m, RT_RAYS);
+        }
+    }
+}
+
+static void rt_trace_all(const RtScene *sc, RtPacket *p)
+{
+    guint8 m[RT_RAYS];
+    gint i;
+
+    for (i = 0; i < RT_RAYS; i++)
+        m[i] = i < p->n;
+    rt_hit_spheres(sc->spheres, 0, RT_SPHERES, p, m);
+}
+
+static void rt_primary(const RtScene *sc, RtPacket *p, gint x0, gint y0)
+{
+    const float th = 0.5f, aspect = (float)RT_W / RT_H; /* tan(fov / 2) */
+    float d[3], u, v, len;
+    gint i, a;
+
+    for (i = 0; i < RT_RAYS; i++) {
+        u = ((x0 + i % RT_PACKET + 0.5f) / RT_W * 2 - 1) * aspect * th;
+        v = (1 - (y0 + i / RT_PACKET + 0.5f) / RT_H * 2) * th;
+        for (a = 0; a < 3; a++)
+            d[a] = sc->fwd[a] + u * sc->right[a] + v * sc->up[a];
+        len = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        for (a = 0; a < 3; a++)
+            d[a] /= len;
+        rt_packet_set(p, i, sc->eye, d, RT_FAR);
+    }
+    p->n = RT_RAYS;
+}
+
+/* renders the packet at x0, y0 to fb; returns the rays traced */
+static gint rt_packet(const RtScene *sc, gint x0, gint y0, guint32 *fb, gint stride)
+{
+    static const float light[3] = { -30, 60, -20 };
+    RtPacket p, sh;
+    float pos[RT_RAYS][3], ndotl[RT_RAYS], nrm[3], l[3], o[3], len, tp, shade;
+    gint lane[RT_RAYS], i, a;
+    guint32 base, r, g, b;
+
+    rt_primary(sc, &p, x0, y0);
+    rt_trace(sc, &p);
+
+    /* the floor, y = 0, isn't in the tree */
+    for (i = 0; i < RT_RAYS; i++) {
+        tp = -p.oy[i] / p.dy[i];
+        if (p.dy[i] < 0 && tp < p.t[i]) {
+            p.t[i] = tp;
+            p.id[i] = RT_SPHERES;
+        }
+    }
+
+    sh.n = 0;
+    for (i = 0; i < RT_RAYS; i++) {
+        ndotl[i] = 0;
+        if (p.id[i] < 0)
+            continue;
+        pos[i][0] = p.ox[i] + p.t[i] * p.dx[i];
+        pos[i][1] = p.oy[i] + p.t[i] * p.dy[i];
+        pos[i][2] = p.oz[i] + p.t[i] * p.dz[i];
+        if (p.id[i] == RT_SPHERES) {
+            nrm[0] = nrm[2] = 0;
+            nrm[1] = 1;
+        } else {
+            const RtSphere *s = &sc->spheres[p.id[i]];
+
+            nrm[0] = (pos[i][0] - s->cx) / s->r;
+            nrm[1] = (pos[i][1] - s->cy) / s->r;
+            nrm[2] = (pos[i][2] - s->cz) / s->r;
+        }
+        for (a = 0; a < 3; a++)
+            l[a] = light[a] - pos[i][a];
+        len = sqrtf(l[0] * l[0] + l[1] * l[1] + l[2] * l[2]);
+        for (a = 0; a < 3; a++) {
+            l[a] /= len;
+            o[a] = pos[i][a] + nrm[a] * RT_EPS;
+        }
+        ndotl[i] = nrm[0] * l[0] + nrm[1] * l[1] + nrm[2] * l[2];
+        if (ndotl[i] <= 0)
+            continue;
+        lane[sh.n] = i;
+        rt_packet_set(&sh, sh.n++, o, l, len);
+    }
+    for (i = sh.n; i < RT_RAYS; i++)
+        rt_packet_set(&sh, i, sc->eye, sc->fwd, 0);
+    rt_trace(sc, &sh);
+    for (i = 0; i < sh.n; i++)
+        if (sh.id[i] >= 0)
+            ndotl[lane[i]] = 0;
+
+    for (i = 0; i < RT_RAYS; i++) {
+        if (p.id[i] < 0) {
+            fb[(i / RT_PACKET) * stride + i % RT_PACKET] = 0x6090c0;
+            continue;
+        }
+        if (p.id[i] == RT_SPHERES)
+            base = ((gint)floorf(pos[i][0] / 4) + (gint)floorf(pos[i][2] / 4)) & 1 ?
+                   0xe0e0e0 : 0x404040;
+        else
+            base = 0x404040 | (p.id[i] * 0x9e3779b1U & 0xbfbfbf);
+        shade = 0.15f + 0.85f * MAX(ndotl[i], 0.0f);
+        r = ((base >> 16) & 0xff) * shade;
+        g = ((base >> 8) & 0xff) * shade;
+        b = (base & 0xff) * shade;
+        fb[(i / RT_PACKET) * stride + i % RT_PACKET] = r << 16 | g << 8 | b;
+    }
+
+    return RT_RAYS + sh.n;
+}
+
+static gint rt_tile(const RtScene *sc, gint tile, guint32 *fb)
+{
+    gint x0 = tile % (RT_W / RT_TILE) * RT_TILE, y0 = tile / (RT_W / RT_TILE) * RT_TILE;
+    gint x, y, rays = 0;
+
+    for (y = 0; y < RT_TILE; y += RT_PACKET)
+        for (x = 0; x < RT_TILE; x += RT_PACKET)
+            rays += rt_packet(sc, x0 + x, y0 + y, &fb[y * RT_TILE + x], RT_TILE);
+    return rays;
+}
+
+static gpointer rt_for(void *data, gint thread_number)
+{
+    RtData *rd = data;
+    guint tile = (guint)g_atomic_int_add(&rd->next, 1) % RT_TILES;
+
+    rt_tile(rd->sc, tile, rd->t[thread_number].fb);
+    return NULL;
+}
+
+/* the primary rays of a few tiles, through the tree and through all
+ * the spheres */
+static gboolean rt_check(const RtScene *sc)
+{
+    RtPacket a, b;
+    gint tile, i;
+
+    for (tile = 0; tile < RT_TILES; tile += 37) {
+        rt_primary(sc, &a, tile % (RT_W / RT_TILE) * RT_TILE,
+                   tile / (RT_W / RT_TILE) * RT_TILE + RT_TILE / 2);
+        b = a;
+        rt_trace(sc, &a);
+        rt_trace_all(sc, &b);
+        for (i = 0; i < RT_RAYS; i++)
+            if (a.id[i] != b.id[i])
+                return FALSE;
+    }
+    return TRUE;
+}
+
+static void benchmark_bvh_raytrace(gint n_threads, gint entry)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    RtScene sc;
+    RtData rd;
+    guint64 rays = 0;
+    gint i;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Raytracing tiles...");
+
+    rt_scene_init(&sc);
+    if (!rt_check(&sc)) {
+        bench_msg("BVH traversal misses spheres, not run");
+        rt_scene_free(&sc);
+        bench_results[entry] = r;
+        return;
+    }
+
+    n_threads = benchmark_threads(n_threads);
+    rd.sc = &sc;
+    rd.next = 0;
+    rd.t = g_new0(RtThread, n_threads);
+
+    /* the shadow rays depend on the tile: count a whole image */
+    for (i = 0; i < RT_TILES; i++)
+        rays += rt_tile(&sc, i, rd.t[0].fb);
+
+    r = benchmark_crunch_for(RT_SECONDS, n_threads, rt_for, &rd);
+    if (r.elapsed_time > 0) {
+        r.result = r.result * rays / RT_TILES / r.elapsed_time / 1e6;
+        r.revision = BENCH_REVISION;
+        bench_value_append_extra(&r, "%dx%d, %d spheres, BVH %d nodes %d deep, "
+                                 "%dx%d tiles, %0.2f rays/pixel",
+                                 RT_W, RT_H, RT_SPHERES, sc.n_nodes, sc.depth,
+                                 RT_TILE, RT_TILE, (double)rays / (RT_W * RT_H));
+    } else {
+        r.result = -1;
+    }
+
+    g_free(rd.t);
+    rt_scene_free(&sc);
+
+    bench_results[entry] = r;
+}
+
+void benchmark_bvh_raytrace_single(void) { benchmark_bvh_raytrace(1, BENCHMARK_BVH_RAYTRACE_SINGLE); }
+void benchmark_bvh_raytrace_all(void) { benchmark_bvh_raytrace(0, BENCHMARK_BVH_RAYTRACE_ALL); }
@@ -0,0 +1,297 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#define _GNU_SOURCE
+#include <sched.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+#include "cpu_util.h"
+#include "cpubits.h"
+
+/* Core to core latency: how long a cache line takes to go from one cpu
+ * to another.
+ *
+ * For every pair of cpus, two pool workers pinned to them bounce an
+ * int in a cache line of its own: the first writes an odd value, the
+ * second answers with the next even one, C2C_ROUNDS times after
+ * C2C_WARMUP untimed rounds. Each round trip is two transfers of the
+ * line; the matrix has the time of one, the same both ways.
+ *
+ * The cpus are in topology order, from cputopo_new() and the cpus
+ * sharing the last level cache: node, socket, last level cache, core,
+ * so SMT siblings are next to each other and the blocks of the matrix
+ * are the caches and sockets. With more cpus than the matrix holds, it
+ * has an even sample of them. The result is the mean of all the pairs;
+ * the extra information has the mean of SMT siblings, other cores
+ * sharing the last level cache, other caches of the same socket, and
+ * other sockets. */
+
+/* if anything changes in this block, increment revision */
+#define BENCH_REVISION 1
+#define C2C_ROUNDS 20000
+#define C2C_WARMUP 1000
+#define C2C_PAIR_MS 100 /* a pair stops there, as when both got one cpu */
+
+#if defined(__x86_64__) || defined(__i386__)
+#define C2C_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define C2C_RELAX() __asm__ __volatile__("yield")
+#else
+#define C2C_RELAX()
+#endif
+
+typedef enum {
+    C2C_SMT,
+    C2C_LLC,
+    C2C_SOCKET,
+    C2C_REMOTE,
+    C2C_N_CLASSES
+} C2cClass;
+
+static const gchar *c2c_class_names[] = {
+    [C2C_SMT] = "SMT",
+    [C2C_LLC] = "shared LLC",
+    [C2C_SOCKET] = "same socket",
+    [C2C_REMOTE] = "cross-socket",
+};
+
+typedef struct {
+    cpu_topology_data *topo;
+    gint llc; /* lowest cpu sharing the last level cache, -1 if unknown */
+} C2cCpu;
+
+typedef struct {
+    gint line;
+    gchar pad[64 - sizeof(gint)];
+    guint64 ns;
+    gint rounds;
+} __attribute__((aligned(64))) C2cData;
+
+#define C2C_CMP(F) if (a->F != b->F) return a->F < b->F ? -1 : 1;
+
+static gint c2c_cmp(gconstpointer pa, gconstpointer pb)
+{
+    const C2cCpu *a = pa, *b = pb;
+    C2C_CMP(topo->node_id);
+    C2C_CMP(topo->socket_id);
+    C2C_CMP(llc);
+    C2C_CMP(topo->core_id);
+    C2C_CMP(topo->id);
+    return 0;
+}
+
+static gint c2c_llc(gint cpu)
+{
+    GSList *caches, *l;
+    cpu_cache_data *c, *best = NULL;
+    cpubits *bits;
+    gint llc = -1;
+
+    caches = cpucache_list_new(cpu);
+    for (l = caches; l; l = l->next) {
+        c = l->data;
+        if (!best || c->level > best->level)
+            best = c;
+    }
+    if (best && best->shared_cpu_list) {
+        bits = cpubits_from_str(best->shared_cpu_list);
+        llc = cpubits_min(bits);
+        free(bits);
+    }
+    cpucache_list_free(caches);
+    return llc;
+}
+
+/* the online cpus this process may run on, in topology order */
+static C2cCpu *c2c_cpus(gint *n_cpus)
+{
+    gchar *tmp = NULL;
+    cpubits *online;
+    cpu_set_t allowed;
+    C2cCpu *cpus;
+    gint i, max, n = 0;
+
+    *n_cpus = 0;
+    g_file_get_contents("/sys/devices/system/cpu/online", &tmp, NULL, NULL);
+    if (!tmp || sched_getaffinity(0, sizeof(allowed), &allowed) < 0) {
+        g_free(tmp);
+        return NULL;
+    }
+    online = cpubits_from_str(tmp);
+    g_free(tmp);
+
+    max = MIN(cpubits_max(online), CPU_SETSIZE - 1);
+    cpus = g_new0(C2cCpu, cpubits_count(online));
+    for (i = 0; i <= max; i++) {
+        if (!CPUBIT_GET(online, i) || !CPU_ISSET(i, &allowed))
+            continue;
+        cpus[n].topo = cputopo_new(i);
+        /* a cpu without topology is a core of its own */
+        if (cpus[n].topo->core_id == CPU_TOPO_NULL)
+            cpus[n].topo->core_id = i;
+        if (cpus[n].topo->socket_id < 0)
+            cpus[n].topo->socket_id = 0;
+        if (cpus[n].topo->node_id < 0)
+            cpus[n].topo->node_id = 0;
+        cpus[n].llc = c2c_llc(i);
+        n++;
+    }
+    free(online);
+
+    qsort(cpus, n, sizeof(C2cCpu), (int (*)(const void *, const void *))c2c_cmp);
+    *n_cpus = n;
+    return cpus;
+}
+
+static C2cClass c2c_class(const C2cCpu *a, const C2cCpu *b)
+{
+    if (a->topo->socket_id != b->topo->socket_id)
+        return C2C_REMOTE;
+    if (a->topo->core_id == b->topo->core_id)
+        return C2C_SMT;
+    if (a->llc >= 0 && a->llc == b->llc)
+        return C2C_LLC;
+    return C2C_SOCKET;
+}
+
+/* worker 0 pings with odd values and times the rounds, worker 1 pongs */
+static void c2c_worker(gpointer task, gint worker)
+{
+    C2cData *cd = task;
+    guint64 t0 = 0, start, limit = C2C_PAIR_MS * (guint64)1000000;
+    gint v, i;
+
+    if (worker) {
+        while ((v = g_atomic_int_get(&cd->line)) >= 0) {
+            if (v & 1)
+                g_atomic_int_set(&cd->line, v + 1);
+            else
+                C2C_RELAX();
+        }
+        return;
+    }
+
+    start = bench_hist_now_ns();
+    for (i = 0, v = 0; i < C2C_WARMUP + C2C_ROUNDS; i++, v += 2) {
+        if (i == C2C_WARMUP)
+            t0 = bench_hist_now_ns();
+        g_atomic_int_set(&cd->line, v + 1);
+        while (g_atomic_int_get(&cd->line) != v + 2)
+            C2C_RELAX();
+        if ((i < C2C_WARMUP || !(i & 255)) && bench_hist_now_ns() - start > limit)
+            break;
+    }
+    if (i > C2C_WARMUP) {
+        cd->ns = bench_hist_now_ns() - t0;
+        cd->rounds = i - C2C_WARMUP;
+    }
+    g_atomic_int_set(&cd->line, -1);
+}
+
+/* ns for the line to go from one cpu to the other, -1 if not measured */
+static double c2c_pair(C2cData *cd, gint a, gint b)
+{
+    gpointer tasks[2] = { cd, cd };
+    gint cpus[2] = { a, b };
+
+    memset(cd, 0, sizeof(*cd));
+    bench_pool_set_affinity(cpus, 2);
+    bench_pool_run(2, c2c_worker, tasks);
+    if (!cd->rounds)
+        return -1;
+    return (double)cd->ns / cd->rounds / 2;
+}
+
+void benchmark_c2c(void)
+{
+    const bench_placement *pl = bench_placement_get();
+    bench_value r = EMPTY_BENCH_VALUE;
+    bench_matrix *m;
+    C2cData *cd;
+    C2cCpu *cpus, **pick;
+    double sum[C2C_N_CLASSES] = { 0 }, total = 0, ns;
+    gint count[C2C_N_CLASSES] = { 0 }, n_cpus, n_pairs = 0, i, j, c;
+    guint64 elapsed = 0;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Bouncing cache lines between cpus...");
+
+    cpus = c2c_cpus(&n_cpus);
+    if (n_cpus < 2) {
+        bench_msg("core to core latency needs two cpus");
+        for (i = 0; i < n_cpus; i++)
+            cputopo_free(cpus[i].topo);
+        g_free(cpus);
+        bench_results[BENCHMARK_C2C] = r;
+        return;
+    }
+
+    m = r.matrix = bench_matrix_new(n_cpus, TRUE);
+    pick = g_new0(C2cCpu *, m->n);
+    for (i = 0; i < m->n; i++) {
+        pick[i] = &cpus[(gint64)i * n_cpus / m->n];
+        m->id[i] = pick[i]->topo->id;
+    }
+    if (m->n < n_cpus)
+        bench_msg("only %d of %d cpus are measured", m->n, n_cpus);
+
+    /* the line alone in its cache line */
+    if (posix_memalign((void **)&cd, 64, sizeof(C2cData)))
+        cd = NULL;
+    for (i = 0; cd && i < m->n && !params.aborting_benchmarks; i++) {
+        for (j = i + 1; j < m->n && !params.aborting_benchmarks; j++) {
+            ns = c2c_pair(cd, m->id[i], m->id[j]);
+            elapsed += cd->ns;
+            if (ns < 0)
+                continue;
+            m->ns[i][j] = m->ns[j][i] = ns;
+            c = c2c_class(pick[i], pick[j]);
+            sum[c] += ns;
+            count[c]++;
+            total += ns;
+            n_pairs++;
+        }
+    }
+    bench_pool_set_affinity(pl->cpus, pl->n_cpus);
+    free(cd);
+
+    if (n_pairs) {
+        r.result = total / n_pairs;
+        r.elapsed_time = elapsed / 1e9;
+        r.threads_used = 2;
+        r.revision = BENCH_REVISION;
+        for (c = 0; c < C2C_N_CLASSES; c++) {
+            if (count[c])
+                bench_value_append_extra(&r, "%s %0.1f ns", c2c_class_names[c],
+                                         sum[c] / count[c]);
+        }
+        bench_value_append_extra(&r, "%d pairs of %d cpus", n_pairs, m->n);
+        if (m->n < n_cpus)
+            bench_value_append_extra(&r, "sampled from %d", n_cpus);
+    } else {
+        bench_value_free(&r);
+    }
+
+    for (i = 0; i < n_cpus; i++)
+        cputopo_free(cpus[i].topo);
+    g_free(cpus);
+    g_free(pick);
+
+    bench_results[BENCHMARK_C2C] = r;
+}
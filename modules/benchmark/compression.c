@@ -0,0 +1,392 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <zlib.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* zlib compression and decompression speed, each on its own, at the
+ * fast, default and best levels.
+ *
+ * The corpus is COMP_CORPUS_SIZE bytes, generated the same everywhere
+ * in COMP_SEGMENT pieces: text of words drawn from comp_words, more
+ * often from the start of the list, tables of numbers and random
+ * bytes, so it has prose, structure and some data that does not
+ * compress at all.
+ *
+ *   levels    - every worker compresses and decompresses COMP_BLOCK
+ *               blocks of the corpus, going through the levels in turn;
+ *               MB/s of all the workers, for each level and direction
+ *   streaming - one deflate stream over the whole corpus, fed
+ *               COMP_SEGMENT at a time into a buffer for all of it,
+ *               then one inflate stream back, drained COMP_SEGMENT at
+ *               a time, for each level; on the calling thread, so it
+ *               stays single-threaded during a --bench-sweep
+ *
+ * Both verify the round trip, report the ratio of each level and have
+ * the compression speed at the default level as the result, in MB/s. */
+
+/* if anything changes in this block, increment revision */
+#define BENCH_REVISION 1
+#define CRUNCH_TIME 7
+#define COMP_CORPUS_SIZE (16 << 20)
+#define COMP_SEGMENT (64 << 10)
+#define COMP_BLOCK (256 << 10)
+
+static const gint comp_levels[] = { Z_BEST_SPEED, Z_DEFAULT_COMPRESSION,
+                                    Z_BEST_COMPRESSION };
+#define COMP_N_LEVELS ((gint)G_N_ELEMENTS(comp_levels))
+#define COMP_DEFAULT 1 /* in comp_levels */
+
+typedef struct {
+    guint64 in, out; /* uncompressed and compressed bytes */
+    guint64 ns[2];   /* compressing, decompressing */
+} CompStats;
+
+typedef struct {
+    CompStats level[COMP_N_LEVELS];
+    gint next; /* level of the next call */
+    gsize pos; /* block of the next call */
+    guchar *packed, *unpacked;
+} CompWorker;
+
+typedef struct {
+    guchar *corpus;
+    CompWorker *w;
+    gint errors;
+} CompData;
+
+static guint64 xorshift64(guint64 *s)
+{
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+static const gchar *comp_words[] = {
+    "the", "of", "and", "to", "a", "in", "is", "it", "that", "for",
+    "on", "was", "with", "as", "be", "by", "at", "this", "from", "or",
+    "memory", "processor", "system", "cache", "thread", "kernel", "device",
+    "benchmark", "result", "clock", "bandwidth", "latency", "storage",
+    "network", "compression", "information", "temperature", "frequency",
+    "instruction", "performance", "hardware", "software", "module", "driver",
+    "sensor", "battery", "display", "report", "version", "machine", "board",
+    "vendor", "firmware", "interface", "controller", "partition", "buffer",
+    "register", "pipeline", "throughput", "scheduler", "allocation", "queue",
+};
+
+/* prose: lines of up to 72 characters */
+static gsize comp_text(guchar *p, gsize n, guint64 *seed)
+{
+    gsize pos = 0, line = 0, len;
+    const gchar *w;
+    guint64 v;
+
+    while (pos < n) {
+        v = xorshift64(seed);
+        /* the lesser of two picks: short words come up more */
+        w = comp_words[MIN(v % G_N_ELEMENTS(comp_words),
+                           (v >> 32) % G_N_ELEMENTS(comp_words))];
+        len = strlen(w);
+        if (pos + len + 1 > n)
+            break;
+        if (line + len > 72) {
+            p[pos - 1] = (v >> 20) % 4 ? '\n' : '.';
+            line = 0;
+        }
+        memcpy(p + pos, w, len);
+        pos += len;
+        p[pos++] = ' ';
+        line += len + 1;
+    }
+    return pos;
+}
+
+/* a table of hex ids, counts and values */
+static gsize comp_table(guchar *p, gsize n, guint64 *seed)
+{
+    gsize pos = 0, len;
+    gchar tmp[64];
+    guint64 v;
+
+    while (pos < n) {
+        v = xorshift64(seed);
+        len = g_snprintf(tmp, sizeof(tmp), "%08x %6u %10.4f\n",
+                         (guint)(v >> 32), (guint)(v & 0xffff),
+                         (v % 10000000) / 1000.0);
+        if (pos + len > n)
+            break;
+        memcpy(p + pos, tmp, len);
+        pos += len;
+    }
+    return pos;
+}
+
+static guchar *comp_corpus(void)
+{
+    guchar *corpus = g_malloc(COMP_CORPUS_SIZE);
+    guint64 seed = 0x9e3779b97f4a7c15ULL;
+    gsize pos, len;
+    gint seg = 0;
+
+    for (pos = 0; pos < COMP_CORPUS_SIZE; pos += COMP_SEGMENT, seg++) {
+        switch (seg % 4) {
+        case 0:
+        case 2:
+            len = comp_text(corpus + pos, COMP_SEGMENT, &seed);
+            break;
+        case 1:
+            len = comp_table(corpus + pos, COMP_SEGMENT, &seed);
+            break;
+        default:
+            for (len = 0; len < COMP_SEGMENT; len++)
+                corpus[pos + len] = xorshift64(&seed) >> 56;
+        }
+        memset(corpus + pos + len, '\n', COMP_SEGMENT - len);
+    }
+
+    return corpus;
+}
+
+static gpointer comp_levels_for(void *data, gint thread_number)
+{
+    CompData *cd = data;
+    CompWorker *w = &cd->w[thread_number];
+    CompStats *s = &w->level[w->next];
+    const guchar *in = cd->corpus + w->pos;
+    uLongf packed = compressBound(COMP_BLOCK), unpacked = COMP_BLOCK;
+    guint64 t0, t1, t2;
+
+    t0 = bench_hist_now_ns();
+    compress2(w->packed, &packed, in, COMP_BLOCK, comp_levels[w->next]);
+    t1 = bench_hist_now_ns();
+    uncompress(w->unpacked, &unpacked, w->packed, packed);
+    t2 = bench_hist_now_ns();
+
+    if (unpacked != COMP_BLOCK || memcmp(in, w->unpacked, COMP_BLOCK))
+        g_atomic_int_inc(&cd->errors);
+    s->in += COMP_BLOCK;
+    s->out += packed;
+    s->ns[0] += t1 - t0;
+    s->ns[1] += t2 - t1;
+
+    w->next = (w->next + 1) % COMP_N_LEVELS;
+    if (!w->next)
+        w->pos = (w->pos + COMP_BLOCK) % COMP_CORPUS_SIZE;
+    return NULL;
+}
+
+/* one call: the whole corpus through deflate and back through inflate */
+static gpointer comp_stream(unsigned int start, unsigned int end, void *data,
+                            gint thread_number)
+{
+    CompData *cd = data;
+    CompWorker *w = &cd->w[0];
+    CompStats *s;
+    z_stream z;
+    gsize bound = deflateBound(NULL, COMP_CORPUS_SIZE), pos;
+    guchar *packed = g_malloc(bound), *out = g_malloc(COMP_SEGMENT);
+    guint64 t0;
+    gint l, ret;
+
+    for (l = 0; l < COMP_N_LEVELS && !params.aborting_benchmarks; l++) {
+        s = &w->level[l];
+
+        memset(&z, 0, sizeof(z));
+        t0 = bench_hist_now_ns();
+        deflateInit(&z, comp_levels[l]);
+        z.next_out = packed;
+        z.avail_out = bound;
+        for (pos = 0; pos < COMP_CORPUS_SIZE; pos += COMP_SEGMENT) {
+            z.next_in = cd->corpus + pos;
+            z.avail_in = COMP_SEGMENT;
+            deflate(&z, pos + COMP_SEGMENT < COMP_CORPUS_SIZE ? Z_NO_FLUSH : Z_FINISH);
+        }
+        s->out = z.total_out;
+        deflateEnd(&z);
+        s->ns[0] = bench_hist_now_ns() - t0;
+        s->in = COMP_CORPUS_SIZE;
+
+        memset(&z, 0, sizeof(z));
+        t0 = bench_hist_now_ns();
+        inflateInit(&z);
+        z.next_in = packed;
+        z.avail_in = s->out;
+        pos = 0;
+        do {
+            z.next_out = out;
+            z.avail_out = COMP_SEGMENT;
+            ret = inflate(&z, Z_NO_FLUSH);
+            if (pos + (COMP_SEGMENT - z.avail_out) > COMP_CORPUS_SIZE ||
+                memcmp(cd->corpus + pos, out, COMP_SEGMENT - z.avail_out)) {
+                cd->errors++;
+                break;
+            }
+            pos += COMP_SEGMENT - z.avail_out;
+        } while (ret == Z_OK);
+        inflateEnd(&z);
+        s->ns[1] = bench_hist_now_ns() - t0;
+        if (ret != Z_STREAM_END || pos != COMP_CORPUS_SIZE)
+            cd->errors++;
+    }
+
+    g_free(packed);
+    g_free(out);
+    return NULL;
+}
+
+/* "compress 95/38/11 MB/s, decompress 410/430/440 MB/s, ratio ..." */
+static void comp_extra(bench_value *r, const double *comp, const double *decomp,
+                       const double *ratio)
+{
+    GString *str[3];
+    gint l, i;
+
+    for (i = 0; i < 3; i++)
+        str[i] = g_string_new(NULL);
+    for (l = 0; l < COMP_N_LEVELS; l++) {
+        const gchar *sep = l ? "/" : "";
+        g_string_append_printf(str[0], "%s%0.0f", sep, comp[l]);
+        g_string_append_printf(str[1], "%s%0.0f", sep, decomp[l]);
+        g_string_append_printf(str[2], "%s%0.2f", sep, ratio[l]);
+    }
+    bench_value_append_extra(r, "compress %s MB/s, decompress %s MB/s, "
+                             "ratio %s at levels 1/6/9",
+                             str[0]->str, str[1]->str, str[2]->str);
+    for (i = 0; i < 3; i++)
+        g_string_free(str[i], TRUE);
+}
+
+static CompData *comp_data_new(gint n_workers)
+{
+    CompData *cd = g_new0(CompData, 1);
+
+    cd->corpus = comp_corpus();
+    cd->w = g_new0(CompWorker, n_workers);
+    return cd;
+}
+
+static void comp_data_free(CompData *cd, gint n_workers)
+{
+    gint t;
+
+    for (t = 0; t < n_workers; t++) {
+        g_free(cd->w[t].packed);
+        g_free(cd->w[t].unpacked);
+    }
+    g_free(cd->w);
+    g_free(cd->corpus);
+    g_free(cd);
+}
+
+void benchmark_zlib_levels(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    double comp[COMP_N_LEVELS], decomp[COMP_N_LEVELS], ratio[COMP_N_LEVELS];
+    CompData *cd;
+    gint n_threads, t, l;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running zlib levels benchmark...");
+
+    n_threads = benchmark_threads(0);
+    cd = comp_data_new(n_threads);
+    for (t = 0; t < n_threads; t++) {
+        cd->w[t].packed = g_malloc(compressBound(COMP_BLOCK));
+        cd->w[t].unpacked = g_malloc(COMP_BLOCK);
+        /* apart, so the workers don't all share the same blocks */
+        cd->w[t].pos = (gsize)t * COMP_BLOCK * 7 % COMP_CORPUS_SIZE;
+    }
+
+    r = benchmark_crunch_for(CRUNCH_TIME, n_threads, comp_levels_for, cd);
+
+    /* bytes/ns*1000 is MB/s; the sum of the workers' speeds */
+    for (l = 0; l < COMP_N_LEVELS; l++) {
+        guint64 in = 0, out = 0;
+
+        comp[l] = decomp[l] = 0;
+        for (t = 0; t < n_threads; t++) {
+            const CompStats *s = &cd->w[t].level[l];
+            if (!s->ns[0] || !s->ns[1])
+                continue;
+            comp[l] += s->in * 1e3 / s->ns[0];
+            decomp[l] += s->in * 1e3 / s->ns[1];
+            in += s->in;
+            out += s->out;
+        }
+        ratio[l] = out ? (double)in / out : 0;
+    }
+
+    if (comp[COMP_DEFAULT] > 0) {
+        r.result = comp[COMP_DEFAULT];
+        r.revision = BENCH_REVISION;
+        comp_extra(&r, comp, decomp, ratio);
+        if (cd->errors)
+            bench_value_append_extra(&r, "%d errors", cd->errors);
+    } else {
+        r.result = -1;
+    }
+    if (cd->errors)
+        bench_msg("zlib error: uncompressed != original");
+
+    comp_data_free(cd, n_threads);
+    bench_results[BENCHMARK_ZLIB_LEVELS] = r;
+}
+
+void benchmark_zlib_streaming(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    double comp[COMP_N_LEVELS], decomp[COMP_N_LEVELS], ratio[COMP_N_LEVELS];
+    CompData *cd;
+    guint64 t0;
+    gint l;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running zlib streaming benchmark...");
+
+    cd = comp_data_new(1);
+    t0 = bench_hist_now_ns();
+    comp_stream(0, 0, cd, 0);
+    r.elapsed_time = (bench_hist_now_ns() - t0) / 1e9;
+    r.threads_used = 1;
+
+    for (l = 0; l < COMP_N_LEVELS; l++) {
+        const CompStats *s = &cd->w[0].level[l];
+        comp[l] = s->ns[0] ? s->in * 1e3 / s->ns[0] : 0;
+        decomp[l] = s->ns[1] ? s->in * 1e3 / s->ns[1] : 0;
+        ratio[l] = s->out ? (double)s->in / s->out : 0;
+    }
+
+    if (comp[COMP_DEFAULT] > 0) {
+        r.result = comp[COMP_DEFAULT];
+        r.revision = BENCH_REVISION;
+        comp_extra(&r, comp, decomp, ratio);
+        bench_value_append_extra(&r, "%d MiB corpus", COMP_CORPUS_SIZE >> 20);
+        if (cd->errors)
+            bench_value_append_extra(&r, "%d errors", cd->errors);
+    } else {
+        r.result = -1;
+    }
+    if (cd->errors)
+        bench_msg("zlib error: uncompressed != original");
+
+    comp_data_free(cd, 1);
+    bench_results[BENCHMARK_ZLIB_STREAMING] = r;
+}
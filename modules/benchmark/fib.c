@@ -58,3 +58,134 @@ benchmark_fib(void)
 
     bench_results[BENCHMARK_FIB] = r;
 }
+
+/* The same recursion as fork-join tasks on the work-stealing scheduler:
+ * one of the two calls is a task, down to FIB_TASK_DEPTH calls deep,
+ * and the rest is plain fib(). The tasks are small enough that the
+ * spawning, syncing and stealing show in the time.
+ *
+ * It runs three times: fib() alone on one thread, the tasks on one
+ * worker, where nothing can be stolen, and the tasks on all the
+ * threads. The first two give the cost of one spawn, the last the
+ * result, in tasks/s. */
+
+#define FIB_TASK_N 30
+#define FIB_TASK_DEPTH 14
+#define FIB_TASK_TIME 2
+
+typedef struct {
+    gulong n, result;
+    gint depth;
+} FibTask;
+
+static void fib_task(BenchSteal *s, gint worker, gpointer arg)
+{
+    FibTask *t = arg, a, b;
+    gint join = 0;
+
+    if (t->depth >= FIB_TASK_DEPTH || t->n <= 2) {
+        t->result = fib(t->n);
+        return;
+    }
+
+    a.n = t->n - 1;
+    a.depth = t->depth + 1;
+    b.n = t->n - 2;
+    b.depth = t->depth + 1;
+    bench_steal_spawn(s, worker, fib_task, &a, &join);
+    fib_task(s, worker, &b);
+    bench_steal_sync(s, worker, &join);
+
+    t->result = a.result + b.result;
+}
+
+static gulong fib_task_answer;
+
+static void fib_task_root(BenchSteal *s, gint worker, gpointer arg)
+{
+    FibTask root = { FIB_TASK_N, 0, 0 };
+    gint *errors = arg;
+
+    fib_task(s, worker, &root);
+    if (root.result != fib_task_answer)
+        (*errors)++;
+}
+
+static gpointer fib_task_serial(void *in_data, gint thread_number)
+{
+    fib(FIB_TASK_N);
+
+    return NULL;
+}
+
+static guint64 fib_task_count(BenchStealWorker *counts, gint n, guint64 *steals)
+{
+    guint64 tasks = 0;
+    gint i;
+
+    for (*steals = 0, i = 0; i < n; i++) {
+        tasks += counts[i].tasks;
+        *steals += counts[i].steals;
+    }
+    return tasks;
+}
+
+void
+benchmark_fib_tasks(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE, serial, one;
+    BenchStealWorker *counts;
+    guint64 tasks, one_tasks = 0, steals;
+    double t_serial, t_one;
+    gint n_threads, errors = 0;
+    gboolean references;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Spawning Fibonacci tasks...");
+
+    n_threads = benchmark_threads(0);
+    counts = g_new0(BenchStealWorker, n_threads);
+    fib_task_answer = fib(FIB_TASK_N);
+
+    /* a --bench-sweep step runs everything at its own thread count, so
+     * there are no one-thread references to compare with; the sweep
+     * only keeps the result */
+    references = (benchmark_threads(1) == 1);
+    if (references) {
+        serial = benchmark_crunch_for(FIB_TASK_TIME, 1, fib_task_serial, NULL);
+        one = bench_steal_for(FIB_TASK_TIME, 1, fib_task_root, &errors, counts);
+        one_tasks = fib_task_count(counts, 1, &steals);
+    }
+    r = bench_steal_for(FIB_TASK_TIME, n_threads, fib_task_root, &errors, counts);
+    tasks = fib_task_count(counts, n_threads, &steals);
+    g_free(counts);
+
+    if (errors)
+        bench_msg("%d runs did not find fib(%d)", errors, FIB_TASK_N);
+    if (r.elapsed_time <= 0 || !tasks ||
+        (references && (serial.result <= 0 || one.result <= 0))) {
+        r.result = -1;
+        bench_results[BENCHMARK_FIB_TASKS] = r;
+        return;
+    }
+
+    r.revision = BENCH_REVISION;
+    if (references) {
+        t_serial = serial.elapsed_time / serial.result;
+        t_one = one.elapsed_time / one.result;
+
+        bench_thermal_merge(&r.thermal, &one.thermal);
+        bench_thermal_merge(&r.thermal, &serial.thermal);
+        bench_value_append_extra(&r, "a:%d, depth %d, %0.0f tasks/run, "
+                                 "%0.1f ns/spawn, %0.1f%% stolen, %0.2fx serial",
+                                 FIB_TASK_N, FIB_TASK_DEPTH, one_tasks / one.result,
+                                 1e9 * (t_one - t_serial) * one.result / one_tasks,
+                                 100.0 * steals / tasks,
+                                 t_serial / (r.elapsed_time / r.result));
+    }
+    if (errors)
+        bench_value_append_extra(&r, "%d wrong results", errors);
+    r.result = tasks / r.elapsed_time;
+
+    bench_results[BENCHMARK_FIB_TASKS] = r;
+}
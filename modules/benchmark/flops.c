@@ -0,0 +1,196 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* Peak double precision FLOPS of each SIMD level the cpu has.
+ *
+ * Every level has its own kernel, compiled for that instruction set
+ * with a target attribute: FLOPS_ACC independent vector accumulators,
+ * each updated with a multiply-add per iteration, so the FMA (or the
+ * multiply and add) units never wait on a result. A level runs when
+ * the cpu flags the devices module reads from /proc/cpuinfo have
+ * everything it needs; without the flags, only the first level, the
+ * baseline of the architecture, runs.
+ *
+ * The clock is sampled while each level runs. Where AVX-512 runs
+ * slower than AVX2, the drop is noted. The result is the GFLOPS of the
+ * fastest level. */
+
+/* if anything changes in this block, increment revision */
+#define BENCH_REVISION 1
+#define FLOPS_SECONDS 2 /* per level */
+#define FLOPS_ITER 65536 /* per callback */
+#define FLOPS_ACC 12
+#define FLOPS_MUL 0.999999
+#define FLOPS_ADD 0.0000005 /* converges on 0.5, away from the start values */
+
+/* FLOPS_ITER multiply-adds on each lane of FLOPS_ACC accumulators; the
+ * sum goes in *out so none of it can be left out */
+#define FLOPS_KERNEL(fn, vtype, target)                                     \
+    static target void fn(double *out)                                  \
+    {                                                                   \
+        vtype zero = { 0 };                                             \
+        vtype m = zero + FLOPS_MUL, c = zero + FLOPS_ADD;               \
+        vtype a0 = zero + 1, a1 = zero + 2, a2 = zero + 3, a3 = zero + 4; \
+        vtype a4 = zero + 5, a5 = zero + 6, a6 = zero + 7, a7 = zero + 8; \
+        vtype a8 = zero + 9, a9 = zero + 10, a10 = zero + 11, a11 = zero + 12; \
+        vtype t;                                                        \
+        double s = 0;                                                   \
+        guint i;                                                        \
+                                                                        \
+        for (i = 0; i < FLOPS_ITER; i++) {                              \
+            a0 = a0 * m + c; a1 = a1 * m + c; a2 = a2 * m + c;          \
+            a3 = a3 * m + c; a4 = a4 * m + c; a5 = a5 * m + c;          \
+            a6 = a6 * m + c; a7 = a7 * m + c; a8 = a8 * m + c;          \
+            a9 = a9 * m + c; a10 = a10 * m + c; a11 = a11 * m + c;      \
+        }                                                               \
+        t = a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11; \
+        for (i = 0; i < sizeof(vtype) / sizeof(double); i++)            \
+            s += t[i];                                                  \
+        *out = s;                                                       \
+    }
+
+typedef double v2d __attribute__((vector_size(16)));
+
+#if defined(__x86_64__) || defined(__i386__)
+typedef double v4d __attribute__((vector_size(32)));
+typedef double v8d __attribute__((vector_size(64)));
+
+FLOPS_KERNEL(flops_sse2, v2d, __attribute__((target("sse2"))))
+FLOPS_KERNEL(flops_avx, v4d, __attribute__((target("avx"))))
+FLOPS_KERNEL(flops_avx2, v4d, __attribute__((target("avx2,fma"))))
+FLOPS_KERNEL(flops_avx512, v8d, __attribute__((target("avx512f"))))
+#elif defined(__aarch64__)
+/* Advanced SIMD is part of AArch64; fused with fmla */
+FLOPS_KERNEL(flops_neon, v2d, )
+#else
+FLOPS_KERNEL(flops_generic, v2d, )
+#endif
+
+typedef struct {
+    const gchar *name;
+    const gchar *flags; /* all needed, as in /proc/cpuinfo */
+    gint lanes;
+    void (*kernel)(double *out);
+} FlopsLevel;
+
+static const FlopsLevel flops_levels[] = {
+#if defined(__x86_64__) || defined(__i386__)
+    { "SSE2", "sse2", 2, flops_sse2 },
+    { "AVX", "avx", 4, flops_avx },
+    { "AVX2", "avx2 fma", 4, flops_avx2 },
+    { "AVX-512", "avx512f", 8, flops_avx512 },
+#elif defined(__aarch64__)
+    { "NEON", "", 2, flops_neon },
+#else
+    { "generic", "", 2, flops_generic },
+#endif
+};
+
+#define FLOPS_N_LEVELS ((gint)G_N_ELEMENTS(flops_levels))
+
+typedef struct {
+    const FlopsLevel *level;
+    double *out; /* 8 apart, one cache line per thread */
+} FlopsData;
+
+static gpointer flops_for(void *data, gint thread_number)
+{
+    FlopsData *fd = data;
+
+    fd->level->kernel(&fd->out[thread_number * 8]);
+    return NULL;
+}
+
+static void benchmark_flops_run(gint n_threads, gint entry)
+{
+    bench_value r = EMPTY_BENCH_VALUE, lr;
+    FlopsData fd;
+    gchar **cpu_flags;
+    GString *names, *values;
+    double gflops[FLOPS_N_LEVELS], mhz[FLOPS_N_LEVELS];
+    gint i, best = -1, avx2 = -1, avx512 = -1;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Performing SIMD FLOPS benchmark...");
+
+    cpu_flags = bench_cpu_flags();
+
+    n_threads = benchmark_threads(n_threads);
+    fd.out = g_new0(double, n_threads * 8);
+    for (i = 0; i < FLOPS_N_LEVELS && !params.aborting_benchmarks; i++) {
+        gflops[i] = mhz[i] = 0;
+        if (cpu_flags ? !bench_cpu_has(cpu_flags, flops_levels[i].flags) : i > 0)
+            continue;
+
+        fd.level = &flops_levels[i];
+        lr = benchmark_crunch_for(FLOPS_SECONDS, n_threads, flops_for, &fd);
+        if (lr.elapsed_time <= 0)
+            continue;
+        gflops[i] = lr.result * FLOPS_ITER * FLOPS_ACC * flops_levels[i].lanes *
+                    2 / lr.elapsed_time / 1e9;
+        if (lr.thermal.samples)
+            mhz[i] = lr.thermal.mhz_avg;
+        if (best < 0 || gflops[i] > gflops[best]) {
+            bench_thermal_merge(&lr.thermal, &r.thermal);
+            r = lr;
+            best = i;
+        } else {
+            bench_thermal_merge(&r.thermal, &lr.thermal);
+        }
+        if (g_str_equal(flops_levels[i].name, "AVX2"))
+            avx2 = i;
+        if (g_str_equal(flops_levels[i].name, "AVX-512"))
+            avx512 = i;
+    }
+    g_free(fd.out);
+    g_strfreev(cpu_flags);
+
+    if (best >= 0) {
+        r.result = gflops[best];
+        r.revision = BENCH_REVISION;
+        names = g_string_new(NULL);
+        values = g_string_new(NULL);
+        for (i = 0; i < FLOPS_N_LEVELS; i++) {
+            if (gflops[i] <= 0)
+                continue;
+            g_string_append_printf(names, "%s%s", names->len ? "/" : "",
+                                   flops_levels[i].name);
+            g_string_append_printf(values, "%s%0.1f", values->len ? "/" : "",
+                                   gflops[i]);
+        }
+        bench_value_append_extra(&r, "%s %s GFLOPS", names->str, values->str);
+        g_string_free(names, TRUE);
+        g_string_free(values, TRUE);
+        if (avx2 >= 0 && avx512 >= 0 && mhz[avx2] > 0 && mhz[avx512] > 0) {
+            if (mhz[avx512] < mhz[avx2] * 0.97)
+                bench_value_append_extra(&r, "AVX-512 clock %0.0f MHz, %0.0f%% below AVX2",
+                                         mhz[avx512],
+                                         100 * (1 - mhz[avx512] / mhz[avx2]));
+            else
+                bench_value_append_extra(&r, "no AVX-512 clock drop");
+        }
+    }
+
+    bench_results[entry] = r;
+}
+
+void benchmark_flops_single(void) { benchmark_flops_run(1, BENCHMARK_FLOPS_SINGLE); }
+void benchmark_flops_all(void) { benchmark_flops_run(0, BENCHMARK_FLOPS_ALL); }
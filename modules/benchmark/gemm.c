@@ -0,0 +1,416 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <math.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* Dense matrix multiply, C = A B with n x n matrices, in double (DGEMM)
+ * and single (SGEMM) precision, blocked the way BLAS libraries do it.
+ *
+ * C is cut in GEMM_MC x GEMM_NC tiles, the tasks. Workers take the next
+ * task from a shared counter, so the tiles of a multiply spread over
+ * all the threads and a new multiply starts as the last tiles finish.
+ * For a task, A's rows are packed GEMM_KC columns at a time into
+ * GEMM_MR row panels and B's columns into GEMM_NR column panels, which
+ * stay in L2 and L1 while a register-blocked kernel multiplies them:
+ * GEMM_MR rows by two vectors, twelve accumulators, compiled for each
+ * SIMD level with a target attribute like the FLOPS benchmark.
+ *
+ * The tile goes to a buffer of the worker rather than to C, so tasks
+ * of two multiplies never write the same memory; the traffic of C is
+ * n^2 against n^3 / GEMM_MC for A and B. The kernels are checked
+ * against a plain triple loop before they run.
+ *
+ * Three sizes: A and B about L2, about the last level cache and four
+ * times that, in DRAM, up to GEMM_MAX_BYTES. The result is the GFLOPS
+ * of the largest. */
+
+/* if anything changes in this block, increment revision */
+#define BENCH_REVISION 1
+#define GEMM_SECONDS 2 /* per size */
+#define GEMM_MR 6
+#define GEMM_MC 96  /* rows of a task; GEMM_MR * 16 */
+#define GEMM_NC 192 /* columns of a task; a multiple of every GEMM_NR */
+#define GEMM_KC 256
+#define GEMM_STEP 192 /* sizes are multiples of GEMM_MC and GEMM_NC */
+#define GEMM_CHECK_N 192
+#define GEMM_MAX_BYTES (512 << 20) /* A and B */
+
+/* C[GEMM_MR][2 vectors] = A panel * B panel over kc; ct is row-major
+ * with 2 * vector length columns */
+#define GEMM_KERNEL(fn, T, vtype, target)                                  \
+    static target void fn(gint kc, const T *a, const T *b, T *ct)      \
+    {                                                                  \
+        const gint vl = sizeof(vtype) / sizeof(T);                     \
+        vtype c0a = { 0 }, c0b = { 0 }, c1a = { 0 }, c1b = { 0 };      \
+        vtype c2a = { 0 }, c2b = { 0 }, c3a = { 0 }, c3b = { 0 };      \
+        vtype c4a = { 0 }, c4b = { 0 }, c5a = { 0 }, c5b = { 0 };      \
+        vtype b0, b1;                                                  \
+        gint k;                                                        \
+                                                                       \
+        for (k = 0; k < kc; k++, a += GEMM_MR, b += 2 * vl) {          \
+            memcpy(&b0, b, sizeof(vtype));                             \
+            memcpy(&b1, b + vl, sizeof(vtype));                        \
+            c0a += a[0] * b0; c0b += a[0] * b1;                        \
+            c1a += a[1] * b0; c1b += a[1] * b1;                        \
+            c2a += a[2] * b0; c2b += a[2] * b1;                        \
+            c3a += a[3] * b0; c3b += a[3] * b1;                        \
+            c4a += a[4] * b0; c4b += a[4] * b1;                        \
+            c5a += a[5] * b0; c5b += a[5] * b1;                        \
+        }                                                              \
+        memcpy(ct, &c0a, sizeof(vtype));                               \
+        memcpy(ct + vl, &c0b, sizeof(vtype));                          \
+        memcpy(ct + 2 * vl, &c1a, sizeof(vtype));                      \
+        memcpy(ct + 3 * vl, &c1b, sizeof(vtype));                      \
+        memcpy(ct + 4 * vl, &c2a, sizeof(vtype));                      \
+        memcpy(ct + 5 * vl, &c2b, sizeof(vtype));                      \
+        memcpy(ct + 6 * vl, &c3a, sizeof(vtype));                      \
+        memcpy(ct + 7 * vl, &c3b, sizeof(vtype));                      \
+        memcpy(ct + 8 * vl, &c4a, sizeof(vtype));                      \
+        memcpy(ct + 9 * vl, &c4b, sizeof(vtype));                      \
+        memcpy(ct + 10 * vl, &c5a, sizeof(vtype));                     \
+        memcpy(ct + 11 * vl, &c5b, sizeof(vtype));                     \
+    }
+
+typedef double v2d __attribute__((vector_size(16)));
+typedef float v4f __attribute__((vector_size(16)));
+
+#if defined(__x86_64__) || defined(__i386__)
+typedef double v4d __attribute__((vector_size(32)));
+typedef double v8d __attribute__((vector_size(64)));
+typedef float v8f __attribute__((vector_size(32)));
+typedef float v16f __attribute__((vector_size(64)));
+
+GEMM_KERNEL(gemm_d_sse2, double, v2d, __attribute__((target("sse2"))))
+GEMM_KERNEL(gemm_s_sse2, float, v4f, __attribute__((target("sse2"))))
+GEMM_KERNEL(gemm_d_avx, double, v4d, __attribute__((target("avx"))))
+GEMM_KERNEL(gemm_s_avx, float, v8f, __attribute__((target("avx"))))
+GEMM_KERNEL(gemm_d_avx2, double, v4d, __attribute__((target("avx2,fma"))))
+GEMM_KERNEL(gemm_s_avx2, float, v8f, __attribute__((target("avx2,fma"))))
+GEMM_KERNEL(gemm_d_avx512, double, v8d, __attribute__((target("avx512f"))))
+GEMM_KERNEL(gemm_s_avx512, float, v16f, __attribute__((target("avx512f"))))
+#elif defined(__aarch64__)
+GEMM_KERNEL(gemm_d_neon, double, v2d, )
+GEMM_KERNEL(gemm_s_neon, float, v4f, )
+#else
+GEMM_KERNEL(gemm_d_generic, double, v2d, )
+GEMM_KERNEL(gemm_s_generic, float, v4f, )
+#endif
+
+typedef struct {
+    const gchar *name;
+    const gchar *flags; /* all needed, as in /proc/cpuinfo */
+    gint nr;            /* columns of the double kernel; twice that in float */
+    void (*kd)(gint kc, const double *a, const double *b, double *ct);
+    void (*ks)(gint kc, const float *a, const float *b, float *ct);
+} GemmLevel;
+
+static const GemmLevel gemm_levels[] = {
+#if defined(__x86_64__) || defined(__i386__)
+    { "SSE2", "sse2", 4, gemm_d_sse2, gemm_s_sse2 },
+    { "AVX", "avx", 8, gemm_d_avx, gemm_s_avx },
+    { "AVX2", "avx2 fma", 8, gemm_d_avx2, gemm_s_avx2 },
+    { "AVX-512", "avx512f", 16, gemm_d_avx512, gemm_s_avx512 },
+#elif defined(__aarch64__)
+    { "NEON", "", 4, gemm_d_neon, gemm_s_neon },
+#else
+    { "generic", "", 4, gemm_d_generic, gemm_s_generic },
+#endif
+};
+
+/* the packing and the tile of a task, for each precision; kern and nr
+ * are those of the precision */
+#define GEMM_TYPE(T, sfx, kern, nr_of)                                      \
+    static void gemm_pack_a_##sfx(const T *A, gint n, gint ic, gint pc, \
+                                  gint kc, T *ap)                       \
+    {                                                                   \
+        gint p, k, i;                                                   \
+                                                                        \
+        for (p = 0; p < GEMM_MC; p += GEMM_MR) {                        \
+            for (k = 0; k < kc; k++) {                                  \
+                for (i = 0; i < GEMM_MR; i++)                           \
+                    *ap++ = A[(gsize)(ic + p + i) * n + pc + k];        \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+                                                                        \
+    static void gemm_pack_b_##sfx(const T *B, gint n, gint pc, gint jc, \
+                                  gint kc, gint nr, T *bp)              \
+    {                                                                   \
+        gint q, k;                                                      \
+                                                                        \
+        for (q = 0; q < GEMM_NC; q += nr) {                             \
+            for (k = 0; k < kc; k++, bp += nr)                          \
+                memcpy(bp, &B[(gsize)(pc + k) * n + jc + q], nr * sizeof(T)); \
+        }                                                               \
+    }                                                                   \
+                                                                        \
+    /* C[GEMM_MC][GEMM_NC], ldc apart, = A[ic..] B[..jc] */             \
+    static void gemm_tile_##sfx(const GemmLevel *l, gint n, const T *A, \
+                                const T *B, gint ic, gint jc, T *C,     \
+                                gint ldc, T *ap, T *bp)                 \
+    {                                                                   \
+        const gint nr = nr_of;                                          \
+        T ct[GEMM_MR * 32], *c;                                         \
+        gint pc, kc, ir, jr, i, j;                                      \
+                                                                        \
+        for (pc = 0; pc < n; pc += GEMM_KC) {                           \
+            kc = MIN(GEMM_KC, n - pc);                                  \
+            gemm_pack_a_##sfx(A, n, ic, pc, kc, ap);                    \
+            gemm_pack_b_##sfx(B, n, pc, jc, kc, nr, bp);                \
+            for (jr = 0; jr < GEMM_NC; jr += nr) {                      \
+                for (ir = 0; ir < GEMM_MC; ir += GEMM_MR) {             \
+                    l->kern(kc, ap + ir * kc, bp + jr * kc, ct);        \
+                    for (i = 0; i < GEMM_MR; i++) {                     \
+                        c = C + (gsize)(ir + i) * ldc + jr;             \
+                        for (j = 0; j < nr; j++)                        \
+                            c[j] = pc ? c[j] + ct[i * nr + j] : ct[i * nr + j]; \
+                    }                                                   \
+                }                                                       \
+            }                                                           \
+        }                                                               \
+    }
+
+GEMM_TYPE(double, d, kd, l->nr)
+GEMM_TYPE(float, s, ks, 2 * l->nr)
+
+typedef struct {
+    gpointer ap, bp, c; /* packed A and B, the C tile */
+    gchar pad[64 - 3 * sizeof(gpointer)];
+} GemmThread;
+
+typedef struct {
+    const GemmLevel *level;
+    gboolean single; /* float */
+    gint n, n_tasks;
+    gpointer a, b;
+    GemmThread *t;
+    gint next;
+} GemmData;
+
+static gpointer gemm_for(void *data, gint thread_number)
+{
+    GemmData *gd = data;
+    GemmThread *t = &gd->t[thread_number];
+    guint task = (guint)g_atomic_int_add(&gd->next, 1) % gd->n_tasks;
+    gint ic = task / (gd->n / GEMM_NC) * GEMM_MC;
+    gint jc = task % (gd->n / GEMM_NC) * GEMM_NC;
+
+    if (gd->single)
+        gemm_tile_s(gd->level, gd->n, gd->a, gd->b, ic, jc, t->c, GEMM_NC,
+                    t->ap, t->bp);
+    else
+        gemm_tile_d(gd->level, gd->n, gd->a, gd->b, ic, jc, t->c, GEMM_NC,
+                    t->ap, t->bp);
+    return NULL;
+}
+
+static gpointer gemm_alloc(gsize bytes)
+{
+    void *p = NULL;
+
+    if (posix_memalign(&p, 64, bytes))
+        return NULL;
+    return p;
+}
+
+static void gemm_fill(gpointer m, gboolean single, gsize count, guint64 seed)
+{
+    double v;
+    gsize i;
+
+    for (i = 0; i < count; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        v = (double)(seed >> 11) / (1ULL << 53) * 2 - 1;
+        if (single)
+            ((float *)m)[i] = v;
+        else
+            ((double *)m)[i] = v;
+    }
+}
+
+/* every tile of a small multiply against the plain triple loop */
+static gboolean gemm_check(const GemmLevel *l, gboolean single)
+{
+    const gint n = GEMM_CHECK_N;
+    gsize es = single ? sizeof(float) : sizeof(double);
+    gchar *a = g_malloc(n * n * es), *b = g_malloc(n * n * es);
+    gchar *c = g_malloc(n * n * es);
+    gpointer ap = g_malloc(GEMM_MC * GEMM_KC * es), bp = g_malloc(GEMM_KC * GEMM_NC * es);
+    gboolean ok = TRUE;
+    double sum, got, err = 0;
+    gint ic, jc, i, j, k;
+
+    gemm_fill(a, single, n * n, 1);
+    gemm_fill(b, single, n * n, 2);
+    for (ic = 0; ic < n; ic += GEMM_MC) {
+        for (jc = 0; jc < n; jc += GEMM_NC) {
+            if (single)
+                gemm_tile_s(l, n, (float *)a, (float *)b, ic, jc,
+                            (float *)c + ic * n + jc, n, ap, bp);
+            else
+                gemm_tile_d(l, n, (double *)a, (double *)b, ic, jc,
+                            (double *)c + ic * n + jc, n, ap, bp);
+        }
+    }
+    for (i = 0; i < n && ok; i++) {
+        for (j = 0; j < n; j++) {
+            sum = 0;
+            for (k = 0; k < n; k++)
+                sum += single ? (double)((float *)a)[i * n + k] * ((float *)b)[k * n + j]
+                              : ((double *)a)[i * n + k] * ((double *)b)[k * n + j];
+            got = single ? ((float *)c)[i * n + j] : ((double *)c)[i * n + j];
+            err = MAX(err, fabs(got - sum));
+        }
+        /* the sums are of n terms about 1/3 each */
+        ok = err < (single ? 1e-3 : 1e-10) * n;
+    }
+    g_free(a);
+    g_free(b);
+    g_free(c);
+    g_free(ap);
+    g_free(bp);
+    if (!ok)
+        bench_msg("%s %s kernel is off by %g, not used", l->name,
+                  single ? "float" : "double", err);
+    return ok;
+}
+
+static gint gemm_round(double n, gboolean up)
+{
+    gint r = (up ? ceil(n / GEMM_STEP) : floor(n / GEMM_STEP)) * GEMM_STEP;
+
+    return MAX(r, GEMM_STEP);
+}
+
+static void benchmark_gemm(gboolean single, gint entry)
+{
+    bench_value r = EMPTY_BENCH_VALUE, lr;
+    GemmData gd;
+    gsize es = single ? sizeof(float) : sizeof(double);
+    gsize llc = bench_llc_bytes(), ram;
+    gchar **cpu_flags;
+    GString *sizes, *values;
+    gint n[3], n_sizes = 0, n_threads, i, t, last = -1;
+    double gflops[3] = { 0 };
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update(single ? "Running SGEMM benchmark..." : "Running DGEMM benchmark...");
+
+    memset(&gd, 0, sizeof(gd));
+    gd.single = single;
+    cpu_flags = bench_cpu_flags();
+    for (i = 0; i < (gint)G_N_ELEMENTS(gemm_levels); i++) {
+        if (cpu_flags ? !bench_cpu_has(cpu_flags, gemm_levels[i].flags) : i > 0)
+            continue;
+        if (gemm_check(&gemm_levels[i], single))
+            gd.level = &gemm_levels[i];
+        else if (!i)
+            break;
+    }
+    g_strfreev(cpu_flags);
+    if (!gd.level) {
+        bench_results[entry] = r;
+        return;
+    }
+
+    /* A and B in L2, about the LLC, 4 times the LLC */
+    if (!llc)
+        llc = 32 << 20;
+    ram = (gsize)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+    ram = ram ? MIN(ram / 4, GEMM_MAX_BYTES) : GEMM_MAX_BYTES;
+    n[n_sizes++] = GEMM_STEP;
+    i = gemm_round(sqrt(llc / 2.0 / es), FALSE);
+    if (i > n[n_sizes - 1])
+        n[n_sizes++] = i;
+    i = gemm_round(sqrt(4.0 * llc / 2 / es), TRUE);
+    while (2.0 * i * i * es > ram && i > GEMM_STEP)
+        i -= GEMM_STEP;
+    if (i > n[n_sizes - 1])
+        n[n_sizes++] = i;
+
+    n_threads = benchmark_threads(0);
+    gd.t = g_new0(GemmThread, n_threads);
+    for (t = 0; t < n_threads; t++) {
+        gd.t[t].ap = gemm_alloc(GEMM_MC * GEMM_KC * es);
+        gd.t[t].bp = gemm_alloc(GEMM_KC * GEMM_NC * es);
+        gd.t[t].c = gemm_alloc(GEMM_MC * GEMM_NC * es);
+    }
+
+    for (i = 0; i < n_sizes && !params.aborting_benchmarks; i++) {
+        gd.n = n[i];
+        gd.n_tasks = (n[i] / GEMM_MC) * (n[i] / GEMM_NC);
+        gd.next = 0;
+        gd.a = bench_huge_alloc((gsize)n[i] * n[i] * es);
+        gd.b = bench_huge_alloc((gsize)n[i] * n[i] * es);
+        if (!gd.a || !gd.b) {
+            bench_msg("unable to allocate two %dx%d matrices", n[i], n[i]);
+            free(gd.a);
+            free(gd.b);
+            break;
+        }
+        gemm_fill(gd.a, single, (gsize)n[i] * n[i], 1);
+        gemm_fill(gd.b, single, (gsize)n[i] * n[i], 2);
+
+        lr = benchmark_crunch_for(GEMM_SECONDS, n_threads, gemm_for, &gd);
+        if (lr.elapsed_time > 0) {
+            gflops[i] = lr.result * 2.0 * GEMM_MC * GEMM_NC * n[i] /
+                        lr.elapsed_time / 1e9;
+            /* the largest is the result */
+            bench_thermal_merge(&lr.thermal, &r.thermal);
+            r = lr;
+            last = i;
+        }
+
+        free(gd.a);
+        free(gd.b);
+    }
+
+    for (t = 0; t < n_threads; t++) {
+        free(gd.t[t].ap);
+        free(gd.t[t].bp);
+        free(gd.t[t].c);
+    }
+    g_free(gd.t);
+
+    if (last >= 0) {
+        r.result = gflops[last];
+        r.revision = BENCH_REVISION;
+        sizes = g_string_new(NULL);
+        values = g_string_new(NULL);
+        for (i = 0; i <= last; i++) {
+            g_string_append_printf(sizes, "%s%d", i ? "/" : "", n[i]);
+            g_string_append_printf(values, "%s%0.1f", i ? "/" : "", gflops[i]);
+        }
+        bench_value_append_extra(&r, "%s, n %s %s GFLOPS", gd.level->name,
+                                 sizes->str, values->str);
+        g_string_free(sizes, TRUE);
+        g_string_free(values, TRUE);
+    } else {
+        r.result = -1;
+    }
+
+    bench_results[entry] = r;
+}
+
+void benchmark_dgemm(void) { benchmark_gemm(FALSE, BENCHMARK_DGEMM); }
+void benchmark_sgemm(void) { benchmark_gemm(TRUE, BENCHMARK_SGEMM); }
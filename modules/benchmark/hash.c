@@ -0,0 +1,566 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#include <arm_acle.h>
+#endif
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* SHA-256 and CRC32C throughput, in GB/s, with the instructions the cpu
+ * has for them: SHA-NI and SSE4.2 on x86-64, the crypto and CRC
+ * extensions on AArch64, portable C everywhere.
+ *
+ * Every worker hashes HASH_LANES buffers of HASH_BUFFER bytes together,
+ * a block or eight bytes of each in turn, so the independent chains
+ * keep the hashing units busy. Each implementation is checked with known
+ * answers and against the portable one before it runs; the one used is
+ * the last of its table that passes and that the cpu flags allow.
+ *
+ * It runs on one thread and then on all of them. The result is the
+ * GB/s of all the threads; the extra has the GB/s of each thread in
+ * both runs and of the portable code on one thread. */
+
+/* if anything changes in this block, increment revision */
+#define BENCH_REVISION 1
+#define HASH_SECONDS 2 /* per run */
+#define HASH_BUFFER (64 << 10)
+#define HASH_LANES 4
+
+typedef struct {
+    const gchar *name;
+    const gchar *flags; /* all needed, as in /proc/cpuinfo */
+    /* the digest of each of the HASH_LANES messages, big-endian */
+    void (*digest)(const guchar *const *p, gsize len, guchar (*out)[32]);
+} HashImpl;
+
+typedef struct {
+    const HashImpl *impl;
+    const guchar *p[HASH_LANES];
+} HashData;
+
+static volatile guchar hash_sink;
+
+static const guint32 sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const guint32 sha256_h0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+typedef void (*Sha256Blocks)(guint32 (*st)[8], const guchar *const *p,
+                             gsize n_blocks);
+
+#define ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_block_c(guint32 *st, const guchar *p)
+{
+    guint32 w[64], a, b, c, d, e, f, g, h, t1, t2;
+    gint i;
+
+    for (i = 0; i < 16; i++)
+        w[i] = (guint32)p[4 * i] << 24 | (guint32)p[4 * i + 1] << 16 |
+               (guint32)p[4 * i + 2] << 8 | p[4 * i + 3];
+    for (; i < 64; i++)
+        w[i] = w[i - 16] + w[i - 7] +
+               (ROR(w[i - 15], 7) ^ ROR(w[i - 15], 18) ^ (w[i - 15] >> 3)) +
+               (ROR(w[i - 2], 17) ^ ROR(w[i - 2], 19) ^ (w[i - 2] >> 10));
+
+    a = st[0]; b = st[1]; c = st[2]; d = st[3];
+    e = st[4]; f = st[5]; g = st[6]; h = st[7];
+    for (i = 0; i < 64; i++) {
+        t1 = h + (ROR(e, 6) ^ ROR(e, 11) ^ ROR(e, 25)) + ((e & f) ^ (~e & g)) +
+             sha256_k[i] + w[i];
+        t2 = (ROR(a, 2) ^ ROR(a, 13) ^ ROR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    st[0] += a; st[1] += b; st[2] += c; st[3] += d;
+    st[4] += e; st[5] += f; st[6] += g; st[7] += h;
+}
+
+static void sha256_blocks_c(guint32 (*st)[8], const guchar *const *p,
+                            gsize n_blocks)
+{
+    gsize i;
+    gint l;
+
+    for (i = 0; i < n_blocks; i++) {
+        for (l = 0; l < HASH_LANES; l++)
+            sha256_block_c(st[l], p[l] + i * 64);
+    }
+}
+
+#if defined(__x86_64__)
+#define SHA_NI __attribute__((target("sha,sse4.1")))
+
+/* s0 is ABEF and s1 CDGH, the order sha256rnds2 wants */
+static inline SHA_NI __attribute__((always_inline))
+void sha256_block_ni(__m128i *s0, __m128i *s1, const guchar *p)
+{
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+                                         0x0405060700010203ULL);
+    __m128i m[4], k, abef = *s0, cdgh = *s1;
+    gint i;
+
+#pragma GCC unroll 16
+    for (i = 0; i < 16; i++) {
+        if (i < 4)
+            m[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p + 16 * i)),
+                                    bswap);
+        else
+            m[i & 3] = _mm_sha256msg2_epu32(
+                _mm_add_epi32(_mm_sha256msg1_epu32(m[i & 3], m[(i + 1) & 3]),
+                              _mm_alignr_epi8(m[(i + 3) & 3], m[(i + 2) & 3], 4)),
+                m[(i + 3) & 3]);
+        k = _mm_add_epi32(m[i & 3], _mm_loadu_si128((const __m128i *)&sha256_k[4 * i]));
+        *s1 = _mm_sha256rnds2_epu32(*s1, *s0, k);
+        *s0 = _mm_sha256rnds2_epu32(*s0, *s1, _mm_shuffle_epi32(k, 0x0e));
+    }
+    *s0 = _mm_add_epi32(*s0, abef);
+    *s1 = _mm_add_epi32(*s1, cdgh);
+}
+
+static SHA_NI void sha256_blocks_ni(guint32 (*st)[8], const guchar *const *p,
+                                    gsize n_blocks)
+{
+    __m128i s0[HASH_LANES], s1[HASH_LANES], t;
+    gsize i;
+    gint l;
+
+    for (l = 0; l < HASH_LANES; l++) {
+        t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&st[l][0]), 0xb1);
+        s1[l] = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&st[l][4]), 0x1b);
+        s0[l] = _mm_alignr_epi8(t, s1[l], 8);
+        s1[l] = _mm_blend_epi16(s1[l], t, 0xf0);
+    }
+    for (i = 0; i < n_blocks; i++) {
+#pragma GCC unroll 4
+        for (l = 0; l < HASH_LANES; l++)
+            sha256_block_ni(&s0[l], &s1[l], p[l] + i * 64);
+    }
+    for (l = 0; l < HASH_LANES; l++) {
+        t = _mm_shuffle_epi32(s0[l], 0x1b);
+        s1[l] = _mm_shuffle_epi32(s1[l], 0xb1);
+        _mm_storeu_si128((__m128i *)&st[l][0], _mm_blend_epi16(t, s1[l], 0xf0));
+        _mm_storeu_si128((__m128i *)&st[l][4], _mm_alignr_epi8(s1[l], t, 8));
+    }
+}
+#elif defined(__aarch64__)
+#define SHA_ARM __attribute__((target("+crypto")))
+
+static inline SHA_ARM __attribute__((always_inline))
+void sha256_block_arm(uint32x4_t *s0, uint32x4_t *s1, const guchar *p)
+{
+    uint32x4_t m[4], k, t, abcd = *s0, efgh = *s1;
+    gint i;
+
+#pragma GCC unroll 16
+    for (i = 0; i < 16; i++) {
+        if (i < 4)
+            m[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p + 16 * i)));
+        else
+            m[i & 3] = vsha256su1q_u32(vsha256su0q_u32(m[i & 3], m[(i + 1) & 3]),
+                                       m[(i + 2) & 3], m[(i + 3) & 3]);
+        k = vaddq_u32(m[i & 3], vld1q_u32(&sha256_k[4 * i]));
+        t = *s0;
+        *s0 = vsha256hq_u32(*s0, *s1, k);
+        *s1 = vsha256h2q_u32(*s1, t, k);
+    }
+    *s0 = vaddq_u32(*s0, abcd);
+    *s1 = vaddq_u32(*s1, efgh);
+}
+
+static SHA_ARM void sha256_blocks_arm(guint32 (*st)[8], const guchar *const *p,
+                                      gsize n_blocks)
+{
+    uint32x4_t s0[HASH_LANES], s1[HASH_LANES];
+    gsize i;
+    gint l;
+
+    for (l = 0; l < HASH_LANES; l++) {
+        s0[l] = vld1q_u32(&st[l][0]);
+        s1[l] = vld1q_u32(&st[l][4]);
+    }
+    for (i = 0; i < n_blocks; i++) {
+#pragma GCC unroll 4
+        for (l = 0; l < HASH_LANES; l++)
+            sha256_block_arm(&s0[l], &s1[l], p[l] + i * 64);
+    }
+    for (l = 0; l < HASH_LANES; l++) {
+        vst1q_u32(&st[l][0], s0[l]);
+        vst1q_u32(&st[l][4], s1[l]);
+    }
+}
+#endif
+
+/* the full blocks, then the padding and length of each message */
+static void sha256_lanes(Sha256Blocks blocks, const guchar *const *p, gsize len,
+                         guchar (*out)[32])
+{
+    guint32 st[HASH_LANES][8];
+    guchar tail[HASH_LANES][128];
+    const guchar *tp[HASH_LANES];
+    gsize full = len / 64, rest = len % 64, n_tail = rest < 56 ? 1 : 2, i;
+    guint64 bits = (guint64)len * 8;
+    gint l;
+
+    for (l = 0; l < HASH_LANES; l++)
+        memcpy(st[l], sha256_h0, sizeof(sha256_h0));
+    blocks(st, p, full);
+
+    for (l = 0; l < HASH_LANES; l++) {
+        memset(tail[l], 0, sizeof(tail[l]));
+        memcpy(tail[l], p[l] + full * 64, rest);
+        tail[l][rest] = 0x80;
+        for (i = 0; i < 8; i++)
+            tail[l][n_tail * 64 - 1 - i] = bits >> (8 * i);
+        tp[l] = tail[l];
+    }
+    blocks(st, tp, n_tail);
+
+    for (l = 0; l < HASH_LANES; l++) {
+        for (i = 0; i < 8; i++) {
+            out[l][4 * i] = st[l][i] >> 24;
+            out[l][4 * i + 1] = st[l][i] >> 16;
+            out[l][4 * i + 2] = st[l][i] >> 8;
+            out[l][4 * i + 3] = st[l][i];
+        }
+    }
+}
+
+static void sha256_c(const guchar *const *p, gsize len, guchar (*out)[32])
+{
+    sha256_lanes(sha256_blocks_c, p, len, out);
+}
+
+#if defined(__x86_64__)
+static void sha256_ni(const guchar *const *p, gsize len, guchar (*out)[32])
+{
+    sha256_lanes(sha256_blocks_ni, p, len, out);
+}
+#elif defined(__aarch64__)
+static void sha256_arm(const guchar *const *p, gsize len, guchar (*out)[32])
+{
+    sha256_lanes(sha256_blocks_arm, p, len, out);
+}
+#endif
+
+static const HashImpl sha256_impls[] = {
+    { "portable", "", sha256_c },
+#if defined(__x86_64__)
+    { "SHA-NI", "sha_ni sse4_1", sha256_ni },
+#elif defined(__aarch64__)
+    { "ARMv8 SHA2", "sha2", sha256_arm },
+#endif
+};
+
+/* CRC32C, the Castagnoli polynomial, reflected */
+#define CRC32C_POLY 0x82f63b78
+
+static guint32 crc32c_table[8][256];
+
+static void crc32c_table_init(void)
+{
+    guint32 c;
+    gint n, k;
+
+    for (n = 0; n < 256; n++) {
+        c = n;
+        for (k = 0; k < 8; k++)
+            c = c & 1 ? (c >> 1) ^ CRC32C_POLY : c >> 1;
+        crc32c_table[0][n] = c;
+    }
+    for (n = 0; n < 256; n++) {
+        for (k = 1; k < 8; k++)
+            crc32c_table[k][n] = (crc32c_table[k - 1][n] >> 8) ^
+                                 crc32c_table[0][crc32c_table[k - 1][n] & 0xff];
+    }
+}
+
+/* slicing by 8 */
+static guint32 crc32c_update_c(guint32 c, const guchar *p, gsize len)
+{
+    guint64 v;
+
+    for (; len >= 8; p += 8, len -= 8) {
+        memcpy(&v, p, 8);
+        v = GUINT64_FROM_LE(v) ^ c;
+        c = crc32c_table[7][v & 0xff] ^ crc32c_table[6][(v >> 8) & 0xff] ^
+            crc32c_table[5][(v >> 16) & 0xff] ^ crc32c_table[4][(v >> 24) & 0xff] ^
+            crc32c_table[3][(v >> 32) & 0xff] ^ crc32c_table[2][(v >> 40) & 0xff] ^
+            crc32c_table[1][(v >> 48) & 0xff] ^ crc32c_table[0][v >> 56];
+    }
+    for (; len; p++, len--)
+        c = crc32c_table[0][(c ^ *p) & 0xff] ^ (c >> 8);
+    return c;
+}
+
+static void crc32c_out(guint32 c, guchar *out)
+{
+    c = ~c;
+    out[0] = c >> 24;
+    out[1] = c >> 16;
+    out[2] = c >> 8;
+    out[3] = c;
+}
+
+static void crc32c_c(const guchar *const *p, gsize len, guchar (*out)[32])
+{
+    guint32 c[HASH_LANES];
+    gsize i, step;
+    gint l;
+
+    for (l = 0; l < HASH_LANES; l++)
+        c[l] = ~0U;
+    /* a cache line of each in turn, like the others */
+    for (i = 0; i < len; i += step) {
+        step = MIN(64, len - i);
+        for (l = 0; l < HASH_LANES; l++)
+            c[l] = crc32c_update_c(c[l], p[l] + i, step);
+    }
+    for (l = 0; l < HASH_LANES; l++)
+        crc32c_out(c[l], out[l]);
+}
+
+#if defined(__x86_64__)
+static __attribute__((target("sse4.2")))
+void crc32c_sse42(const guchar *const *p, gsize len, guchar (*out)[32])
+{
+    guint64 c[HASH_LANES], v;
+    gsize i;
+    gint l;
+
+    for (l = 0; l < HASH_LANES; l++)
+        c[l] = 0xffffffff;
+    /* the crc32 instruction takes 3 cycles and can start every cycle */
+    for (i = 0; i + 8 <= len; i += 8) {
+#pragma GCC unroll 4
+        for (l = 0; l < HASH_LANES; l++) {
+            memcpy(&v, p[l] + i, 8);
+            c[l] = _mm_crc32_u64(c[l], v);
+        }
+    }
+    for (; i < len; i++) {
+        for (l = 0; l < HASH_LANES; l++)
+            c[l] = _mm_crc32_u8(c[l], p[l][i]);
+    }
+    for (l = 0; l < HASH_LANES; l++)
+        crc32c_out(c[l], out[l]);
+}
+#elif defined(__aarch64__)
+static __attribute__((target("+crc")))
+void crc32c_arm(const guchar *const *p, gsize len, guchar (*out)[32])
+{
+    guint32 c[HASH_LANES];
+    guint64 v;
+    gsize i;
+    gint l;
+
+    for (l = 0; l < HASH_LANES; l++)
+        c[l] = ~0U;
+    for (i = 0; i + 8 <= len; i += 8) {
+#pragma GCC unroll 4
+        for (l = 0; l < HASH_LANES; l++) {
+            memcpy(&v, p[l] + i, 8);
+            c[l] = __crc32cd(c[l], v);
+        }
+    }
+    for (; i < len; i++) {
+        for (l = 0; l < HASH_LANES; l++)
+            c[l] = __crc32cb(c[l], p[l][i]);
+    }
+    for (l = 0; l < HASH_LANES; l++)
+        crc32c_out(c[l], out[l]);
+}
+#endif
+
+static const HashImpl crc32c_impls[] = {
+    { "portable", "", crc32c_c },
+#if defined(__x86_64__)
+    { "SSE4.2", "sse4_2", crc32c_sse42 },
+#elif defined(__aarch64__)
+    { "ARMv8 CRC", "crc32", crc32c_arm },
+#endif
+};
+
+typedef struct {
+    const gchar *msg;
+    const gchar *digest; /* hex */
+} HashKnown;
+
+static const HashKnown sha256_known[] = {
+    { "abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+    { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+      "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+    { NULL }
+};
+
+static const HashKnown crc32c_known[] = {
+    { "123456789", "e3069283" },
+    { "", "00000000" },
+    { NULL }
+};
+
+/* the known answers, then the same digests of the data as the first */
+static gboolean hash_check(const HashImpl *impl, const HashImpl *first,
+                           const HashKnown *known, gsize digest_len,
+                           const guchar *const *data)
+{
+    const guchar *p[HASH_LANES];
+    guchar out[HASH_LANES][32], expect[HASH_LANES][32];
+    gchar *hex;
+    gboolean ok = TRUE;
+    gint i, l;
+
+    for (i = 0; known[i].msg && ok; i++) {
+        for (l = 0; l < HASH_LANES; l++)
+            p[l] = (const guchar *)known[i].msg;
+        impl->digest(p, strlen(known[i].msg), out);
+        for (l = 0; l < HASH_LANES && ok; l++) {
+            hex = digest_to_str((const char *)out[l], digest_len);
+            ok = g_str_equal(hex, known[i].digest);
+            free(hex);
+        }
+    }
+    if (ok && impl != first) {
+        impl->digest(data, HASH_BUFFER, out);
+        first->digest(data, HASH_BUFFER, expect);
+        for (l = 0; l < HASH_LANES && ok; l++)
+            ok = !memcmp(out[l], expect[l], digest_len);
+    }
+    if (!ok)
+        bench_msg("%s gives wrong digests, not used", impl->name);
+    return ok;
+}
+
+static gpointer hash_for(void *data, gint thread_number)
+{
+    HashData *hd = data;
+    guchar out[HASH_LANES][32];
+
+    hd->impl->digest(hd->p, HASH_BUFFER, out);
+    hash_sink = out[0][0];
+    return NULL;
+}
+
+/* GB/s of each thread */
+static double hash_run(HashData *hd, const HashImpl *impl, gint n_threads,
+                       bench_value *r)
+{
+    hd->impl = impl;
+    *r = benchmark_crunch_for(HASH_SECONDS, n_threads, hash_for, hd);
+    if (r->elapsed_time <= 0)
+        return 0;
+    return r->result * HASH_LANES * HASH_BUFFER / r->elapsed_time / 1e9 / n_threads;
+}
+
+static void benchmark_hash(const HashImpl *impls, gint n_impls,
+                           const HashKnown *known, gsize digest_len, gint entry)
+{
+    bench_value r = EMPTY_BENCH_VALUE, lr;
+    HashData hd;
+    const HashImpl *impl = NULL;
+    guchar *buf;
+    gchar **cpu_flags;
+    guint64 seed = 0x9e3779b97f4a7c15ULL;
+    double one, all, portable = 0;
+    gint i, n_threads;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running hashing benchmark...");
+
+    buf = g_malloc(HASH_LANES * HASH_BUFFER);
+    for (i = 0; i < HASH_LANES * HASH_BUFFER; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        buf[i] = seed >> 56;
+    }
+    for (i = 0; i < HASH_LANES; i++)
+        hd.p[i] = buf + i * HASH_BUFFER;
+
+    cpu_flags = bench_cpu_flags();
+    for (i = 0; i < n_impls; i++) {
+        if (cpu_flags ? !bench_cpu_has(cpu_flags, impls[i].flags) : i > 0)
+            continue;
+        if (hash_check(&impls[i], &impls[0], known, digest_len, hd.p))
+            impl = &impls[i];
+        else if (!i)
+            break;
+    }
+    g_strfreev(cpu_flags);
+
+    if (impl) {
+        n_threads = benchmark_threads(0);
+        one = hash_run(&hd, impl, 1, &lr);
+        all = hash_run(&hd, impl, n_threads, &r);
+        bench_thermal_merge(&r.thermal, &lr.thermal);
+        if (impl != &impls[0] && !params.aborting_benchmarks) {
+            portable = hash_run(&hd, &impls[0], 1, &lr);
+            bench_thermal_merge(&r.thermal, &lr.thermal);
+        }
+
+        if (all > 0) {
+            r.result = all * n_threads;
+            r.revision = BENCH_REVISION;
+            bench_value_append_extra(&r, "%s, %0.2f GB/s on 1 thread, "
+                                     "%0.2f GB/s per thread on %d",
+                                     impl->name, one, all, n_threads);
+            if (portable > 0)
+                bench_value_append_extra(&r, "portable %0.2f GB/s on 1 thread",
+                                         portable);
+            bench_value_append_extra(&r, "%d buffers of %d KiB",
+                                     HASH_LANES, HASH_BUFFER >> 10);
+        } else {
+            r.result = -1;
+        }
+    }
+    g_free(buf);
+
+    bench_results[entry] = r;
+}
+
+void benchmark_sha256(void)
+{
+    benchmark_hash(sha256_impls, G_N_ELEMENTS(sha256_impls), sha256_known, 32,
+                   BENCHMARK_SHA256);
+}
+
+void benchmark_crc32c(void)
+{
+    crc32c_table_init();
+    benchmark_hash(crc32c_impls, G_N_ELEMENTS(crc32c_impls), crc32c_known, 4,
+                   BENCHMARK_CRC32C);
+}
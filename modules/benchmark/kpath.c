@@ -0,0 +1,422 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <linux/futex.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* The cost of a few kernel paths, in nanoseconds:
+ *
+ * - a getpid() system call, through syscall() so the C library can't
+ *   answer from a cache;
+ * - clock_gettime(CLOCK_MONOTONIC), which the vDSO answers in user
+ *   space unless the clock source can't be read from there;
+ * - a context switch: two threads pinned to the same cpu pass a byte
+ *   back and forth over two pipes, two switches per round trip; the
+ *   round trip between two cpus is noted too;
+ * - a futex wake: two threads on two cpus take turns waking each
+ *   other, and each measures from the moment before the other's
+ *   FUTEX_WAKE to its own return from FUTEX_WAIT. Turns where the
+ *   thread wasn't asleep yet aren't counted.
+ *
+ * The first two time KPATH_BATCH calls per crunch callback. The pinned
+ * threads are pool workers with their affinity set for the run, like
+ * the NUMA benchmark does, and get the --bench-pin placement back
+ * afterwards.
+ *
+ * Mitigations for cpu vulnerabilities change all of these, as do
+ * kernel versions: every result notes the kernel release and what
+ * /sys/devices/system/cpu/vulnerabilities says, counted, with a hash
+ * of the whole state to tell two of them apart. */
+
+/* if anything changes in this block, increment revision */
+#define BENCH_REVISION 1
+#define KPATH_SECONDS 2
+#define KPATH_BATCH 1000
+
+typedef struct {
+    gint fd[2][2];      /* the pipe to each worker */
+    gint flag[2];       /* the futex of each worker */
+    guint64 woken[2];   /* when the other worker woke it */
+    gint stop;
+    guint64 deadline;   /* bench_hist_now_ns() */
+    bench_hist hist[2]; /* of each worker */
+    guint64 ns[2];
+    gint error;
+} KpathData;
+
+static gint kpath_cmp(gconstpointer a, gconstpointer b)
+{
+    return strcmp(*(const gchar **)a, *(const gchar **)b);
+}
+
+/* "kernel 6.1.0, vulnerabilities: 3 mitigated, 1 vulnerable (x), state 1a2b3c4d" */
+static void kpath_note(bench_value *r)
+{
+    const gchar *dir = "/sys/devices/system/cpu/vulnerabilities";
+    struct utsname u;
+    GDir *d;
+    GPtrArray *names;
+    GString *state, *vulnerable;
+    const gchar *name;
+    gchar *path, *status;
+    gint mitigated = 0, n_vulnerable = 0;
+    guint i;
+
+    if (uname(&u) == 0)
+        bench_value_append_extra(r, "kernel %s", u.release);
+
+    if (!(d = g_dir_open(dir, 0, NULL))) {
+        bench_value_append_extra(r, "vulnerabilities unknown");
+        return;
+    }
+    names = g_ptr_array_new_with_free_func(g_free);
+    while ((name = g_dir_read_name(d)))
+        g_ptr_array_add(names, g_strdup(name));
+    g_dir_close(d);
+    g_ptr_array_sort(names, kpath_cmp);
+
+    state = g_string_new(NULL);
+    vulnerable = g_string_new(NULL);
+    for (i = 0; i < names->len; i++) {
+        name = g_ptr_array_index(names, i);
+        path = g_build_filename(dir, name, NULL);
+        if (g_file_get_contents(path, &status, NULL, NULL)) {
+            g_strstrip(status);
+            g_string_append_printf(state, "%s: %s\n", name, status);
+            if (g_str_has_prefix(status, "Mitigation")) {
+                mitigated++;
+            } else if (g_str_has_prefix(status, "Vulnerable")) {
+                g_string_append_printf(vulnerable, "%s%s", n_vulnerable ? " " : "", name);
+                n_vulnerable++;
+            }
+            g_free(status);
+        }
+        g_free(path);
+    }
+    DEBUG("%s", state->str);
+
+    bench_value_append_extra(r, "vulnerabilities: %d mitigated, %d vulnerable%s%s%s, "
+                             "state %08x", mitigated, n_vulnerable,
+                             n_vulnerable ? " (" : "", vulnerable->str,
+                             n_vulnerable ? ")" : "", g_str_hash(state->str));
+    g_string_free(state, TRUE);
+    g_string_free(vulnerable, TRUE);
+    g_ptr_array_free(names, TRUE);
+}
+
+static void kpath_latency_scale(bench_latency *l, double div)
+{
+    l->p50 /= div;
+    l->p90 /= div;
+    l->p99 /= div;
+    l->p999 /= div;
+    l->max /= div;
+}
+
+/* the first two cpus this thread may run on; returns how many */
+static gint kpath_cpus(gint cpus[2])
+{
+    cpu_set_t set;
+    gint cpu, n = 0;
+
+    cpus[0] = cpus[1] = 0;
+    if (sched_getaffinity(0, sizeof(set), &set) < 0)
+        return 1;
+    for (cpu = 0; cpu < CPU_SETSIZE && n < 2; cpu++)
+        if (CPU_ISSET(cpu, &set))
+            cpus[n++] = cpu;
+    return MAX(n, 1);
+}
+
+/* runs func on two workers pinned to cpu a and cpu b */
+static void kpath_pair(KpathData *kd, BenchPoolFunc func, gint a, gint b,
+                       bench_counters *counters)
+{
+    const bench_placement *pl = bench_placement_get();
+    gpointer tasks[2] = { kd, kd };
+    gint cpus[2] = { a, b };
+
+    bench_pool_set_affinity(cpus, 2);
+    kd->deadline = bench_hist_now_ns() + KPATH_SECONDS * (guint64)1000000000;
+    bench_pool_run(2, func, tasks);
+    if (counters)
+        bench_pool_counters(counters);
+    bench_pool_set_affinity(pl->cpus, pl->n_cpus);
+}
+
+static gpointer kpath_getpid(void *data, gint thread_number)
+{
+    gint i;
+
+    for (i = 0; i < KPATH_BATCH; i++)
+        syscall(SYS_getpid);
+    return NULL;
+}
+
+static gpointer kpath_clock(void *data, gint thread_number)
+{
+    struct timespec ts;
+    gint i;
+
+    for (i = 0; i < KPATH_BATCH; i++)
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+    return NULL;
+}
+
+/* ns per call, so the stats of repeated runs are in ns too */
+static double kpath_ns(double count, double seconds, gpointer data)
+{
+    if (count <= 0 || seconds <= 0)
+        return -1;
+    return seconds * 1e9 / (count * KPATH_BATCH);
+}
+
+static void kpath_batch(gpointer func, gint entry)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    gchar *p50, *p99;
+
+    r = benchmark_crunch_for_convert(KPATH_SECONDS, 1, func, NULL, kpath_ns, NULL);
+    if (r.result <= 0) {
+        r.result = -1;
+        bench_results[entry] = r;
+        return;
+    }
+
+    r.revision = BENCH_REVISION;
+    kpath_latency_scale(&r.latency, KPATH_BATCH);
+    p50 = bench_latency_format(r.latency.p50);
+    p99 = bench_latency_format(r.latency.p99);
+    bench_value_append_extra(&r, "p50 %s p99 %s (means of %d calls)", p50, p99,
+                             KPATH_BATCH);
+    g_free(p50);
+    g_free(p99);
+    kpath_note(&r);
+
+    bench_results[entry] = r;
+}
+
+/* worker 0 writes a byte to worker 1 and times the reply */
+static void kpath_pipe_worker(gpointer task, gint worker)
+{
+    KpathData *kd = task;
+    gchar c = 0;
+    guint64 t0, t1;
+
+    if (worker) {
+        while (read(kd->fd[1][0], &c, 1) == 1) {
+            if (write(kd->fd[0][1], &c, 1) != 1)
+                break;
+        }
+        return;
+    }
+
+    while ((t0 = bench_hist_now_ns()) < kd->deadline) {
+        errno = EPIPE;
+        if (write(kd->fd[1][1], &c, 1) != 1 || read(kd->fd[0][0], &c, 1) != 1) {
+            kd->error = errno;
+            break;
+        }
+        t1 = bench_hist_now_ns();
+        bench_hist_add(&kd->hist[0], t1 - t0);
+        kd->ns[0] += t1 - t0;
+    }
+    close(kd->fd[1][1]);
+    kd->fd[1][1] = -1;
+}
+
+/* mean round trip in ns, and its percentiles in l */
+static double kpath_pipe(gint a, gint b, bench_latency *l, bench_counters *counters)
+{
+    KpathData *kd = g_new0(KpathData, 1);
+    double ns = -1;
+    gint i;
+
+    if (pipe(kd->fd[0]) < 0) {
+        bench_msg("pipe: %s", g_strerror(errno));
+        g_free(kd);
+        return -1;
+    }
+    if (pipe(kd->fd[1]) < 0) {
+        bench_msg("pipe: %s", g_strerror(errno));
+        close(kd->fd[0][0]);
+        close(kd->fd[0][1]);
+        g_free(kd);
+        return -1;
+    }
+    kpath_pair(kd, kpath_pipe_worker, a, b, counters);
+    for (i = 0; i < 4; i++)
+        if (kd->fd[i / 2][i % 2] >= 0)
+            close(kd->fd[i / 2][i % 2]);
+
+    if (kd->error)
+        bench_msg("pipe ping-pong failed: %s", g_strerror(kd->error));
+    else if (kd->hist[0].n) {
+        ns = (double)kd->ns[0] / kd->hist[0].n;
+        if (l)
+            bench_latency_from_hist(l, &kd->hist[0]);
+    }
+    g_free(kd);
+    return ns;
+}
+
+static long kpath_futex(gint *addr, gint op, gint val)
+{
+    return syscall(SYS_futex, addr, op, val, NULL, NULL, 0);
+}
+
+/* the workers take turns waking each other, worker 0 first */
+static void kpath_futex_worker(gpointer task, gint worker)
+{
+    KpathData *kd = task;
+    gint other = !worker;
+    gboolean turn = !worker, slept;
+    guint64 now;
+
+    for (;;) {
+        if (!turn) {
+            slept = FALSE;
+            while (!g_atomic_int_get(&kd->flag[worker])) {
+                if (kpath_futex(&kd->flag[worker], FUTEX_WAIT_PRIVATE, 0) == 0)
+                    slept = TRUE;
+            }
+            now = bench_hist_now_ns();
+            if (g_atomic_int_get(&kd->stop))
+                break;
+            if (slept) {
+                bench_hist_add(&kd->hist[worker], now - kd->woken[worker]);
+                kd->ns[worker] += now - kd->woken[worker];
+            }
+            g_atomic_int_set(&kd->flag[worker], 0);
+        }
+        turn = FALSE;
+
+        if (bench_hist_now_ns() >= kd->deadline)
+            g_atomic_int_set(&kd->stop, 1);
+        kd->woken[other] = bench_hist_now_ns();
+        g_atomic_int_set(&kd->flag[other], 1);
+        kpath_futex(&kd->flag[other], FUTEX_WAKE_PRIVATE, 1);
+        if (g_atomic_int_get(&kd->stop))
+            break;
+    }
+}
+
+void benchmark_kpath_syscall(void)
+{
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Timing system calls...");
+
+    kpath_batch(kpath_getpid, BENCHMARK_KPATH_SYSCALL);
+}
+
+void benchmark_kpath_clock(void)
+{
+    bench_value *r = &bench_results[BENCHMARK_KPATH_CLOCK];
+    gchar *source;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Timing clock_gettime()...");
+
+    kpath_batch(kpath_clock, BENCHMARK_KPATH_CLOCK);
+    if (r->result > 0 &&
+        g_file_get_contents("/sys/devices/system/clocksource/clocksource0/current_clocksource",
+                            &source, NULL, NULL)) {
+        bench_value_append_extra(r, "clocksource %s", g_strstrip(source));
+        g_free(source);
+    }
+}
+
+void benchmark_kpath_switch(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    gint cpus[2], n_cpus;
+    gchar *p50, *p99, *mean;
+    double same, cross = -1;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Timing context switches...");
+
+    n_cpus = kpath_cpus(cpus);
+    same = kpath_pipe(cpus[0], cpus[0], &r.latency, &r.counters);
+    if (n_cpus > 1 && !params.aborting_benchmarks)
+        cross = kpath_pipe(cpus[0], cpus[1], NULL, NULL);
+
+    if (same > 0) {
+        /* a round trip on one cpu is two switches */
+        r.result = same / 2;
+        r.elapsed_time = KPATH_SECONDS;
+        r.threads_used = 2;
+        r.revision = BENCH_REVISION;
+        kpath_latency_scale(&r.latency, 2);
+        p50 = bench_latency_format(r.latency.p50);
+        p99 = bench_latency_format(r.latency.p99);
+        bench_value_append_extra(&r, "cpu %d, p50 %s p99 %s", cpus[0], p50, p99);
+        g_free(p50);
+        g_free(p99);
+        if (cross > 0) {
+            mean = bench_latency_format((guint64)cross);
+            bench_value_append_extra(&r, "cpus %d/%d round trip %s", cpus[0],
+                                     cpus[1], mean);
+            g_free(mean);
+        }
+        kpath_note(&r);
+    }
+
+    bench_results[BENCHMARK_KPATH_SWITCH] = r;
+}
+
+void benchmark_kpath_futex(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    KpathData *kd = g_new0(KpathData, 1);
+    gint cpus[2], n_cpus;
+    gchar *p50, *p99;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Timing futex wake-ups...");
+
+    n_cpus = kpath_cpus(cpus);
+    kpath_pair(kd, kpath_futex_worker, cpus[0], cpus[n_cpus - 1], &r.counters);
+    bench_hist_merge(&kd->hist[0], &kd->hist[1]);
+
+    if (kd->hist[0].n) {
+        r.result = (double)(kd->ns[0] + kd->ns[1]) / kd->hist[0].n;
+        r.elapsed_time = KPATH_SECONDS;
+        r.threads_used = 2;
+        r.revision = BENCH_REVISION;
+        bench_latency_from_hist(&r.latency, &kd->hist[0]);
+        p50 = bench_latency_format(r.latency.p50);
+        p99 = bench_latency_format(r.latency.p99);
+        bench_value_append_extra(&r, "cpus %d/%d, p50 %s p99 %s", cpus[0],
+                                 cpus[n_cpus - 1], p50, p99);
+        g_free(p50);
+        g_free(p99);
+        kpath_note(&r);
+    }
+    g_free(kd);
+
+    bench_results[BENCHMARK_KPATH_FUTEX] = r;
+}
@@ -0,0 +1,495 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <linux/errqueue.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* Network stack cost over loopback, without an external server.
+ *
+ * Every stream is a connected pair of sockets, TCP on 127.0.0.1 or a
+ * Unix socketpair, with a pool worker sending and another receiving.
+ * Senders write LOOPBACK_CHUNK bytes at a time for LOOPBACK_SECONDS;
+ * receivers count what arrives after the first LOOPBACK_OMIT seconds,
+ * like iperf3 --omit. The result is the total of the streams, Gbit/s.
+ *
+ * The zero-copy variants send over TCP with MSG_ZEROCOPY, reaping the
+ * completions from the error queue, or with sendfile() from a memfd.
+ * Over loopback the kernel still copies MSG_ZEROCOPY data and says so
+ * in the completions; that is noted, as it is what there is to compare.
+ *
+ * The latency benchmark bounces LOOPBACK_MSG bytes back and forth over
+ * one TCP_NODELAY stream, then one Unix stream; the result is the mean
+ * TCP round trip in microseconds. */
+
+/* if anything changes in this block, increment revision */
+#define BENCH_REVISION 1
+#define LOOPBACK_CHUNK (128 << 10)
+#define LOOPBACK_MSG 64
+#define LOOPBACK_OMIT 1
+#define LOOPBACK_SECONDS 5
+
+typedef enum {
+    LOOPBACK_TCP,
+    LOOPBACK_UNIX,
+    LOOPBACK_ZEROCOPY,
+    LOOPBACK_SENDFILE,
+} LoopbackMode;
+
+typedef struct {
+    gint fd[2]; /* sender or client, receiver or server */
+    guint64 bytes; /* received after the omit time */
+    guint64 ns;    /* from the omit time to the last data */
+    bench_hist hist; /* round trips */
+    gboolean copied; /* MSG_ZEROCOPY fell back to copying */
+    gint error;
+} LoopbackStream;
+
+typedef struct {
+    LoopbackMode mode;
+    LoopbackStream *s;
+    gint memfd;
+    guint64 omit, deadline; /* bench_hist_now_ns() */
+} LoopbackData;
+
+typedef struct {
+    LoopbackData *ld;
+    gint stream;
+} LoopbackTask;
+
+/* a connected TCP pair on 127.0.0.1, port chosen by the kernel */
+static gboolean loopback_tcp_pair(gint listener, gint fd[2])
+{
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    gint one = 1;
+
+    fd[0] = fd[1] = -1;
+    if (getsockname(listener, (struct sockaddr *)&addr, &len) < 0)
+        return FALSE;
+    if ((fd[0] = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+        return FALSE;
+    if (connect(fd[0], (struct sockaddr *)&addr, len) < 0 ||
+        (fd[1] = accept(listener, NULL, NULL)) < 0) {
+        close(fd[0]);
+        fd[0] = -1;
+        return FALSE;
+    }
+    setsockopt(fd[0], IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setsockopt(fd[1], IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return TRUE;
+}
+
+static gint loopback_listener(void)
+{
+    struct sockaddr_in addr;
+    gint fd;
+
+    if ((fd = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+        return -1;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(fd, 1) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* connects every stream; FALSE with a message if any of them fails */
+static gboolean loopback_connect(LoopbackData *ld, gint streams)
+{
+    gint i, listener = -1, one = 1;
+    gboolean ok = TRUE;
+
+    if (ld->mode != LOOPBACK_UNIX && (listener = loopback_listener()) < 0) {
+        bench_msg("unable to listen on 127.0.0.1: %s", g_strerror(errno));
+        return FALSE;
+    }
+
+    for (i = 0; i < streams && ok; i++) {
+        if (ld->mode == LOOPBACK_UNIX)
+            ok = socketpair(AF_UNIX, SOCK_STREAM, 0, ld->s[i].fd) == 0;
+        else
+            ok = loopback_tcp_pair(listener, ld->s[i].fd);
+        if (!ok) {
+            ld->s[i].fd[0] = ld->s[i].fd[1] = -1;
+            bench_msg("unable to connect over loopback: %s", g_strerror(errno));
+        }
+    }
+    if (listener >= 0)
+        close(listener);
+
+#ifdef SO_ZEROCOPY
+    for (i = 0; ok && ld->mode == LOOPBACK_ZEROCOPY && i < streams; i++) {
+        if (setsockopt(ld->s[i].fd[0], SOL_SOCKET, SO_ZEROCOPY,
+                       &one, sizeof(one)) < 0) {
+            bench_msg("MSG_ZEROCOPY is not available: %s", g_strerror(errno));
+            ok = FALSE;
+        }
+    }
+#else
+    if (ld->mode == LOOPBACK_ZEROCOPY) {
+        bench_msg("MSG_ZEROCOPY is not supported by this build");
+        ok = FALSE;
+    }
+#endif
+
+    return ok;
+}
+
+static void loopback_close(LoopbackData *ld, gint streams)
+{
+    gint i;
+
+    for (i = 0; i < streams; i++) {
+        if (ld->s[i].fd[0] >= 0)
+            close(ld->s[i].fd[0]);
+        if (ld->s[i].fd[1] >= 0)
+            close(ld->s[i].fd[1]);
+    }
+}
+
+#ifdef SO_ZEROCOPY
+/* takes the finished MSG_ZEROCOPY sends off the error queue */
+static void loopback_reap(LoopbackStream *s)
+{
+    gchar control[128];
+    struct msghdr msg;
+    struct cmsghdr *cm;
+    struct sock_extended_err *ee;
+
+    for (;;) {
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(s->fd[0], &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+            return;
+        for (cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+            ee = (struct sock_extended_err *)CMSG_DATA(cm);
+            if (ee->ee_origin == SO_EE_ORIGIN_ZEROCOPY &&
+                (ee->ee_code & SO_EE_CODE_ZEROCOPY_COPIED))
+                s->copied = TRUE;
+        }
+    }
+}
+#endif
+
+static void loopback_send(LoopbackData *ld, LoopbackStream *s)
+{
+    gchar *buf = g_malloc(LOOPBACK_CHUNK);
+    off_t off;
+    ssize_t n;
+
+    memset(buf, 0xa5, LOOPBACK_CHUNK);
+    while (bench_hist_now_ns() < ld->deadline) {
+        switch (ld->mode) {
+#ifdef SO_ZEROCOPY
+        case LOOPBACK_ZEROCOPY:
+            n = send(s->fd[0], buf, LOOPBACK_CHUNK, MSG_ZEROCOPY | MSG_NOSIGNAL);
+            if (n < 0 && errno == ENOBUFS) {
+                /* too many sends not reaped yet */
+                loopback_reap(s);
+                continue;
+            }
+            loopback_reap(s);
+            break;
+#endif
+        case LOOPBACK_SENDFILE:
+            off = 0;
+            n = sendfile(s->fd[0], ld->memfd, &off, LOOPBACK_CHUNK);
+            break;
+        default:
+            n = send(s->fd[0], buf, LOOPBACK_CHUNK, MSG_NOSIGNAL);
+        }
+        if (n < 0 && errno != EINTR) {
+            s->error = errno;
+            break;
+        }
+    }
+    shutdown(s->fd[0], SHUT_WR);
+    g_free(buf);
+}
+
+static void loopback_receive(LoopbackData *ld, LoopbackStream *s)
+{
+    gchar *buf = g_malloc(LOOPBACK_CHUNK);
+    guint64 now, last = 0;
+    ssize_t n;
+
+    for (;;) {
+        n = recv(s->fd[1], buf, LOOPBACK_CHUNK, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        now = bench_hist_now_ns();
+        if (now >= ld->omit) {
+            s->bytes += n;
+            last = now;
+        }
+    }
+    if (n < 0)
+        s->error = errno;
+    if (last > ld->omit)
+        s->ns = last - ld->omit;
+    g_free(buf);
+}
+
+/* worker 2N sends on stream N, worker 2N + 1 receives */
+static void loopback_stream_worker(gpointer task, gint worker)
+{
+    LoopbackData *ld = ((LoopbackTask *)task)->ld;
+    LoopbackStream *s = &ld->s[((LoopbackTask *)task)->stream];
+
+    if (worker % 2)
+        loopback_receive(ld, s);
+    else
+        loopback_send(ld, s);
+}
+
+/* reads exactly n bytes; FALSE at the end of the stream */
+static gboolean loopback_read_all(gint fd, gchar *buf, gsize n)
+{
+    ssize_t got;
+
+    while (n) {
+        got = recv(fd, buf, n, 0);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            return FALSE;
+        buf += got;
+        n -= got;
+    }
+    return TRUE;
+}
+
+/* worker 0 sends a message and times the echo from worker 1 */
+static void loopback_echo_worker(gpointer task, gint worker)
+{
+    LoopbackData *ld = ((LoopbackTask *)task)->ld;
+    LoopbackStream *s = &ld->s[0];
+    gchar buf[LOOPBACK_MSG];
+    guint64 t0, t1;
+
+    memset(buf, 0xa5, sizeof(buf));
+    if (worker) {
+        while (loopback_read_all(s->fd[1], buf, sizeof(buf))) {
+            if (send(s->fd[1], buf, sizeof(buf), MSG_NOSIGNAL) != sizeof(buf))
+                break;
+        }
+        return;
+    }
+
+    while ((t0 = bench_hist_now_ns()) < ld->deadline) {
+        errno = EPIPE;
+        if (send(s->fd[0], buf, sizeof(buf), MSG_NOSIGNAL) != sizeof(buf) ||
+            !loopback_read_all(s->fd[0], buf, sizeof(buf))) {
+            s->error = errno;
+            break;
+        }
+        if (t0 >= ld->omit) {
+            t1 = bench_hist_now_ns();
+            bench_hist_add(&s->hist, t1 - t0);
+            s->ns += t1 - t0;
+        }
+    }
+    shutdown(s->fd[0], SHUT_WR);
+}
+
+/* runs func on 2 workers per stream; FALSE with a message on an error */
+static gboolean loopback_run(LoopbackData *ld, gint streams,
+                             BenchPoolFunc func, bench_counters *counters)
+{
+    LoopbackTask *t = g_new0(LoopbackTask, 2 * streams);
+    gpointer *tasks = g_new0(gpointer, 2 * streams);
+    gint i, error = 0;
+
+    ld->s = g_new0(LoopbackStream, streams);
+    /* the streams after a failed one are never opened */
+    for (i = 0; i < streams; i++)
+        ld->s[i].fd[0] = ld->s[i].fd[1] = -1;
+    if (!loopback_connect(ld, streams)) {
+        loopback_close(ld, streams);
+        g_free(t);
+        g_free(tasks);
+        return FALSE;
+    }
+
+    for (i = 0; i < 2 * streams; i++) {
+        t[i].ld = ld;
+        t[i].stream = i / 2;
+        tasks[i] = &t[i];
+    }
+    ld->omit = bench_hist_now_ns() + LOOPBACK_OMIT * (guint64)1000000000;
+    ld->deadline = ld->omit + LOOPBACK_SECONDS * (guint64)1000000000;
+    bench_pool_run(2 * streams, func, tasks);
+    bench_pool_counters(counters);
+
+    loopback_close(ld, streams);
+    for (i = 0; i < streams && !error; i++)
+        error = ld->s[i].error;
+    if (error)
+        bench_msg("loopback stream failed: %s", g_strerror(error));
+
+    g_free(t);
+    g_free(tasks);
+    return !error;
+}
+
+/* the memfd sendfile() sends from */
+static gint loopback_memfd(void)
+{
+    gchar *buf;
+    gint fd;
+
+    if ((fd = memfd_create("hardinfo2-loopback", 0)) < 0) {
+        bench_msg("memfd_create: %s", g_strerror(errno));
+        return -1;
+    }
+    buf = g_malloc(LOOPBACK_CHUNK);
+    memset(buf, 0xa5, LOOPBACK_CHUNK);
+    if (write(fd, buf, LOOPBACK_CHUNK) != LOOPBACK_CHUNK) {
+        bench_msg("memfd write: %s", g_strerror(errno));
+        close(fd);
+        fd = -1;
+    }
+    g_free(buf);
+    return fd;
+}
+
+/* n_threads as for benchmark_threads(), two per stream */
+static void benchmark_loopback_stream(LoopbackMode mode, gint n_threads, gint entry)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    LoopbackData ld;
+    gint streams, i;
+    double gbits = 0;
+    gboolean copied = FALSE;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running loopback network benchmark...");
+
+    streams = MAX(benchmark_threads(n_threads) / 2, 1);
+    memset(&ld, 0, sizeof(ld));
+    ld.mode = mode;
+    ld.memfd = -1;
+    if (mode == LOOPBACK_SENDFILE && (ld.memfd = loopback_memfd()) < 0) {
+        bench_results[entry] = r;
+        return;
+    }
+
+    if (loopback_run(&ld, streams, loopback_stream_worker, &r.counters)) {
+        for (i = 0; i < streams; i++) {
+            if (ld.s[i].ns)
+                gbits += ld.s[i].bytes * 8.0 / ld.s[i].ns;
+            copied = copied || ld.s[i].copied;
+        }
+        r.result = gbits;
+        r.elapsed_time = LOOPBACK_SECONDS;
+        r.threads_used = 2 * streams;
+        r.revision = BENCH_REVISION;
+        bench_value_append_extra(&r, "%d stream%s, %0.2f Gbit/s each",
+                                 streams, streams > 1 ? "s" : "",
+                                 gbits / streams);
+        if (copied)
+            bench_value_append_extra(&r, "copied by the kernel");
+    }
+
+    if (ld.memfd >= 0)
+        close(ld.memfd);
+    g_free(ld.s);
+
+    bench_results[entry] = r;
+}
+
+/* mean round trip in ns, and the percentiles in l */
+static double loopback_round_trip(LoopbackMode mode, bench_latency *l,
+                                  bench_counters *counters)
+{
+    LoopbackData ld;
+    double ns = -1;
+
+    memset(&ld, 0, sizeof(ld));
+    ld.mode = mode;
+    if (loopback_run(&ld, 1, loopback_echo_worker, counters) &&
+        ld.s[0].hist.n) {
+        ns = (double)ld.s[0].ns / ld.s[0].hist.n;
+        bench_latency_from_hist(l, &ld.s[0].hist);
+    }
+    g_free(ld.s);
+    return ns;
+}
+
+void benchmark_loopback_latency(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    bench_latency unix_l;
+    bench_counters unix_c;
+    gchar *mean, *p50, *p99;
+    double tcp, uds;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running loopback latency benchmark...");
+
+    tcp = loopback_round_trip(LOOPBACK_TCP, &r.latency, &r.counters);
+    uds = loopback_round_trip(LOOPBACK_UNIX, &unix_l, &unix_c);
+    if (tcp > 0) {
+        r.result = tcp / 1e3;
+        r.elapsed_time = LOOPBACK_SECONDS;
+        r.threads_used = 2;
+        r.revision = BENCH_REVISION;
+
+        p50 = bench_latency_format(r.latency.p50);
+        p99 = bench_latency_format(r.latency.p99);
+        bench_value_append_extra(&r, "TCP p50 %s p99 %s", p50, p99);
+        g_free(p50);
+        g_free(p99);
+        if (uds > 0) {
+            mean = bench_latency_format((guint64)uds);
+            p50 = bench_latency_format(unix_l.p50);
+            p99 = bench_latency_format(unix_l.p99);
+            bench_value_append_extra(&r, "Unix %s, p50 %s p99 %s", mean, p50, p99);
+            g_free(mean);
+            g_free(p50);
+            g_free(p99);
+        }
+        bench_value_append_extra(&r, "%d byte messages", LOOPBACK_MSG);
+    }
+
+    bench_results[BENCHMARK_LOOPBACK_LATENCY] = r;
+}
+
+void benchmark_loopback_tcp_single(void) { benchmark_loopback_stream(LOOPBACK_TCP, 2, BENCHMARK_LOOPBACK_TCP_SINGLE); }
+void benchmark_loopback_tcp_all(void) { benchmark_loopback_stream(LOOPBACK_TCP, 0, BENCHMARK_LOOPBACK_TCP_ALL); }
+void benchmark_loopback_unix_single(void) { benchmark_loopback_stream(LOOPBACK_UNIX, 2, BENCHMARK_LOOPBACK_UNIX_SINGLE); }
+void benchmark_loopback_unix_all(void) { benchmark_loopback_stream(LOOPBACK_UNIX, 0, BENCHMARK_LOOPBACK_UNIX_ALL); }
+void benchmark_loopback_zerocopy(void) { benchmark_loopback_stream(LOOPBACK_ZEROCOPY, 2, BENCHMARK_LOOPBACK_ZEROCOPY); }
+void benchmark_loopback_sendfile(void) { benchmark_loopback_stream(LOOPBACK_SENDFILE, 2, BENCHMARK_LOOPBACK_SENDFILE); }
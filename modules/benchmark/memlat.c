@@ -0,0 +1,334 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#define _GNU_SOURCE
+#include <sched.h>
+#include <math.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+#include "cpu_util.h"
+
+/* Memory latency: a chain of pointers, one per cache line, in random
+ * order, walked with dependent loads. Every load has to wait for the one
+ * before it and the hardware prefetchers can't guess the next line, so
+ * the time per load is the latency of wherever the working set fits.
+ *
+ * The working set grows from 4 KiB in steps of 1.5x and 1.33x up to
+ * MEMLAT_MAX_BYTES or a quarter of the memory; the ns per load of every
+ * size goes in the curve, where L1, L2, L3 and DRAM show as plateaus.
+ * The buffer asks for transparent huge pages, so the TLB adds as few
+ * steps of its own as it can.
+ *
+ * Where the latency climbs to a new plateau is taken as the end of a
+ * cache level and checked against the data and unified caches sysfs
+ * lists for the cpu the walk ran on. The result is the latency at the
+ * largest size. */
+
+/* if anything changes in this block, increment revision */
+#define BENCH_REVISION 1
+#define MEMLAT_MIN_BYTES (4 << 10)
+#define MEMLAT_MAX_BYTES ((guint64)4 << 30)
+#define MEMLAT_MIN_NS 20000000 /* per measurement */
+#define MEMLAT_RUNS 3          /* measurements per size, the fastest counts */
+#define MEMLAT_RISE 1.5        /* over the plateau: a new level begins */
+#define MEMLAT_RISE_NS 1.0
+#define MEMLAT_FLAT 1.10       /* between two sizes: the plateau is reached */
+
+typedef struct {
+    gchar *buf;
+    gsize max_bytes;
+    guint32 *order;
+    bench_curve curve;
+    gint cpu; /* where the walk ran */
+} MemLatData;
+
+static gpointer volatile memlat_sink;
+
+static guint64 xorshift64(guint64 *s)
+{
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+/* links the first bytes of buf into one random cycle of its lines;
+ * order has room for one guint32 per line */
+void **bench_chase_chain(gchar *buf, gsize bytes, guint32 *order, guint64 *seed)
+{
+    guint32 i, j, t, lines = bytes / BENCH_CHASE_LINE;
+
+    for (i = 0; i < lines; i++)
+        order[i] = i;
+    for (i = lines - 1; i > 0; i--) {
+        j = xorshift64(seed) % (i + 1);
+        t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+    for (i = 0; i < lines; i++) {
+        *(void **)(buf + (gsize)order[i] * BENCH_CHASE_LINE) =
+            buf + (gsize)order[(i + 1) % lines] * BENCH_CHASE_LINE;
+    }
+
+    return (void **)(buf + (gsize)order[0] * BENCH_CHASE_LINE);
+}
+
+#define CHASE4 p = *p; p = *p; p = *p; p = *p;
+
+static void **memlat_walk(void **p, guint64 loads)
+{
+    guint64 i;
+
+    for (i = 0; i < loads; i += 16) {
+        CHASE4 CHASE4 CHASE4 CHASE4
+    }
+    return p;
+}
+
+/* ns per load; loads grows until one walk takes MEMLAT_MIN_NS */
+double bench_chase_ns(void **p, gsize lines)
+{
+    guint64 loads = 1 << 16, t0, ns, best = 0;
+    gint run;
+
+    /* once around the chain, to bring it into the caches it fits in */
+    p = memlat_walk(p, MIN(lines, 1 << 21));
+
+    for (;;) {
+        t0 = bench_hist_now_ns();
+        p = memlat_walk(p, loads);
+        ns = bench_hist_now_ns() - t0;
+        if (ns >= MEMLAT_MIN_NS)
+            break;
+        loads *= 2;
+    }
+    best = ns;
+    for (run = 1; run < MEMLAT_RUNS; run++) {
+        t0 = bench_hist_now_ns();
+        p = memlat_walk(p, loads);
+        ns = bench_hist_now_ns() - t0;
+        best = MIN(best, ns);
+    }
+    memlat_sink = p;
+
+    return (double)best / loads;
+}
+
+/* one call, from the worker */
+static gpointer memlat_sweep(unsigned int start, unsigned int end, void *data,
+                             gint thread_number)
+{
+    MemLatData *md = data;
+    guint64 seed = 0x9e3779b97f4a7c15ULL;
+    gsize bytes = MEMLAT_MIN_BYTES, next;
+    void **p;
+
+    md->cpu = sched_getcpu();
+    while (bytes <= md->max_bytes && md->curve.n < BENCH_CURVE_MAX) {
+        p = bench_chase_chain(md->buf, bytes, md->order, &seed);
+        md->curve.point[md->curve.n].bytes = bytes;
+        md->curve.point[md->curve.n].result =
+            bench_chase_ns(p, bytes / BENCH_CHASE_LINE);
+        md->curve.n++;
+
+        if (params.aborting_benchmarks)
+            break;
+
+        /* 4K, 6K, 8K, 12K, 16K ... */
+        next = (bytes & (bytes - 1)) ? bytes / 3 * 4 : bytes / 2 * 3;
+        bytes = next;
+    }
+
+    return NULL;
+}
+
+/* the largest power of two in at most a quarter of the memory, and in
+ * the address space; in guint64 as 4 GiB does not fit a 32-bit gsize */
+static gsize memlat_max_bytes(void)
+{
+    guint64 ram = (guint64)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+    guint64 max = MEMLAT_MAX_BYTES;
+
+    while (max > MEMLAT_MIN_BYTES &&
+           ((ram && max > ram / 4) || max > G_MAXSIZE))
+        max /= 2;
+    return (gsize)max;
+}
+
+/* the last size of a climb from lo to hi at most half way up, on a
+ * log scale: where the level below stops holding the working set */
+static gsize memlat_boundary(const bench_curve *c, gint from, gint to)
+{
+    double mid = sqrt(c->point[from].result * c->point[to].result);
+    gint i;
+
+    for (i = to; i > from && c->point[i].result > mid; i--)
+        ;
+    return c->point[i].bytes;
+}
+
+/* a climb starts when the latency rises MEMLAT_RISE and MEMLAT_RISE_NS
+ * over the plateau, and ends at the first size that adds less than
+ * MEMLAT_FLAT */
+static gint memlat_steps(const bench_curve *c, gsize *steps, gint max_steps)
+{
+    gint i, low = 0, from = -1, n = 0;
+
+    for (i = 1; i < c->n; i++) {
+        if (from >= 0) {
+            if (c->point[i].result < c->point[i - 1].result * MEMLAT_FLAT) {
+                if (n < max_steps)
+                    steps[n++] = memlat_boundary(c, from, i - 1);
+                from = -1;
+                low = i;
+            }
+        } else if (c->point[i].result > c->point[low].result * MEMLAT_RISE &&
+                   c->point[i].result > c->point[low].result + MEMLAT_RISE_NS) {
+            from = low;
+        } else if (c->point[i].result < c->point[low].result) {
+            low = i;
+        }
+    }
+    if (from >= 0 && n < max_steps)
+        steps[n++] = memlat_boundary(c, from, c->n - 1);
+
+    return n;
+}
+
+/* latency of the largest size at most half of bytes */
+static double memlat_at(const bench_curve *c, gsize bytes)
+{
+    double ret = -1;
+    gint i;
+
+    for (i = 0; i < c->n && c->point[i].bytes <= bytes / 2; i++)
+        ret = c->point[i].result;
+    return ret;
+}
+
+static gchar *memlat_size_str(gsize bytes)
+{
+    if (bytes >= (1 << 20) && !(bytes % (1 << 20)))
+        return g_strdup_printf("%" G_GSIZE_FORMAT " MiB", bytes >> 20);
+    return g_strdup_printf("%" G_GSIZE_FORMAT " KiB", bytes >> 10);
+}
+
+/* Every data or unified level of the walking cpu needs a climb between
+ * half and twice its size; climbs past the last level, from the TLB or
+ * the memory pages, are expected. */
+static void memlat_check_caches(bench_value *r, gint cpu)
+{
+    GSList *caches, *l;
+    cpu_cache_data *c;
+    gsize steps[BENCH_CURVE_MAX], size;
+    gboolean used[BENCH_CURVE_MAX] = { FALSE };
+    gint n_steps, i, level, best, mismatches = 0;
+    GString *str;
+    gchar *sz;
+
+    n_steps = memlat_steps(r->curve, steps, BENCH_CURVE_MAX);
+    caches = cpucache_list_new(MAX(cpu, 0));
+
+    for (level = 1; level <= 4; level++) {
+        size = 0;
+        for (l = caches; l; l = l->next) {
+            c = l->data;
+            if (c->level == level && g_strcmp0(c->type, "Instruction"))
+                size = MAX(size, (gsize)c->size << 10);
+        }
+        if (!size)
+            continue;
+
+        best = -1;
+        for (i = 0; i < n_steps; i++) {
+            if (used[i] || steps[i] < size / 2 || steps[i] > size * 2)
+                continue;
+            if (best < 0 || ABS((gssize)steps[i] - (gssize)size) <
+                            ABS((gssize)steps[best] - (gssize)size))
+                best = i;
+        }
+
+        sz = memlat_size_str(size);
+        if (best >= 0) {
+            used[best] = TRUE;
+            bench_value_append_extra(r, "L%d %s %0.1f ns", level, sz,
+                                     memlat_at(r->curve, size));
+        } else {
+            mismatches++;
+            bench_value_append_extra(r, "L%d %s no step", level, sz);
+            bench_msg("cpu%d L%d cache is %s in sysfs, but the latency shows "
+                      "no step near it", cpu, level, sz);
+        }
+        g_free(sz);
+    }
+    cpucache_list_free(caches);
+
+    str = g_string_new(n_steps ? NULL : "none");
+    for (i = 0; i < n_steps; i++) {
+        sz = memlat_size_str(steps[i]);
+        g_string_append_printf(str, "%s%s", i ? " " : "", sz);
+        g_free(sz);
+    }
+    bench_value_append_extra(r, "steps at %s", str->str);
+    g_string_free(str, TRUE);
+    if (mismatches)
+        bench_value_append_extra(r, "sysfs mismatch");
+}
+
+void benchmark_memory_latency(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    MemLatData md;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running memory latency benchmark...");
+
+    memset(&md, 0, sizeof(md));
+    md.max_bytes = memlat_max_bytes();
+    md.order = g_try_new(guint32, md.max_bytes / BENCH_CHASE_LINE);
+    md.buf = bench_huge_alloc(md.max_bytes);
+    if (!md.order || !md.buf) {
+        bench_msg("unable to allocate %" G_GSIZE_FORMAT " MiB",
+                  md.max_bytes >> 20);
+        g_free(md.order);
+        free(md.buf);
+        bench_results[BENCHMARK_MEMORY_LATENCY] = r;
+        return;
+    }
+
+    r = benchmark_parallel(1, memlat_sweep, &md);
+    if (md.curve.n) {
+        r.curve = g_new(bench_curve, 1);
+        *r.curve = md.curve;
+    }
+    r.result = md.curve.n ? md.curve.point[md.curve.n - 1].result : -1;
+    r.revision = BENCH_REVISION;
+    if (md.curve.n) {
+        gchar *sz = memlat_size_str(md.curve.point[md.curve.n - 1].bytes);
+        memlat_check_caches(&r, md.cpu);
+        bench_value_append_extra(&r, "up to %s", sz);
+        g_free(sz);
+    }
+
+    free(md.buf);
+    g_free(md.order);
+
+    bench_results[BENCHMARK_MEMORY_LATENCY] = r;
+}
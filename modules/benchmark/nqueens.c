@@ -66,3 +66,133 @@ benchmark_nqueens(void)
 }
 
 
+/* The same problem on a larger board, NQ_STEAL_N queens, with all the
+ * threads on one board: a bitboard search whose first NQ_STEAL_SPLIT
+ * rows are tasks for the work-stealing scheduler, so the subtrees,
+ * which differ a lot in size, spread over the workers as they go.
+ * The result is in solutions/s; the load balance is the mean over the
+ * largest of the nodes each worker searched. */
+
+#define NQ_STEAL_N 15
+#define NQ_STEAL_SOLUTIONS 2279184
+#define NQ_STEAL_SPLIT 3
+#define NQ_STEAL_TIME 5
+
+typedef struct {
+    guint32 cols, d1, d2;
+    gint row;
+    guint64 solutions;
+} NqTask;
+
+typedef struct {
+    guint64 nodes;
+    gchar pad[64 - sizeof(guint64)];
+} NqWorker;
+
+static NqWorker *nq_workers;
+
+static guint64 nq_count(guint32 cols, guint32 d1, guint32 d2, guint64 *nodes)
+{
+    const guint32 mask = (1U << NQ_STEAL_N) - 1;
+    guint32 avail = mask & ~(cols | d1 | d2), bit;
+    guint64 n = 0;
+
+    if (cols == mask)
+        return 1;
+    while (avail) {
+        bit = avail & -avail;
+        avail ^= bit;
+        (*nodes)++;
+        n += nq_count(cols | bit, (d1 | bit) << 1, (d2 | bit) >> 1, nodes);
+    }
+    return n;
+}
+
+static void nq_task(BenchSteal *s, gint worker, gpointer arg)
+{
+    const guint32 mask = (1U << NQ_STEAL_N) - 1;
+    NqTask *t = arg, child[NQ_STEAL_N];
+    guint32 avail, bit;
+    guint64 nodes = 0;
+    gint join = 0, n = 0, i;
+
+    if (t->row >= NQ_STEAL_SPLIT) {
+        t->solutions = nq_count(t->cols, t->d1, t->d2, &nodes);
+        nq_workers[worker].nodes += nodes;
+        return;
+    }
+
+    avail = mask & ~(t->cols | t->d1 | t->d2);
+    while (avail) {
+        bit = avail & -avail;
+        avail ^= bit;
+        child[n].cols = t->cols | bit;
+        child[n].d1 = (t->d1 | bit) << 1;
+        child[n].d2 = (t->d2 | bit) >> 1;
+        child[n].row = t->row + 1;
+        child[n].solutions = 0;
+        bench_steal_spawn(s, worker, nq_task, &child[n], &join);
+        n++;
+    }
+    bench_steal_sync(s, worker, &join);
+
+    for (t->solutions = 0, i = 0; i < n; i++)
+        t->solutions += child[i].solutions;
+}
+
+static void nq_root(BenchSteal *s, gint worker, gpointer arg)
+{
+    NqTask root = { 0, 0, 0, 0, 0 };
+    gint *errors = arg;
+
+    nq_task(s, worker, &root);
+    if (root.solutions != NQ_STEAL_SOLUTIONS)
+        (*errors)++;
+}
+
+void
+benchmark_nqueens_steal(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    BenchStealWorker *counts;
+    guint64 max = 0, sum = 0, steals = 0, tasks = 0;
+    gint n_threads, errors = 0, i;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running N-Queens work-stealing benchmark...");
+
+    n_threads = benchmark_threads(0);
+    nq_workers = g_new0(NqWorker, n_threads);
+    counts = g_new0(BenchStealWorker, n_threads);
+
+    r = bench_steal_for(NQ_STEAL_TIME, n_threads, nq_root, &errors, counts);
+
+    for (i = 0; i < n_threads; i++) {
+        max = MAX(max, nq_workers[i].nodes);
+        sum += nq_workers[i].nodes;
+        steals += counts[i].steals;
+        tasks += counts[i].tasks;
+    }
+
+    if (r.elapsed_time > 0 && max) {
+        r.revision = BENCH_REVISION;
+        bench_value_append_extra(&r, "q:%d, %0.0f solves, load balance %0.1f%%, "
+                                 "%" G_GUINT64_FORMAT " tasks, %0.1f%% stolen",
+                                 NQ_STEAL_N, r.result,
+                                 100.0 * sum / n_threads / max, tasks,
+                                 tasks ? 100.0 * steals / tasks : 0);
+        if (errors)
+            bench_value_append_extra(&r, "%d wrong solution counts", errors);
+        r.result = r.result * NQ_STEAL_SOLUTIONS / r.elapsed_time;
+    } else {
+        r.result = -1;
+    }
+    if (errors)
+        bench_msg("%d solves did not find %d solutions", errors, NQ_STEAL_SOLUTIONS);
+
+    g_free(nq_workers);
+    nq_workers = NULL;
+    g_free(counts);
+
+    bench_results[BENCHMARK_NQUEENS_STEAL] = r;
+}
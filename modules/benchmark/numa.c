@@ -0,0 +1,316 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <errno.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+#include "cpubits.h"
+
+/* Bandwidth and latency between every pair of NUMA nodes.
+ *
+ * For each node B with memory, a buffer is bound to B with mbind() and
+ * first written by a worker pinned to B, so the pages are on B even
+ * where the binding isn't allowed; nodes without cpus need the binding.
+ * Then, for each node A with cpus, the pool is pinned to A:
+ *   bandwidth - one worker on every cpu of A reads its own slice of the
+ *               buffer for NUMA_READ_SECONDS; GB/s of all of them
+ *   latency   - one worker on A walks a random pointer chain through the
+ *               buffer, like the memory latency benchmark
+ *
+ * The matrix has a row for each cpu node and a column for each memory
+ * node. The result is the average bandwidth of all the pairs; the pool
+ * gets its --bench-pin placement back afterwards. */
+
+/* if anything changes in this block, increment revision */
+#define BENCH_REVISION 1
+#define NUMA_MIN_BYTES (256 << 20)
+#define NUMA_READ_SECONDS 0.5
+
+typedef struct {
+    gint id;
+    gint *cpus;
+    gint n_cpus;
+    gboolean has_memory;
+} NumaNode;
+
+typedef struct {
+    gchar *buf;
+    gsize bytes;
+    guint32 *order;
+    void **chain;
+    gint n_threads;
+    gint64 deadline;
+    double *gbs; /* per worker */
+    double ns;
+} NumaData;
+
+static volatile guint64 numa_sink;
+
+static cpubits *numa_bits(const gchar *path)
+{
+    gchar *tmp = NULL;
+    cpubits *bits = NULL;
+
+    if (g_file_get_contents(path, &tmp, NULL, NULL))
+        bits = cpubits_from_str(g_strstrip(tmp));
+    g_free(tmp);
+    return bits;
+}
+
+static gint *numa_bits_list(cpubits *bits, gint *n)
+{
+    gint *list, i, max;
+
+    *n = 0;
+    if (!bits)
+        return NULL;
+    max = cpubits_max(bits);
+    list = g_new0(gint, cpubits_count(bits) + 1);
+    for (i = 0; i <= max; i++) {
+        if (CPUBIT_GET(bits, i))
+            list[(*n)++] = i;
+    }
+    return list;
+}
+
+/* online nodes; without NUMA in the kernel, one node 0 with every cpu */
+static NumaNode *numa_nodes(gint *n_nodes)
+{
+    cpubits *online, *memory, *cpus;
+    NumaNode *nodes;
+    gint *ids, n, i;
+    gchar *path;
+
+    online = numa_bits("/sys/devices/system/node/online");
+    ids = numa_bits_list(online, &n);
+    if (!n) {
+        g_free(ids);
+        free(online);
+        nodes = g_new0(NumaNode, 1);
+        cpus = numa_bits("/sys/devices/system/cpu/online");
+        nodes[0].cpus = numa_bits_list(cpus, &nodes[0].n_cpus);
+        nodes[0].has_memory = TRUE;
+        free(cpus);
+        *n_nodes = 1;
+        return nodes;
+    }
+
+    memory = numa_bits("/sys/devices/system/node/has_memory");
+    nodes = g_new0(NumaNode, n);
+    for (i = 0; i < n; i++) {
+        nodes[i].id = ids[i];
+        path = g_strdup_printf("/sys/devices/system/node/node%d/cpulist", ids[i]);
+        cpus = numa_bits(path);
+        nodes[i].cpus = numa_bits_list(cpus, &nodes[i].n_cpus);
+        free(cpus);
+        g_free(path);
+        nodes[i].has_memory = memory ? CPUBIT_GET(memory, ids[i]) != 0 : TRUE;
+    }
+    g_free(ids);
+    free(online);
+    free(memory);
+
+    *n_nodes = n;
+    return nodes;
+}
+
+static gboolean numa_bind(gchar *buf, gsize bytes, gint node)
+{
+#ifdef __NR_mbind
+    unsigned long mask[1024 / (8 * sizeof(unsigned long))] = { 0 };
+
+    if (node >= 1024)
+        return FALSE;
+    mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+    if (syscall(__NR_mbind, buf, bytes, MPOL_BIND, mask, 1024, 0) == 0)
+        return TRUE;
+    DEBUG("mbind to node %d: %s", node, g_strerror(errno));
+#endif
+    return FALSE;
+}
+
+/* one call, from a worker on the memory node */
+static gpointer numa_touch(unsigned int start, unsigned int end, void *data,
+                           gint thread_number)
+{
+    NumaData *nd = data;
+    guint64 seed = 0x9e3779b97f4a7c15ULL;
+
+    memset(nd->buf, 0, nd->bytes);
+    nd->chain = bench_chase_chain(nd->buf, nd->bytes, nd->order, &seed);
+    return NULL;
+}
+
+/* one call for each worker on the cpu node */
+static gpointer numa_read(unsigned int start, unsigned int end, void *data,
+                          gint thread_number)
+{
+    NumaData *nd = data;
+    gsize n = nd->bytes / sizeof(guint64) / nd->n_threads, i;
+    const guint64 *p = (const guint64 *)nd->buf + n * thread_number;
+    guint64 s0 = 0, s1 = 0, s2 = 0, s3 = 0, bytes = 0, t0, t1;
+
+    n -= n % 4;
+    t0 = bench_hist_now_ns();
+    do {
+        for (i = 0; i < n; i += 4) {
+            s0 += p[i];
+            s1 += p[i + 1];
+            s2 += p[i + 2];
+            s3 += p[i + 3];
+        }
+        bytes += n * sizeof(guint64);
+    } while (g_get_monotonic_time() < nd->deadline);
+    t1 = bench_hist_now_ns();
+
+    numa_sink = s0 + s1 + s2 + s3;
+    /* bytes/ns is GB/s */
+    nd->gbs[thread_number] = (double)bytes / (t1 - t0);
+    return NULL;
+}
+
+/* one call, from a worker on the cpu node */
+static gpointer numa_chase(unsigned int start, unsigned int end, void *data,
+                           gint thread_number)
+{
+    NumaData *nd = data;
+
+    nd->ns = bench_chase_ns(nd->chain, nd->bytes / BENCH_CHASE_LINE);
+    return NULL;
+}
+
+/* buffer size for each memory node */
+static gsize numa_bytes(gint n_nodes)
+{
+    gsize bytes = MAX(4 * bench_llc_bytes(), NUMA_MIN_BYTES);
+    gsize ram = (gsize)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+
+    if (ram && bytes > ram / 4 / n_nodes)
+        bytes = ram / 4 / n_nodes;
+    return bytes - bytes % (2 << 20);
+}
+
+/* measures cpu node a against the buffer */
+static void numa_pair(NumaData *nd, const NumaNode *a, double *gbs, double *ns)
+{
+    gint t;
+
+    bench_pool_set_affinity(a->cpus, a->n_cpus);
+
+    nd->n_threads = a->n_cpus;
+    nd->gbs = g_new0(double, a->n_cpus);
+    nd->deadline = g_get_monotonic_time() + NUMA_READ_SECONDS * G_USEC_PER_SEC;
+    benchmark_parallel(a->n_cpus, numa_read, nd);
+    for (*gbs = 0, t = 0; t < a->n_cpus; t++)
+        *gbs += nd->gbs[t];
+    g_free(nd->gbs);
+
+    benchmark_parallel(1, numa_chase, nd);
+    *ns = nd->ns;
+}
+
+void benchmark_numa(void)
+{
+    const bench_placement *pl = bench_placement_get();
+    bench_value r = EMPTY_BENCH_VALUE;
+    NumaNode *nodes;
+    NumaData nd;
+    gint n_nodes, a, b, threads = 0;
+    double sum = 0, local_gbs = 0, local_ns = 0, remote_gbs = 0, remote_ns = 0;
+    gint n_sum = 0, n_local = 0, n_remote = 0;
+    bench_matrix *m;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running NUMA benchmark...");
+
+    nodes = numa_nodes(&n_nodes);
+    m = r.matrix = bench_matrix_new(n_nodes, FALSE);
+    if (n_nodes > BENCH_MATRIX_MAX)
+        bench_msg("only the first %d of %d nodes are measured",
+                  BENCH_MATRIX_MAX, n_nodes);
+    for (a = 0; a < m->n; a++) {
+        m->id[a] = nodes[a].id;
+        threads = MAX(threads, nodes[a].n_cpus);
+    }
+
+    memset(&nd, 0, sizeof(nd));
+    nd.bytes = numa_bytes(m->n);
+    nd.order = g_try_new(guint32, nd.bytes / BENCH_CHASE_LINE);
+
+    for (b = 0; nd.order && b < m->n && !params.aborting_benchmarks; b++) {
+        if (!nodes[b].has_memory)
+            continue;
+        if (!(nd.buf = bench_huge_alloc(nd.bytes))) {
+            bench_msg("unable to allocate %" G_GSIZE_FORMAT " MiB",
+                      nd.bytes >> 20);
+            break;
+        }
+        if (!numa_bind(nd.buf, nd.bytes, nodes[b].id) && !nodes[b].n_cpus) {
+            /* a node without cpus has nowhere to first touch it from */
+            free(nd.buf);
+            continue;
+        }
+        bench_pool_set_affinity(nodes[b].cpus, nodes[b].n_cpus);
+        benchmark_parallel(1, numa_touch, &nd);
+
+        for (a = 0; a < m->n && !params.aborting_benchmarks; a++) {
+            if (!nodes[a].n_cpus)
+                continue;
+            numa_pair(&nd, &nodes[a], &m->gbs[a][b], &m->ns[a][b]);
+            sum += m->gbs[a][b];
+            n_sum++;
+            if (a == b) {
+                local_gbs += m->gbs[a][b];
+                local_ns += m->ns[a][b];
+                n_local++;
+            } else {
+                remote_gbs += m->gbs[a][b];
+                remote_ns += m->ns[a][b];
+                n_remote++;
+            }
+        }
+        free(nd.buf);
+    }
+    bench_pool_set_affinity(pl->cpus, pl->n_cpus);
+
+    if (n_sum) {
+        r.result = sum / n_sum;
+        r.threads_used = threads;
+        r.revision = BENCH_REVISION;
+        if (n_local)
+            bench_value_append_extra(&r, "local %0.1f GB/s %0.0f ns",
+                                     local_gbs / n_local, local_ns / n_local);
+        if (n_remote)
+            bench_value_append_extra(&r, "remote %0.1f GB/s %0.0f ns",
+                                     remote_gbs / n_remote, remote_ns / n_remote);
+        bench_value_append_extra(&r, "%d nodes, %" G_GSIZE_FORMAT " MiB per node",
+                                 m->n, nd.bytes >> 20);
+    } else {
+        bench_value_free(&r);
+    }
+
+    for (a = 0; a < n_nodes; a++)
+        g_free(nodes[a].cpus);
+    g_free(nodes);
+    g_free(nd.order);
+
+    bench_results[BENCHMARK_NUMA] = r;
+}
@@ -0,0 +1,556 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/statvfs.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#ifdef __NR_io_uring_setup
+#include <linux/io_uring.h>
+#endif
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* Storage I/O in a temporary file in --bench-dir (the temp directory by
+ * default). The file is unlinked as soon as it is open, so nothing is
+ * left behind whatever happens to the run, and it takes at most a
+ * quarter of the free space.
+ *
+ *   sequential - 1 MiB writes, then reads, STORAGE_SEQ_QD at a time,
+ *                once through the file or for STORAGE_SEQ_SECONDS;
+ *                the write also fills the file for the random phases
+ *   random     - 4 KiB reads, then writes, at random aligned offsets,
+ *                STORAGE_RAND_SECONDS at each queue depth
+ *
+ * The file is opened with O_DIRECT so the page cache stays out of the
+ * way; where the filesystem refuses that, it is opened buffered with
+ * O_DSYNC writes and the cache dropped before reading, which is noted.
+ * The queue is kept full with io_uring where the kernel allows it, or
+ * with one thread per queue slot doing pread()/pwrite().
+ *
+ * The result is random read IOPS at the deepest queue; the latency
+ * percentiles are of the random reads at queue depth 1. */
+
+/* if anything changes in this block, increment revision */
+#define BENCH_REVISION 1
+#define STORAGE_MAX_BYTES (1 << 30)
+#define STORAGE_MIN_BYTES (16 << 20)
+#define STORAGE_SEQ_BLOCK (1 << 20)
+#define STORAGE_SEQ_QD 8
+#define STORAGE_SEQ_SECONDS 5
+#define STORAGE_RAND_BLOCK 4096
+#define STORAGE_RAND_SECONDS 2
+
+static const gint storage_qd[] = { 1, 4, 16, 64 };
+#define STORAGE_N_QD ((gint)G_N_ELEMENTS(storage_qd))
+
+typedef struct {
+    gint fd_read, fd_write;
+    gboolean direct;
+    gboolean uring; /* still worth trying */
+    gsize bytes;    /* written by the sequential phase */
+
+    /* the phase that is running */
+    gboolean write;
+    gboolean random;
+    gsize block;
+    gint qd;
+    guint64 deadline; /* bench_hist_now_ns() */
+    gsize next;       /* sequential offset */
+    GMutex lock;      /* next, for the threads */
+    gint error;       /* errno of the first failed I/O */
+} StorageData;
+
+typedef struct {
+    StorageData *sd;
+    gchar *buf;
+    guint64 seed;
+    guint64 ios;
+    bench_hist hist;
+} StorageWorker;
+
+static guint64 xorshift64(guint64 *s)
+{
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+/* offset of the next I/O, or -1 when a sequential phase is done */
+static gint64 storage_offset(StorageData *sd, guint64 *seed)
+{
+    gint64 off = -1;
+
+    if (sd->random)
+        return (gint64)(xorshift64(seed) % (sd->bytes / sd->block)) * sd->block;
+
+    g_mutex_lock(&sd->lock);
+    if (sd->next + sd->block <= sd->bytes) {
+        off = sd->next;
+        sd->next += sd->block;
+    }
+    g_mutex_unlock(&sd->lock);
+    return off;
+}
+
+static gchar *storage_buf(gsize bytes)
+{
+    void *buf = NULL;
+
+    if (posix_memalign(&buf, 4096, bytes))
+        return NULL;
+    /* not zeros, in case the filesystem or the drive compresses */
+    memset(buf, 0xa5, bytes);
+    return buf;
+}
+
+static gpointer storage_thread(gpointer data)
+{
+    StorageWorker *w = data;
+    StorageData *sd = w->sd;
+    gint64 off;
+    guint64 t0;
+    ssize_t n;
+
+    while (!sd->error && bench_hist_now_ns() < sd->deadline &&
+           (off = storage_offset(sd, &w->seed)) >= 0) {
+        t0 = bench_hist_now_ns();
+        if (sd->write)
+            n = pwrite(sd->fd_write, w->buf, sd->block, off);
+        else
+            n = pread(sd->fd_read, w->buf, sd->block, off);
+        if (n != (ssize_t)sd->block) {
+            sd->error = n < 0 ? errno : EIO;
+            break;
+        }
+        bench_hist_add(&w->hist, bench_hist_now_ns() - t0);
+        w->ios++;
+    }
+    return NULL;
+}
+
+/* one synchronous thread per queue slot */
+static void storage_run_threads(StorageData *sd, StorageWorker *w)
+{
+    GThread **threads = g_new0(GThread *, sd->qd);
+    gint i;
+
+    for (i = 0; i < sd->qd; i++)
+        threads[i] = g_thread_new("storage", storage_thread, &w[i]);
+    for (i = 0; i < sd->qd; i++)
+        g_thread_join(threads[i]);
+    g_free(threads);
+}
+
+#ifdef __NR_io_uring_setup
+typedef struct {
+    gint fd;
+    gsize sq_bytes, cq_bytes, sqe_bytes;
+    gchar *sq, *cq;
+    struct io_uring_sqe *sqes;
+    unsigned *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_cqe *cqes;
+} StorageRing;
+
+static gboolean storage_ring_init(StorageRing *ring, gint entries)
+{
+    struct io_uring_params p;
+
+    memset(ring, 0, sizeof(StorageRing));
+    memset(&p, 0, sizeof(p));
+    ring->fd = syscall(__NR_io_uring_setup, entries, &p);
+    if (ring->fd < 0) {
+        DEBUG("io_uring_setup: %s", g_strerror(errno));
+        return FALSE;
+    }
+
+    ring->sq_bytes = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring->cq_bytes = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqe_bytes = p.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sq = mmap(NULL, ring->sq_bytes, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    ring->cq = mmap(NULL, ring->cq_bytes, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    ring->sqes = mmap(NULL, ring->sqe_bytes, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sq == MAP_FAILED || ring->cq == MAP_FAILED ||
+        ring->sqes == MAP_FAILED) {
+        DEBUG("io_uring mmap: %s", g_strerror(errno));
+        if (ring->sq != MAP_FAILED)
+            munmap(ring->sq, ring->sq_bytes);
+        if (ring->cq != MAP_FAILED)
+            munmap(ring->cq, ring->cq_bytes);
+        if (ring->sqes != MAP_FAILED)
+            munmap(ring->sqes, ring->sqe_bytes);
+        close(ring->fd);
+        return FALSE;
+    }
+
+    ring->sq_tail = (unsigned *)(ring->sq + p.sq_off.tail);
+    ring->sq_mask = (unsigned *)(ring->sq + p.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)(ring->sq + p.sq_off.array);
+    ring->cq_head = (unsigned *)(ring->cq + p.cq_off.head);
+    ring->cq_tail = (unsigned *)(ring->cq + p.cq_off.tail);
+    ring->cq_mask = (unsigned *)(ring->cq + p.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(ring->cq + p.cq_off.cqes);
+    return TRUE;
+}
+
+static void storage_ring_free(StorageRing *ring)
+{
+    munmap(ring->sq, ring->sq_bytes);
+    munmap(ring->cq, ring->cq_bytes);
+    munmap(ring->sqes, ring->sqe_bytes);
+    close(ring->fd);
+}
+
+/* queues one readv/writev (kernel 5.1) of slot's buffer; submitted by
+ * the next io_uring_enter() */
+static void storage_ring_queue(StorageRing *ring, StorageData *sd,
+                               struct iovec *iov, gint slot, gint64 off)
+{
+    unsigned tail = *ring->sq_tail, idx = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[idx];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = sd->write ? IORING_OP_WRITEV : IORING_OP_READV;
+    sqe->fd = sd->write ? sd->fd_write : sd->fd_read;
+    sqe->addr = (guint64)(gsize)&iov[slot];
+    sqe->len = 1;
+    sqe->off = off;
+    sqe->user_data = slot;
+    ring->sq_array[idx] = idx;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+/* an io_uring that can be set up may still not take readv/writev on
+ * this file, or at all: that shows as EINVAL or EOPNOTSUPP */
+#define STORAGE_URING_REFUSED(e) ((e) == EINVAL || (e) == EOPNOTSUPP)
+
+/* qd I/Os in flight from one thread; FALSE if the ring can't be used,
+ * which is also when its first I/Os are refused */
+static gboolean storage_run_uring(StorageData *sd, StorageWorker *w)
+{
+    StorageRing ring;
+    struct iovec *iov;
+    guint64 *started, now, completed = 0;
+    gint64 off;
+    unsigned head, slot;
+    gint i, in_flight = 0, queued = 0, ret;
+    gboolean refused = FALSE;
+    struct io_uring_cqe *cqe;
+
+    if (!storage_ring_init(&ring, sd->qd))
+        return FALSE;
+
+    iov = g_new0(struct iovec, sd->qd);
+    started = g_new0(guint64, sd->qd);
+    for (i = 0; i < sd->qd; i++) {
+        iov[i].iov_base = w[i].buf;
+        iov[i].iov_len = sd->block;
+        if ((off = storage_offset(sd, &w[0].seed)) < 0)
+            break;
+        started[i] = bench_hist_now_ns();
+        storage_ring_queue(&ring, sd, iov, i, off);
+        queued++;
+    }
+
+    while (queued || in_flight) {
+        ret = syscall(__NR_io_uring_enter, ring.fd, queued, 1,
+                      IORING_ENTER_GETEVENTS, NULL, 0);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            if (!completed && STORAGE_URING_REFUSED(errno))
+                refused = TRUE;
+            else
+                sd->error = errno;
+            break;
+        }
+        in_flight += ret;
+        queued -= ret;
+
+        head = *ring.cq_head;
+        while (head != __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE)) {
+            cqe = &ring.cqes[head & *ring.cq_mask];
+            slot = cqe->user_data;
+            now = bench_hist_now_ns();
+            head++;
+            in_flight--;
+
+            if (cqe->res != (gint)sd->block) {
+                if (!completed && STORAGE_URING_REFUSED(-cqe->res))
+                    refused = TRUE;
+                else if (!sd->error)
+                    sd->error = cqe->res < 0 ? -cqe->res : EIO;
+                continue;
+            }
+            bench_hist_add(&w[slot].hist, now - started[slot]);
+            w[slot].ios++;
+            completed++;
+
+            if (!sd->error && !refused && now < sd->deadline &&
+                (off = storage_offset(sd, &w[0].seed)) >= 0) {
+                started[slot] = bench_hist_now_ns();
+                storage_ring_queue(&ring, sd, iov, slot, off);
+                queued++;
+            }
+        }
+        __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    g_free(iov);
+    g_free(started);
+    storage_ring_free(&ring);
+    if (refused && completed) {
+        /* not a refusal after all, the I/Os that failed just failed */
+        refused = FALSE;
+        if (!sd->error)
+            sd->error = EINVAL;
+    }
+    if (refused)
+        DEBUG("io_uring %s refused, using threads", sd->write ? "writev" : "readv");
+    return !refused;
+}
+#endif
+
+/* one phase; returns the I/Os done and their latencies in hist */
+static guint64 storage_phase(StorageData *sd, gboolean write, gboolean random,
+                             gint qd, double seconds, bench_hist *hist,
+                             double *elapsed)
+{
+    StorageWorker *w = g_new0(StorageWorker, qd);
+    guint64 ios = 0, t0;
+    gboolean done = FALSE;
+    gint i;
+
+    sd->write = write;
+    sd->random = random;
+    sd->block = random ? STORAGE_RAND_BLOCK : STORAGE_SEQ_BLOCK;
+    sd->qd = qd;
+    sd->next = 0;
+
+    for (i = 0; i < qd; i++) {
+        w[i].sd = sd;
+        w[i].seed = 0x9e3779b97f4a7c15ULL * (i + 1);
+        if (!(w[i].buf = storage_buf(sd->block)))
+            sd->error = ENOMEM;
+    }
+    if (!sd->direct && !write)
+        posix_fadvise(sd->fd_read, 0, 0, POSIX_FADV_DONTNEED);
+
+    t0 = bench_hist_now_ns();
+    sd->deadline = t0 + (guint64)(seconds * 1e9);
+    if (!sd->error) {
+#ifdef __NR_io_uring_setup
+        if (sd->uring)
+            done = storage_run_uring(sd, w);
+        sd->uring = done;
+#endif
+        if (!done)
+            storage_run_threads(sd, w);
+    }
+    if (write && !sd->error && fdatasync(sd->fd_write))
+        sd->error = errno;
+    *elapsed = (bench_hist_now_ns() - t0) / 1e9;
+
+    for (i = 0; i < qd; i++) {
+        ios += w[i].ios;
+        if (hist)
+            bench_hist_merge(hist, &w[i].hist);
+        free(w[i].buf);
+    }
+    g_free(w);
+
+    return ios;
+}
+
+/* opens a new file in dir twice, for reading and for writing, and
+ * unlinks it */
+static gboolean storage_open(StorageData *sd, const gchar *dir)
+{
+    gchar *path = g_build_filename(dir, "hardinfo2-storage-XXXXXX", NULL);
+    gint fd;
+
+    if ((fd = g_mkstemp(path)) < 0) {
+        bench_msg("unable to create a file in %s: %s", dir, g_strerror(errno));
+        g_free(path);
+        return FALSE;
+    }
+    close(fd);
+
+    sd->direct = TRUE;
+    sd->fd_read = open(path, O_RDONLY | O_DIRECT);
+    sd->fd_write = open(path, O_WRONLY | O_DIRECT);
+    if (sd->fd_read < 0 || sd->fd_write < 0) {
+        if (sd->fd_read >= 0)
+            close(sd->fd_read);
+        if (sd->fd_write >= 0)
+            close(sd->fd_write);
+        DEBUG("O_DIRECT in %s: %s", dir, g_strerror(errno));
+        sd->direct = FALSE;
+        sd->fd_read = open(path, O_RDONLY);
+        sd->fd_write = open(path, O_WRONLY | O_DSYNC);
+    }
+    unlink(path);
+    g_free(path);
+
+    if (sd->fd_read < 0 || sd->fd_write < 0) {
+        bench_msg("unable to open a file in %s: %s", dir, g_strerror(errno));
+        if (sd->fd_read >= 0)
+            close(sd->fd_read);
+        if (sd->fd_write >= 0)
+            close(sd->fd_write);
+        return FALSE;
+    }
+    if (!sd->direct)
+        posix_fadvise(sd->fd_read, 0, 0, POSIX_FADV_RANDOM);
+    return TRUE;
+}
+
+/* a quarter of the free space, at most STORAGE_MAX_BYTES */
+static gsize storage_bytes(const gchar *dir)
+{
+    struct statvfs st;
+    gsize bytes = STORAGE_MAX_BYTES, avail;
+
+    if (statvfs(dir, &st) == 0) {
+        avail = (gsize)st.f_bavail * st.f_frsize;
+        if (bytes > avail / 4)
+            bytes = avail / 4;
+    }
+    return bytes - bytes % STORAGE_SEQ_BLOCK;
+}
+
+static gchar *storage_kiops(double iops)
+{
+    if (iops >= 1000)
+        return g_strdup_printf("%0.1fk", iops / 1000);
+    return g_strdup_printf("%0.0f", iops);
+}
+
+void benchmark_storage(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    StorageData sd;
+    const gchar *dir = params.bench_dir ? params.bench_dir : g_get_tmp_dir();
+    double elapsed, seq[2] = { 0 }, iops[2][STORAGE_N_QD] = { { 0 } };
+    guint64 p99[STORAGE_N_QD] = { 0 };
+    bench_hist *hist, *qd1_hist;
+    GString *str[2];
+    gchar *tmp;
+    gint w, q;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running storage benchmark...");
+
+    memset(&sd, 0, sizeof(sd));
+    if (!g_file_test(dir, G_FILE_TEST_IS_DIR)) {
+        bench_msg("%s is not a directory", dir);
+        bench_results[BENCHMARK_STORAGE] = r;
+        return;
+    }
+    if ((sd.bytes = storage_bytes(dir)) < STORAGE_MIN_BYTES) {
+        bench_msg("not enough free space in %s", dir);
+        bench_results[BENCHMARK_STORAGE] = r;
+        return;
+    }
+    if (!storage_open(&sd, dir)) {
+        bench_results[BENCHMARK_STORAGE] = r;
+        return;
+    }
+    g_mutex_init(&sd.lock);
+#ifdef __NR_io_uring_setup
+    sd.uring = TRUE;
+#endif
+
+    /* the sequential write sets how much of the file the rest uses */
+    seq[1] = storage_phase(&sd, TRUE, FALSE, STORAGE_SEQ_QD,
+                           STORAGE_SEQ_SECONDS, NULL, &elapsed);
+    sd.bytes = (gsize)seq[1] * STORAGE_SEQ_BLOCK;
+    seq[1] = sd.bytes / elapsed / 1e6;
+    if (sd.bytes < STORAGE_MIN_BYTES && !sd.error)
+        sd.error = ENOSPC;
+
+    if (!sd.error) {
+        seq[0] = storage_phase(&sd, FALSE, FALSE, STORAGE_SEQ_QD,
+                               STORAGE_SEQ_SECONDS, NULL, &elapsed);
+        seq[0] = seq[0] * STORAGE_SEQ_BLOCK / elapsed / 1e6;
+    }
+
+    qd1_hist = g_new0(bench_hist, 1);
+    hist = g_new0(bench_hist, 1);
+    for (w = 0; w < 2; w++) {
+        for (q = 0; q < STORAGE_N_QD && !sd.error && !params.aborting_benchmarks; q++) {
+            memset(hist, 0, sizeof(bench_hist));
+            iops[w][q] = storage_phase(&sd, w, TRUE, storage_qd[q],
+                                       STORAGE_RAND_SECONDS, hist, &elapsed);
+            iops[w][q] /= elapsed;
+            if (!w) {
+                p99[q] = bench_hist_percentile(hist, 0.99);
+                if (!q)
+                    *qd1_hist = *hist;
+            }
+        }
+    }
+
+    if (sd.error) {
+        bench_msg("I/O error in %s: %s", dir, g_strerror(sd.error));
+    } else if (!params.aborting_benchmarks) {
+        r.result = iops[0][STORAGE_N_QD - 1];
+        r.threads_used = sd.uring ? 1 : storage_qd[STORAGE_N_QD - 1];
+        r.revision = BENCH_REVISION;
+        bench_latency_from_hist(&r.latency, qd1_hist);
+
+        bench_value_append_extra(&r, "seq read %0.0f write %0.0f MB/s",
+                                 seq[0], seq[1]);
+        for (w = 0; w < 2; w++) {
+            str[w] = g_string_new(NULL);
+            for (q = 0; q < STORAGE_N_QD; q++) {
+                tmp = storage_kiops(iops[w][q]);
+                g_string_append_printf(str[w], "%s%s", q ? "/" : "", tmp);
+                g_free(tmp);
+            }
+        }
+        bench_value_append_extra(&r, "4K read %s write %s IOPS at QD 1/4/16/64",
+                                 str[0]->str, str[1]->str);
+        g_string_free(str[0], TRUE);
+        g_string_free(str[1], TRUE);
+        bench_value_append_extra(&r, "read p99 %0.0f/%0.0f/%0.0f/%0.0f us",
+                                 p99[0] / 1e3, p99[1] / 1e3, p99[2] / 1e3,
+                                 p99[3] / 1e3);
+        bench_value_append_extra(&r, "%s, %s, %" G_GSIZE_FORMAT " MiB",
+                                 sd.direct ? "O_DIRECT" : "buffered",
+                                 sd.uring ? "io_uring" : "threads",
+                                 sd.bytes >> 20);
+    }
+
+    g_free(hist);
+    g_free(qd1_hist);
+    g_mutex_clear(&sd.lock);
+    close(sd.fd_read);
+    close(sd.fd_write);
+
+    bench_results[BENCHMARK_STORAGE] = r;
+}
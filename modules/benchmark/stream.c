@@ -0,0 +1,212 @@
+/*
+ *    hardinfo2 - System Information and Benchmark
+ *    Copyright (C) 2026 hardinfo2 project
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2 or later.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* STREAM-style memory bandwidth: copy, scale, add and triad over
+ * arrays of doubles at least 4x the size of the last level cache.
+ *
+ * Every worker has its own three arrays, written first by the worker
+ * itself so the pages land on its NUMA node. A callback runs one
+ * kernel over one chunk; after the last chunk of the arrays the worker
+ * moves on to the next kernel, so each kernel streams the whole arrays
+ * through the cache. Bytes are counted as STREAM does: without the
+ * write-allocate reads. The result is in GB/s. */
+
+/* if anything changes in this block, increment revision */
+#define BENCH_REVISION 1
+#define CRUNCH_TIME 5
+#define STREAM_CHUNK 65536 /* elements per callback, 512 KiB */
+#define STREAM_MIN_BYTES (64 << 20) /* per array, all workers */
+#define STREAM_SCALAR 3.0
+
+enum {
+    STREAM_COPY,
+    STREAM_SCALE,
+    STREAM_ADD,
+    STREAM_TRIAD,
+    STREAM_N_KERNELS
+};
+
+static const struct {
+    const gchar *name;
+    gint bytes; /* per element */
+} stream_kernels[STREAM_N_KERNELS] = {
+    [STREAM_COPY] = { "copy", 2 * sizeof(double) },
+    [STREAM_SCALE] = { "scale", 2 * sizeof(double) },
+    [STREAM_ADD] = { "add", 3 * sizeof(double) },
+    [STREAM_TRIAD] = { "triad", 3 * sizeof(double) },
+};
+
+typedef struct {
+    double *a, *b, *c;
+    gsize pos; /* next chunk */
+    gint kernel;
+    guint64 bytes[STREAM_N_KERNELS];
+    guint64 ns[STREAM_N_KERNELS];
+} StreamWorker;
+
+typedef struct {
+    StreamWorker *w;
+    gsize n; /* elements per array, per worker */
+} StreamData;
+
+/* one call per worker, from the worker */
+static gpointer stream_init(unsigned int start, unsigned int end, void *data,
+                            gint thread_number)
+{
+    StreamData *sd = data;
+    StreamWorker *w;
+    unsigned int t;
+    gsize i;
+
+    for (t = start; t <= end; t++) {
+        w = &sd->w[t];
+        w->a = g_try_new(double, sd->n);
+        w->b = g_try_new(double, sd->n);
+        w->c = g_try_new(double, sd->n);
+        if (!w->a || !w->b || !w->c)
+            continue;
+        for (i = 0; i < sd->n; i++) {
+            w->a[i] = 1.0;
+            w->b[i] = 2.0;
+            w->c[i] = 0.0;
+        }
+    }
+    return NULL;
+}
+
+static gpointer stream_for(void *data, gint thread_number)
+{
+    StreamData *sd = data;
+    StreamWorker *w = &sd->w[thread_number];
+    double *a = w->a, *b = w->b, *c = w->c, s = STREAM_SCALAR;
+    gsize i, start = w->pos, end = MIN(w->pos + STREAM_CHUNK, sd->n);
+    guint64 t0 = bench_hist_now_ns();
+
+    switch (w->kernel) {
+    case STREAM_COPY:
+        for (i = start; i < end; i++)
+            c[i] = a[i];
+        break;
+    case STREAM_SCALE:
+        for (i = start; i < end; i++)
+            b[i] = s * c[i];
+        break;
+    case STREAM_ADD:
+        for (i = start; i < end; i++)
+            c[i] = a[i] + b[i];
+        break;
+    case STREAM_TRIAD:
+        for (i = start; i < end; i++)
+            a[i] = b[i] + s * c[i];
+        break;
+    }
+
+    w->ns[w->kernel] += bench_hist_now_ns() - t0;
+    w->bytes[w->kernel] += (end - start) * stream_kernels[w->kernel].bytes;
+    if (end < sd->n) {
+        w->pos = end;
+    } else {
+        w->pos = 0;
+        w->kernel = (w->kernel + 1) % STREAM_N_KERNELS;
+    }
+
+    return NULL;
+}
+
+/* elements per array for each of n_threads workers */
+static gsize stream_elements(gint n_threads)
+{
+    gsize total = MAX(4 * bench_llc_bytes(), STREAM_MIN_BYTES);
+    gsize ram = (gsize)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+    gsize n;
+
+    /* the three arrays in at most 3/8 of the memory */
+    if (ram && total > ram / 8)
+        total = ram / 8;
+    n = total / sizeof(double) / n_threads;
+    n -= n % STREAM_CHUNK;
+    return MAX(n, STREAM_CHUNK);
+}
+
+static void benchmark_stream_run(gint n_threads, gint entry)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    StreamData sd;
+    double gbs[STREAM_N_KERNELS] = { 0 };
+    gboolean ok = TRUE;
+    gint t, k;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running memory bandwidth benchmark...");
+
+    n_threads = benchmark_threads(n_threads);
+    sd.n = stream_elements(n_threads);
+    sd.w = g_new0(StreamWorker, n_threads);
+
+    benchmark_parallel(n_threads, stream_init, &sd);
+    for (t = 0; t < n_threads; t++)
+        ok = ok && sd.w[t].a && sd.w[t].b && sd.w[t].c;
+
+    if (ok) {
+        r = benchmark_crunch_for(CRUNCH_TIME, n_threads, stream_for, &sd);
+
+        /* callbacks per second to GB/s; over whole passes every kernel
+         * gets the same number of callbacks */
+        if (r.elapsed_time > 0)
+            r.result = r.result * STREAM_CHUNK *
+                       (2 + 2 + 3 + 3) * sizeof(double) / STREAM_N_KERNELS /
+                       r.elapsed_time / 1e9;
+        r.revision = BENCH_REVISION;
+
+        /* bytes/ns is GB/s */
+        for (t = 0; t < n_threads; t++) {
+            for (k = 0; k < STREAM_N_KERNELS; k++) {
+                if (sd.w[t].ns[k])
+                    gbs[k] += (double)sd.w[t].bytes[k] / sd.w[t].ns[k];
+            }
+        }
+        snprintf(r.extra, 255,
+                 "%s %0.1f, %s %0.1f, %s %0.1f, %s %0.1f GB/s, "
+                 "%" G_GSIZE_FORMAT " MiB x3 per thread",
+                 stream_kernels[STREAM_COPY].name, gbs[STREAM_COPY],
+                 stream_kernels[STREAM_SCALE].name, gbs[STREAM_SCALE],
+                 stream_kernels[STREAM_ADD].name, gbs[STREAM_ADD],
+                 stream_kernels[STREAM_TRIAD].name, gbs[STREAM_TRIAD],
+                 sd.n * sizeof(double) >> 20);
+    } else {
+        bench_msg("unable to allocate %d x 3 x %" G_GSIZE_FORMAT " MiB",
+                  n_threads, sd.n * sizeof(double) >> 20);
+    }
+
+    for (t = 0; t < n_threads; t++) {
+        g_free(sd.w[t].a);
+        g_free(sd.w[t].b);
+        g_free(sd.w[t].c);
+    }
+    g_free(sd.w);
+
+    bench_results[entry] = r;
+}
+
+void benchmark_stream_single(void) { benchmark_stream_run(1, BENCHMARK_STREAM_SINGLE); }
+void benchmark_stream_dual(void) { benchmark_stream_run(2, BENCHMARK_STREAM_DUAL); }
+void benchmark_stream_quad(void) { benchmark_stream_run(4, BENCHMARK_STREAM_QUAD); }
+void benchmark_stream_all(void) { benchmark_stream_run(0, BENCHMARK_STREAM_ALL); }
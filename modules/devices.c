@@ -268,6 +268,20 @@ gchar *get_processor_desc(void)
     return processor_describe(processors);
 }
 
+/* flags of the first processor, as in /proc/cpuinfo; "" where the
+ * platform has none */
+gchar *get_processor_flags(void)
+{
+#if defined(ARCH_x86) || defined(ARCH_arm) || defined(ARCH_riscv)
+    Processor *p;
+
+    scan_processors(FALSE);
+    if (processors && (p = processors->data) && p->flags)
+        return g_strdup(p->flags);
+#endif
+    return g_strdup("");
+}
+
 gchar *get_processor_name_and_desc(void)
 {
     scan_processors(FALSE);
@@ -556,6 +570,7 @@ const ShellModuleMethod *hi_exported_methods(void)
         {"getProcessorName", get_processor_name},
         {"getProcessorDesc", get_processor_desc},
         {"getProcessorNameAndDesc", get_processor_name_and_desc},
+        {"getProcessorFlags", get_processor_flags},
         {"getProcessorFrequency", get_processor_max_frequency},
         {"getProcessorFrequencyDesc", get_processor_frequency_desc},
         {"getStorageDevices", get_storage_devices},
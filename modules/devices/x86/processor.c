@@ -174,75 +174,7 @@ static gchar *__cache_get_info_as_string(Processor *processor)
 
 static void __cache_obtain_info(Processor *processor)
 {
-    ProcessorCache *cache;
-    gchar *endpoint, *entry, *index;
-    gchar *uref = NULL;
-    gint i;
-    gint processor_number = processor->id;
-
-    endpoint = g_strdup_printf("/sys/devices/system/cpu/cpu%d/cache", processor_number);
-
-    for (i = 0; ; i++) {
-      cache = g_new0(ProcessorCache, 1);
-
-      index = g_strdup_printf("index%d/", i);
-
-      entry = g_strconcat(index, "type", NULL);
-      cache->type = h_sysfs_read_string(endpoint, entry);
-      g_free(entry);
-
-      if (!cache->type) {
-        g_free(cache);
-        g_free(index);
-        goto fail;
-      }
-
-      entry = g_strconcat(index, "level", NULL);
-      cache->level = h_sysfs_read_int(endpoint, entry);
-      g_free(entry);
-
-      entry = g_strconcat(index, "number_of_sets", NULL);
-      cache->number_of_sets = h_sysfs_read_int(endpoint, entry);
-      g_free(entry);
-
-      entry = g_strconcat(index, "physical_line_partition", NULL);
-      cache->physical_line_partition = h_sysfs_read_int(endpoint, entry);
-      g_free(entry);
-
-      entry = g_strconcat(index, "size", NULL);
-      cache->size = h_sysfs_read_int(endpoint, entry);
-      g_free(entry);
-
-      entry = g_strconcat(index, "ways_of_associativity", NULL);
-      cache->ways_of_associativity = h_sysfs_read_int(endpoint, entry);
-      g_free(entry);
-
-      /* unique cache references: id is nice, but share_cpu_list can be
-       * used if it is not available. */
-      entry = g_strconcat(index, "id", NULL);
-      uref = h_sysfs_read_string(endpoint, entry);
-      g_free(entry);
-      if (uref != NULL && *uref != 0 )
-        cache->uid = atoi(uref);
-      else
-        cache->uid = -1;
-      g_free(uref);
-      entry = g_strconcat(index, "shared_cpu_list", NULL);
-      cache->shared_cpu_list = h_sysfs_read_string(endpoint, entry);
-      g_free(entry);
-
-      /* reacharound */
-      entry = g_strconcat(index, "../../topology/physical_package_id", NULL);
-      cache->phy_sock = h_sysfs_read_int(endpoint, entry);
-      g_free(entry);
-
-      g_free(index);
-
-      processor->cache = g_slist_append(processor->cache, cache);
-    }
-
-fail:
-    g_free(endpoint);
+    processor->cache = cpucache_list_new(processor->id);
 }
 
 #define khzint_to_mhzdouble(k) (((double)k)/1000)
@@ -732,7 +732,7 @@ report_create_inner_from_module_list(ReportContext * ctx, GSList * modules)
 
 	for (entries = module->entries; entries; entries = entries->next) {
 	    ShellModuleEntry *entry = (ShellModuleEntry *) entries->data;
-        if (entry->flags & MODULE_FLAG_HIDE) continue;
+        if (entry->flags & (MODULE_FLAG_HIDE | MODULE_FLAG_NO_REPORT)) continue;
 
 	    if (!params.gui_running && !params.quiet)
 		fprintf(stderr, "\033[2K\033[40;32;1m %s\033[0m\n",